@@ -733,6 +733,7 @@ set(WebCore_PRIVATE_FRAMEWORK_HEADERS
 
     inspector/agents/InspectorPageAgent.h
 
+    layout/LayoutContext.h
     layout/LayoutUnits.h
     layout/MarginTypes.h
 
@@ -1157,6 +1158,7 @@ set(WebCore_PRIVATE_FRAMEWORK_HEADERS
     platform/graphics/ComplexTextController.h
     platform/graphics/ConcreteImageBuffer.h
     platform/graphics/DashArray.h
+    platform/graphics/DecodedImageCache.h
     platform/graphics/DecodingOptions.h
     platform/graphics/DisplayRefreshMonitor.h
     platform/graphics/DisplayRefreshMonitorClient.h
@@ -1209,6 +1211,7 @@ set(WebCore_PRIVATE_FRAMEWORK_HEADERS
     platform/graphics/ImageBackingStore.h
     platform/graphics/ImageBuffer.h
     platform/graphics/ImageBufferBackend.h
+    platform/graphics/ImageDecodingPool.h
     platform/graphics/ImageFrame.h
     platform/graphics/ImageObserver.h
     platform/graphics/ImageOrientation.h
@@ -1290,6 +1293,7 @@ set(WebCore_PRIVATE_FRAMEWORK_HEADERS
     platform/graphics/displaylists/DisplayListItems.h
     platform/graphics/displaylists/DisplayListRecorder.h
     platform/graphics/displaylists/DisplayListReplayer.h
+    platform/graphics/displaylists/DisplayListWireFormat.h
 
     platform/graphics/cv/ImageTransferSessionVT.h
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "config.h"
+#include "LayoutContext.h"
+
+#if ENABLE(LAYOUT_FORMATTING_CONTEXT)
+
+#include "InvalidationState.h"
+#include "LayoutBox.h"
+#include "LayoutBoxGeometry.h"
+#include "LayoutContainerBox.h"
+#include "LayoutDescendantIterator.h"
+#include "LayoutState.h"
+#include "LayoutTreeBuilder.h"
+#include "RenderView.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/text/TextStream.h>
+
+namespace WebCore {
+namespace Layout {
+
+enum class FormattingContextType : uint8_t { Block, Inline, Table, Flex };
+static constexpr size_t formattingContextTypeCount = 4;
+
+static FormattingContextType formattingContextType(const ContainerBox& formattingContextRoot)
+{
+    // Match the order of LayoutContext::createFormattingContext().
+    if (formattingContextRoot.establishesInlineFormattingContext())
+        return FormattingContextType::Inline;
+    if (formattingContextRoot.establishesBlockFormattingContext())
+        return FormattingContextType::Block;
+    if (formattingContextRoot.establishesFlexFormattingContext())
+        return FormattingContextType::Flex;
+    ASSERT(formattingContextRoot.establishesTableFormattingContext());
+    return FormattingContextType::Table;
+}
+
+static const char* formattingContextTypeName(FormattingContextType type)
+{
+    switch (type) {
+    case FormattingContextType::Block:
+        return "block";
+    case FormattingContextType::Inline:
+        return "inline";
+    case FormattingContextType::Table:
+        return "table";
+    case FormattingContextType::Flex:
+        return "flex";
+    }
+    ASSERT_NOT_REACHED();
+    return "";
+}
+
+struct FormattingContextTypeCount {
+    unsigned rootCount { 0 };
+    unsigned boxCount { 0 };
+};
+
+String LayoutContext::runLayoutBenchmark(const RenderView& renderView, unsigned iterations)
+{
+    iterations = std::max(iterations, 1u);
+    // Note that the layout tree is built once, outside of the measured loop, since we are only interested in layout throughput here.
+    auto layoutTree = TreeBuilder::buildLayoutTree(renderView);
+    auto& layoutRoot = layoutTree->root();
+
+    unsigned totalBoxCount = 0;
+    FormattingContextTypeCount formattingContextTypeCounts[formattingContextTypeCount];
+    for (auto& layoutBox : descendantsOfType<Box>(layoutRoot)) {
+        ++totalBoxCount;
+        if (!is<ContainerBox>(layoutBox) || !layoutBox.establishesFormattingContext())
+            continue;
+        auto& containerBox = downcast<ContainerBox>(layoutBox);
+        if (!containerBox.hasChild())
+            continue;
+        auto& count = formattingContextTypeCounts[static_cast<size_t>(formattingContextType(containerBox))];
+        ++count.rootCount;
+        for (auto& descendant : descendantsOfType<Box>(containerBox)) {
+            UNUSED_PARAM(descendant);
+            ++count.boxCount;
+        }
+    }
+
+    Seconds layoutTime;
+    size_t boxGeometryCount = 0;
+    size_t formattingStateCount = 0;
+    for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+        // Every iteration lays out into fresh states. Laying out again into a state that already has geometry
+        // would, for instance, append the floats to their floating state a second time.
+        auto layoutState = LayoutState { renderView.document(), layoutRoot };
+        auto layoutContext = LayoutContext { layoutState };
+        auto invalidationState = InvalidationState { };
+
+        auto startTime = MonotonicTime::now();
+        layoutContext.layout(renderView.size(), invalidationState);
+        layoutTime += MonotonicTime::now() - startTime;
+
+        boxGeometryCount = layoutState.boxGeometryCount();
+        formattingStateCount = layoutState.formattingStateCount();
+    }
+
+    // Formatting contexts nest, so only the full layout is timed. The per type counts show what the layout consists of.
+    auto timePerIteration = layoutTime / iterations;
+    TextStream stream;
+    stream << "LFC layout benchmark: " << iterations << " iterations, " << boxGeometryCount << " box geometries and " << formattingStateCount << " formatting states allocated per layout\n";
+    stream << "full layout: " << totalBoxCount << " boxes, " << timePerIteration.milliseconds() << "ms/iteration";
+    if (totalBoxCount)
+        stream << ", " << (timePerIteration / totalBoxCount).microseconds() << "us/box";
+    stream << "\n";
+    for (size_t type = 0; type < formattingContextTypeCount; ++type) {
+        auto& count = formattingContextTypeCounts[type];
+        if (count.rootCount)
+            stream << formattingContextTypeName(static_cast<FormattingContextType>(type)) << ": " << count.rootCount << " roots, " << count.boxCount << " boxes\n";
+    }
+    return stream.release();
+}
+
+}
+}
+
+#endif
@@ -53,6 +53,7 @@ public:
     void clearIntrinsicWidthConstraints(const Box&);
 
     void setIntrinsicWidthConstraints(FormattingContext::IntrinsicWidthConstraints intrinsicWidthConstraints) { m_intrinsicWidthConstraints = intrinsicWidthConstraints; }
+    void clearIntrinsicWidthConstraints() { m_intrinsicWidthConstraints = { }; }
     Optional<FormattingContext::IntrinsicWidthConstraints> intrinsicWidthConstraints() const { return m_intrinsicWidthConstraints; }
 
     bool isBlockFormattingState() const { return m_type == Type::Block; }
@@ -29,6 +29,7 @@
 
 #include <wtf/IsoMalloc.h>
 #include <wtf/OptionSet.h>
+#include <wtf/text/WTFString.h>
 
 namespace WebCore {
 
@@ -64,6 +65,10 @@ public:
     static void verifyAndOutputMismatchingLayoutTree(const LayoutState&, const RenderView&);
 #endif
 
+    // For performance testing purposes only. Runs layout on the render view's layout tree |iterations| times
+    // and reports the time spent, along with the number of formatting contexts of each type.
+    static String runLayoutBenchmark(const RenderView&, unsigned iterations);
+
 private:
     void layoutFormattingContextSubtree(const ContainerBox&, InvalidationState&);
     LayoutState& layoutState() { return m_layoutState; }
@@ -70,6 +70,7 @@ BoxGeometry& LayoutState::geometryForRootBox()
 
 BoxGeometry& LayoutState::ensureGeometryForBoxSlow(const Box& layoutBox)
 {
+    ++m_boxGeometryCount;
     if (layoutBox.canCacheForLayoutState(*this)) {
         ASSERT(!layoutBox.cachedGeometryForLayoutState(*this));
         auto newBox = makeUnique<BoxGeometry>();
@@ -83,6 +84,14 @@ BoxGeometry& LayoutState::ensureGeometryForBoxSlow(const Box& layoutBox)
     }).iterator->value;
 }
 
+bool LayoutState::hasFormattingState(const ContainerBox& formattingRoot) const
+{
+    return m_inlineFormattingStates.contains(&formattingRoot)
+        || m_blockFormattingStates.contains(&formattingRoot)
+        || m_tableFormattingStates.contains(&formattingRoot)
+        || m_flexFormattingStates.contains(&formattingRoot);
+}
+
 FormattingState& LayoutState::formattingStateForBox(const Box& layoutBox) const
 {
     return establishedFormattingState(layoutBox.formattingContextRoot());
@@ -66,6 +66,7 @@ public:
 
     FormattingState& formattingStateForBox(const Box&) const;
     bool hasInlineFormattingState(const ContainerBox& formattingRoot) const { return m_inlineFormattingStates.contains(&formattingRoot); }
+    bool hasFormattingState(const ContainerBox& formattingRoot) const;
 
 #ifndef NDEBUG
     void registerFormattingContext(const FormattingContext&);
@@ -78,6 +79,10 @@ public:
 
     bool hasBoxGeometry(const Box&) const;
 
+    // For performance testing purposes only.
+    size_t boxGeometryCount() const { return m_boxGeometryCount; }
+    size_t formattingStateCount() const { return m_inlineFormattingStates.size() + m_blockFormattingStates.size() + m_tableFormattingStates.size() + m_flexFormattingStates.size(); }
+
     enum class QuirksMode { No, Limited, Yes };
     bool inQuirksMode() const { return m_quirksMode == QuirksMode::Yes; }
     bool inLimitedQuirksMode() const { return m_quirksMode == QuirksMode::Limited; }
@@ -110,6 +115,7 @@ private:
     HashSet<const FormattingContext*> m_formattingContextList;
 #endif
     HashMap<const Box*, std::unique_ptr<BoxGeometry>> m_layoutBoxToBoxGeometry;
+    size_t m_boxGeometryCount { 0 };
     QuirksMode m_quirksMode { QuirksMode::No };
 
     WeakPtr<const ContainerBox> m_rootContainer;
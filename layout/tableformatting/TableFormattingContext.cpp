@@ -51,10 +51,12 @@ TableFormattingContext::TableFormattingContext(const ContainerBox& formattingCon
 {
 }
 
-void TableFormattingContext::layoutInFlowContent(InvalidationState&, const ConstraintsForInFlowContent& constraints)
+void TableFormattingContext::layoutInFlowContent(InvalidationState& invalidationState, const ConstraintsForInFlowContent& constraints)
 {
     auto availableHorizontalSpace = constraints.horizontal.logicalWidth;
     auto availableVerticalSpace = constraints.vertical.logicalHeight;
+    // 0. Drop the cached preferred widths of the columns with changed cell content.
+    invalidateWidthConstraintsForChangedCells(invalidationState);
     // 1. Compute width and height for the grid.
     computeAndDistributeExtraSpace(availableHorizontalSpace, availableVerticalSpace);
     // 2. Finalize cells.
@@ -303,6 +305,44 @@ void TableFormattingContext::layoutCell(const TableGrid::Cell& cell, LayoutUnit
     cellBoxGeometry.setContentBoxHeight(geometry().cellHeigh(cellBox));
 }
 
+void TableFormattingContext::invalidateWidthConstraintsForChangedCells(const InvalidationState& invalidationState)
+{
+    auto& layoutState = this->layoutState();
+    auto& grid = formattingState().tableGrid();
+    auto hasChangedCells = false;
+    // A change inside a cell marks the formatting context root of the changed box, which may be nested deep inside the cell.
+    // Every box from there up to the cell may have its intrinsic widths cached in the formatting state it lives in, and every
+    // formatting context root on the way caches the intrinsic widths of its content in the formatting state it establishes.
+    for (auto& changedRoot : invalidationState.formattingContextRoots()) {
+        Vector<const Box*> boxesToInvalidate;
+        const ContainerBox* changedCell = nullptr;
+        for (const Box* box = &changedRoot; box != &root() && !box->isInitialContainingBlock(); box = &box->parent()) {
+            boxesToInvalidate.append(box);
+            if (box->isTableCell() && &box->formattingContextRoot() == &root()) {
+                changedCell = &downcast<ContainerBox>(*box);
+                break;
+            }
+        }
+        // Not inside one of our cells.
+        if (!changedCell)
+            continue;
+
+        for (auto* box : boxesToInvalidate) {
+            if (box->establishesFormattingContext() && layoutState.hasFormattingState(downcast<ContainerBox>(*box)))
+                layoutState.establishedFormattingState(downcast<ContainerBox>(*box)).clearIntrinsicWidthConstraints();
+            auto& containingFormattingContextRoot = box->formattingContextRoot();
+            if (layoutState.hasFormattingState(containingFormattingContextRoot))
+                layoutState.establishedFormattingState(containingFormattingContextRoot).clearIntrinsicWidthConstraints(*box);
+        }
+        grid.invalidateWidthConstraints(*changedCell);
+        hasChangedCells = true;
+    }
+    if (hasChangedCells && !grid.widthConstraints()) {
+        // Recompute the table's min/max widths using the still valid column preferred widths.
+        computedIntrinsicWidthConstraints();
+    }
+}
+
 FormattingContext::IntrinsicWidthConstraints TableFormattingContext::computedIntrinsicWidthConstraints()
 {
     // Tables have a slighty different concept of shrink to fit. It's really only different with non-auto "width" values, where
@@ -381,25 +421,31 @@ FormattingContext::IntrinsicWidthConstraints TableFormattingContext::computedPre
     // 3. Find the min/max width for each columns using the cell constraints and the <col> fixed widths but ignore column spans.
     // 4. Distribute column spanning cells min/max widths.
     // 5. Add them all up and return the computed min/max widths.
-    for (auto& cell : grid.cells()) {
-        auto& cellBox = cell->box();
-        ASSERT(cellBox.establishesBlockFormattingContext());
+    // Steps 1-3 are cached on the columns and only run for columns that got invalidated since the last computation.
+    auto& columnList = grid.columns().list();
+    auto numberOfRows = grid.rows().size();
+    auto computedPreferredWidthForColumn = [&] (size_t columnIndex) {
+        auto preferredWidth = TableGrid::Column::PreferredWidth { };
+        // 1. Spanner cells put their intrinsic widths on the initial slots.
+        for (size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex) {
+            auto& slot = *grid.slot({ columnIndex, rowIndex });
+            if (slot.isColumnSpanned() || slot.isRowSpanned())
+                continue;
+            auto& cell = slot.cell();
+            auto& cellBox = cell.box();
+            ASSERT(cellBox.establishesBlockFormattingContext());
 
-        auto intrinsicWidth = formattingState.intrinsicWidthConstraintsForBox(cellBox);
-        if (!intrinsicWidth) {
-            intrinsicWidth = geometry().intrinsicWidthConstraintsForCell(*cell);
-            formattingState.setIntrinsicWidthConstraintsForBox(cellBox, *intrinsicWidth);
+            auto intrinsicWidth = formattingState.intrinsicWidthConstraintsForBox(cellBox);
+            if (!intrinsicWidth) {
+                intrinsicWidth = geometry().intrinsicWidthConstraintsForCell(cell);
+                formattingState.setIntrinsicWidthConstraintsForBox(cellBox, *intrinsicWidth);
+            }
+            slot.setWidthConstraints(*intrinsicWidth);
         }
-        // Spanner cells put their intrinsic widths on the initial slots.
-        grid.slot(cell->position())->setWidthConstraints(*intrinsicWidth);
-    }
 
-    // 2. Collect the fixed width <col>s.
-    auto& columnList = grid.columns().list();
-    Vector<Optional<LayoutUnit>> fixedWidthColumns;
-    for (auto& column : columnList) {
-        auto fixedWidth = [&] () -> Optional<LayoutUnit> {
-            auto* columnBox = column.box();
+        // 2. Check if this is a fixed width <col>.
+        auto columnFixedWidth = [&] () -> Optional<LayoutUnit> {
+            auto* columnBox = columnList[columnIndex].box();
             if (!columnBox) {
                 // Anoynmous columns don't have associated layout boxes and can't have fixed col size.
                 return { };
@@ -407,31 +453,36 @@ FormattingContext::IntrinsicWidthConstraints TableFormattingContext::computedPre
             if (auto width = columnBox->columnWidth())
                 return width;
             return geometry().computedColumnWidth(*columnBox);
-        };
-        fixedWidthColumns.append(fixedWidth());
-    }
+        }();
 
-    Vector<FormattingContext::IntrinsicWidthConstraints> columnIntrinsicWidths(columnList.size());
-    // 3. Collect he min/max width for each column but ignore column spans for now.
-    Vector<SlotPosition> spanningCellPositionList;
-    size_t numberOfActualColumns = 0;
-    for (size_t columnIndex = 0; columnIndex < columnList.size(); ++columnIndex) {
-        auto columnHasNonSpannedCell = false;
-        for (size_t rowIndex = 0; rowIndex < grid.rows().size(); ++rowIndex) {
+        // 3. Collect he min/max width for this column but ignore column spans for now.
+        for (size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex) {
             auto& slot = *grid.slot({ columnIndex, rowIndex });
             if (slot.isColumnSpanned())
                 continue;
-            columnHasNonSpannedCell = true;
+            preferredWidth.hasNonSpannedCell = true;
             if (slot.hasColumnSpan()) {
-                spanningCellPositionList.append({ columnIndex, rowIndex });
+                preferredWidth.spanningCellPositions.append({ columnIndex, rowIndex });
                 continue;
             }
-            auto columnFixedWidth = fixedWidthColumns[columnIndex];
             auto widthConstraints = !columnFixedWidth ? slot.widthConstraints() : FormattingContext::IntrinsicWidthConstraints { *columnFixedWidth, *columnFixedWidth };
-            columnIntrinsicWidths[columnIndex].minimum = std::max(widthConstraints.minimum, columnIntrinsicWidths[columnIndex].minimum);
-            columnIntrinsicWidths[columnIndex].maximum = std::max(widthConstraints.maximum, columnIntrinsicWidths[columnIndex].maximum);
+            preferredWidth.widthConstraints.minimum = std::max(widthConstraints.minimum, preferredWidth.widthConstraints.minimum);
+            preferredWidth.widthConstraints.maximum = std::max(widthConstraints.maximum, preferredWidth.widthConstraints.maximum);
         }
-        if (columnHasNonSpannedCell)
+        return preferredWidth;
+    };
+
+    Vector<FormattingContext::IntrinsicWidthConstraints> columnIntrinsicWidths(columnList.size());
+    Vector<SlotPosition> spanningCellPositionList;
+    size_t numberOfActualColumns = 0;
+    for (size_t columnIndex = 0; columnIndex < columnList.size(); ++columnIndex) {
+        auto& column = columnList[columnIndex];
+        if (!column.preferredWidth())
+            column.setPreferredWidth(computedPreferredWidthForColumn(columnIndex));
+        auto& preferredWidth = *column.preferredWidth();
+        columnIntrinsicWidths[columnIndex] = preferredWidth.widthConstraints;
+        spanningCellPositionList.appendVector(preferredWidth.spanningCellPositions);
+        if (preferredWidth.hasNonSpannedCell)
             ++numberOfActualColumns;
     }
 
@@ -101,6 +101,7 @@ private:
     void setUsedGeometryForSections(const ConstraintsForInFlowContent&);
 
     IntrinsicWidthConstraints computedPreferredWidthForColumns();
+    void invalidateWidthConstraintsForChangedCells(const InvalidationState&);
     void computeAndDistributeExtraSpace(LayoutUnit availableHorizontalSpace, Optional<LayoutUnit> availableVerticalSpace);
 
     const TableFormattingState& formattingState() const { return downcast<TableFormattingState>(FormattingContext::formattingState()); }
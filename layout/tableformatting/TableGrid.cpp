@@ -178,6 +178,7 @@ void TableGrid::appendCell(const ContainerBox& cellBox)
     if (isInNewRow)
         m_rows.addRow(cellBox.parent());
 
+    m_cellMap.add(&cellBox, makeWeakPtr(*cell));
     m_cells.add(WTFMove(cell));
 }
 
@@ -192,6 +193,18 @@ void TableGrid::removeCell(const ContainerBox& cellBox)
     UNUSED_PARAM(cellBox);
 }
 
+void TableGrid::invalidateWidthConstraints(const ContainerBox& cellBox)
+{
+    auto* cell = this->cell(cellBox);
+    if (!cell)
+        return;
+    // Only the columns this cell spans need to be recomputed. Column spanners are distributed after the per-column
+    // pass, so their contributions to the clean columns are applied again without revisiting those columns' cells.
+    for (auto column = cell->startColumn(); column < cell->endColumn(); ++column)
+        m_columns.list()[column].invalidatePreferredWidth();
+    m_intrinsicWidthConstraints = { };
+}
+
 }
 }
 #endif
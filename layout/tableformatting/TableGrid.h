@@ -48,6 +48,8 @@ public:
     void appendCell(const ContainerBox&);
     void insertCell(const ContainerBox&, const ContainerBox& before);
     void removeCell(const ContainerBox&);
+    // Drops the cached preferred widths of the columns the cell box spans.
+    void invalidateWidthConstraints(const ContainerBox& cellBox);
 
     void setHorizontalSpacing(LayoutUnit horizontalSpacing) { m_horizontalSpacing = horizontalSpacing; }
     LayoutUnit horizontalSpacing() const { return m_horizontalSpacing; }
@@ -78,12 +80,24 @@ public:
         void setHasFixedWidthCell() { m_hasFixedWidthCell = true; }
         const ContainerBox* box() const { return m_layoutBox.get(); }
 
+        // Min/max width contribution of the non-spanning cells (or the fixed <col> width) of this column.
+        // Column spanners are distributed on top of these values, so their initial slots are cached here too.
+        struct PreferredWidth {
+            FormattingContext::IntrinsicWidthConstraints widthConstraints;
+            bool hasNonSpannedCell { false };
+            Vector<SlotPosition> spanningCellPositions;
+        };
+        void setPreferredWidth(PreferredWidth&& preferredWidth) { m_preferredWidth = WTFMove(preferredWidth); }
+        const Optional<PreferredWidth>& preferredWidth() const { return m_preferredWidth; }
+        void invalidatePreferredWidth() { m_preferredWidth = { }; }
+
     private:
         bool hasFixedWidthCell() const { return m_hasFixedWidthCell; }
 
         LayoutUnit m_computedLogicalWidth;
         LayoutUnit m_computedLogicalLeft;
         WeakPtr<const ContainerBox> m_layoutBox;
+        Optional<PreferredWidth> m_preferredWidth;
         bool m_hasFixedWidthCell { false };
 
 #if ASSERT_ENABLED
@@ -221,13 +235,17 @@ public:
     const Slot* slot(SlotPosition position) const { return m_slotMap.get(position); }
     bool isSpanned(SlotPosition);
 
+    Cell* cell(const ContainerBox& cellBox) { return m_cellMap.get(&cellBox).get(); }
+
 private:
     using SlotMap = WTF::HashMap<SlotPosition, std::unique_ptr<Slot>>;
+    using CellMap = WTF::HashMap<const ContainerBox*, WeakPtr<Cell>>;
 
     Columns m_columns;
     Rows m_rows;
     Cells m_cells;
     SlotMap m_slotMap;
+    CellMap m_cellMap;
 
     LayoutUnit m_horizontalSpacing;
     LayoutUnit m_verticalSpacing;
@@ -44,6 +44,7 @@
 #include "SubresourceLoader.h"
 #include <wtf/NeverDestroyed.h>
 #include <wtf/StdLibExtras.h>
+#include <wtf/text/StringConcatenateNumbers.h>
 
 #if PLATFORM(IOS_FAMILY)
 #include "SystemMemory.h"
@@ -142,13 +143,17 @@ void CachedImage::didRemoveClient(CachedResourceClient& client)
     ASSERT(client.resourceClientType() == CachedImageClient::expectedType());
 
     m_pendingContainerContextRequests.remove(&static_cast<CachedImageClient&>(client));
-    m_clientsWaitingForAsyncDecoding.remove(&static_cast<CachedImageClient&>(client));
+    bool wasWaitingForAsyncDecoding = m_clientsWaitingForAsyncDecoding.remove(&static_cast<CachedImageClient&>(client));
 
     if (m_svgImageCache)
         m_svgImageCache->removeClientFromCache(&static_cast<CachedImageClient&>(client));
 
     CachedResource::didRemoveClient(client);
 
+    // Nothing displays the image anymore, so don't keep the shared decoding threads busy with it.
+    if (wasWaitingForAsyncDecoding && !hasClients() && hasImage() && is<BitmapImage>(image()))
+        downcast<BitmapImage>(image())->stopAsyncDecodingQueue();
+
     static_cast<CachedImageClient&>(client).didRemoveCachedImageClient(*this);
 }
 
@@ -624,6 +629,22 @@ void CachedImage::destroyDecodedData()
         m_image->destroyDecodedData();
 }
 
+String CachedImage::decodedImageCacheIdentifier() const
+{
+    if (!isLoaded() || errorOccurred() || url().protocolIsData())
+        return { };
+
+    // Only a validator tells that two responses for the same URL have the same content. The cache
+    // partition keeps a site from finding out, by how fast an image decodes, what another site showed.
+    String validator = response().httpHeaderField(HTTPHeaderName::ETag);
+    if (validator.isEmpty())
+        validator = response().httpHeaderField(HTTPHeaderName::LastModified);
+    if (validator.isEmpty())
+        return { };
+
+    return makeString(cachePartition(), ' ', url().string(), ' ', validator, ' ', encodedSize());
+}
+
 void CachedImage::encodedDataStatusChanged(const Image& image, EncodedDataStatus)
 {
     if (&image != m_image)
@@ -146,6 +146,7 @@ private:
         URL sourceUrl() const override { return !m_cachedImages.isEmpty() ? (*m_cachedImages.begin())->url() : URL(); }
         String mimeType() const override { return !m_cachedImages.isEmpty() ? (*m_cachedImages.begin())->mimeType() : emptyString(); }
         long long expectedContentLength() const override { return !m_cachedImages.isEmpty() ? (*m_cachedImages.begin())->expectedContentLength() : 0; }
+        String decodedImageCacheIdentifier() const override { return !m_cachedImages.isEmpty() ? (*m_cachedImages.begin())->decodedImageCacheIdentifier() : String(); }
 
         void encodedDataStatusChanged(const Image&, EncodedDataStatus) final;
         void decodedSizeChanged(const Image&, long long delta) final;
@@ -159,6 +160,7 @@ private:
         HashSet<CachedImage*> m_cachedImages;
     };
 
+    String decodedImageCacheIdentifier() const;
     void encodedDataStatusChanged(const Image&, EncodedDataStatus);
     void decodedSizeChanged(const Image&, long long delta);
     void didDraw(const Image&);
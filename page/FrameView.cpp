@@ -2519,6 +2519,7 @@ void FrameView::scrollPositionChanged(const ScrollPosition& oldPosition, const S
     LOG_WITH_STREAM(Scrolling, stream << "FrameView " << this << " scrollPositionChanged from " << oldPosition << " to " << newPosition << " (scale " << frameScaleFactor() << " )");
     updateLayoutViewport();
     viewportContentsChanged();
+    layoutContext().scheduleLayoutForDeferredContentIfNeeded();
 
     if (auto* renderView = this->renderView()) {
         if (auto* layer = renderView->layer())
@@ -318,6 +318,8 @@ void FrameViewLayoutContext::reset()
     m_firstLayout = true;
     m_asynchronousTasksTimer.stop();
     m_needsFullRepaint = true;
+    m_deferredLayoutContent.clear();
+    m_subtreesWithSkippedLayout.clear();
 }
 
 bool FrameViewLayoutContext::needsLayout() const
@@ -627,8 +629,9 @@ bool FrameViewLayoutContext::pushLayoutStateForPaginationIfNeeded(RenderBlockFlo
 bool FrameViewLayoutContext::pushLayoutState(RenderBox& renderer, const LayoutSize& offset, LayoutUnit pageHeight, bool pageHeightChanged)
 {
     // We push LayoutState even if layoutState is disabled because it stores layoutDelta too.
+    // Lazy layout needs it in full repaint layouts too, see lazyLayoutRect().
     auto* layoutState = this->layoutState();
-    if (!layoutState || !needsFullRepaint() || layoutState->isPaginated() || renderer.enclosingFragmentedFlow()
+    if (!layoutState || !needsFullRepaint() || renderer.settings().lazyLayoutEnabled() || layoutState->isPaginated() || renderer.enclosingFragmentedFlow()
         || layoutState->lineGrid() || (renderer.style().lineGrid() != RenderStyle::initialLineGrid() && renderer.isRenderBlockFlow())) {
         m_layoutStateStack.append(makeUnique<RenderLayoutState>(m_layoutStateStack, renderer, offset, pageHeight, pageHeightChanged));
         return true;
@@ -641,6 +644,122 @@ void FrameViewLayoutContext::popLayoutState()
     m_layoutStateStack.removeLast();
 }
 
+Optional<LayoutRect> FrameViewLayoutContext::lazyLayoutRect(const RenderBox& renderer) const
+{
+    if (!renderer.settings().lazyLayoutEnabled())
+        return WTF::nullopt;
+
+    auto& style = renderer.style();
+    if (!style.isHorizontalWritingMode() || style.isFlippedBlocksWritingMode())
+        return WTF::nullopt;
+
+    // The renderer is in the middle of its layout, so its position comes from the layout state it pushed and not from
+    // the (not yet updated) geometry of its ancestors. Printing and other paginated content needs all of its content laid out.
+    auto* layoutState = this->layoutState();
+    if (!layoutState || !isPaintOffsetCacheEnabled() || layoutState->isPaginated() || layoutState->lineGrid())
+        return WTF::nullopt;
+    ASSERT(layoutState->renderer() == &renderer);
+
+    // Only content that moves with the document scroll position can be scheduled through the frame's scroll updates.
+    for (auto* ancestor = renderer.containingBlock(); ancestor && !is<RenderView>(*ancestor); ancestor = ancestor->containingBlock()) {
+        if (ancestor->hasOverflowClip() || ancestor->hasTransformRelatedProperty() || ancestor->isFixedPositioned())
+            return WTF::nullopt;
+    }
+
+    auto lazyLayoutRect = LayoutRect { view().visibleContentRect() };
+    if (lazyLayoutRect.isEmpty())
+        return WTF::nullopt;
+    // Lay out one extra viewport worth of content in each direction so that scrolling has time to catch up.
+    lazyLayoutRect.inflateY(lazyLayoutRect.height());
+    lazyLayoutRect.move(-layoutState->paintOffset());
+    return lazyLayoutRect;
+}
+
+bool FrameViewLayoutContext::canSkipLayoutOfSubtree(const RenderBox& renderer)
+{
+    // Out-of-flow descendants are laid out by containing blocks that may be outside of the subtree, and layers and widgets
+    // get painted and positioned without going through the (skipped) renderer.
+    for (auto* descendant = renderer.firstChild(); descendant; descendant = descendant->nextInPreOrder(&renderer)) {
+        if (descendant->isOutOfFlowPositioned() || descendant->hasLayer() || descendant->isWidget())
+            return false;
+    }
+    return true;
+}
+
+static void clearNeedsLayoutForSubtree(RenderElement& renderer)
+{
+    for (auto* child = renderer.firstChild(); child; child = child->nextSibling()) {
+        if (is<RenderElement>(*child))
+            clearNeedsLayoutForSubtree(downcast<RenderElement>(*child));
+        else
+            child->clearNeedsLayout();
+    }
+    renderer.clearNeedsLayout();
+}
+
+void FrameViewLayoutContext::skipLayoutOfSubtree(RenderBox& renderer)
+{
+    ASSERT(isInLayout());
+    ASSERT(canSkipLayoutOfSubtree(renderer));
+    m_subtreesWithSkippedLayout.add(renderer);
+    clearNeedsLayoutForSubtree(renderer);
+}
+
+void FrameViewLayoutContext::markSkippedSubtreeForLayout(RenderBox& renderer)
+{
+    if (m_subtreesWithSkippedLayout.computesEmpty() || !m_subtreesWithSkippedLayout.remove(renderer))
+        return;
+
+    for (auto* descendant = renderer.firstChild(); descendant; descendant = descendant->nextInPreOrder(&renderer))
+        descendant->setNeedsLayout(MarkOnlyThis);
+    renderer.setNeedsLayout(MarkOnlyThis);
+}
+
+void FrameViewLayoutContext::setDeferredLayoutRanges(RenderBox& renderer, Vector<DeferredLayoutRange>&& ranges)
+{
+    ASSERT(!ranges.isEmpty());
+    m_deferredLayoutContent.set(&renderer, DeferredLayoutContent { makeWeakPtr(renderer), WTFMove(ranges) });
+}
+
+void FrameViewLayoutContext::clearDeferredLayoutRanges(const RenderBox& renderer)
+{
+    m_deferredLayoutContent.remove(&renderer);
+}
+
+void FrameViewLayoutContext::scheduleLayoutForDeferredContentIfNeeded()
+{
+    if (m_deferredLayoutContent.isEmpty() || isInLayout())
+        return;
+
+    // Deferred content gets laid out once it is within half a viewport of the visible rect, well before it gets exposed.
+    auto triggerRect = LayoutRect { view().visibleContentRect() };
+    triggerRect.inflateY(triggerRect.height() / 2);
+
+    Vector<WeakPtr<RenderBox>> renderersToLayout;
+    m_deferredLayoutContent.removeIf([&](auto& entry) {
+        auto* renderer = entry.value.renderer.get();
+        if (!renderer)
+            return true;
+        if (renderer->needsLayout())
+            return false;
+        auto rendererTop = LayoutUnit { renderer->localToAbsolute().y() };
+        for (auto& range : entry.value.ranges) {
+            if (rendererTop + range.logicalBottom > triggerRect.y() && rendererTop + range.logicalTop < triggerRect.maxY()) {
+                renderersToLayout.append(entry.value.renderer);
+                break;
+            }
+        }
+        return false;
+    });
+
+    // The owner keeps its ranges: its next layout lays out the skipped content that is now close to the visible rect
+    // and updates them. This schedules that layout through the regular containing block chain marking.
+    for (auto& renderer : renderersToLayout) {
+        if (renderer)
+            renderer->setNeedsLayout();
+    }
+}
+
 #ifndef NDEBUG
 void FrameViewLayoutContext::checkLayoutState()
 {
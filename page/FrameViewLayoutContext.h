@@ -27,6 +27,9 @@
 
 #include "LayoutUnit.h"
 #include "Timer.h"
+#include <wtf/HashMap.h>
+#include <wtf/Vector.h>
+#include <wtf/WeakHashSet.h>
 #include <wtf/WeakPtr.h>
 
 namespace WebCore {
@@ -34,6 +37,7 @@ namespace WebCore {
 class Document;
 class Frame;
 class FrameView;
+class LayoutRect;
 class LayoutScope;
 class LayoutSize;
 class RenderBlockFlow;
@@ -120,6 +124,27 @@ public:
     const Layout::LayoutState* layoutFormattingState() const { return m_layoutState.get(); }
 #endif
 
+    // Lazy layout (see Settings::lazyLayoutEnabled) lets long runs of table rows and block children skip layout while they
+    // are far from the visible rect. Like content-visibility, the skipped subtrees get their dirty bits cleared and are
+    // remembered here, while their owner estimates their geometry. Once the visible rect gets close to them, the owner is
+    // marked for layout and lays them out again through the regular dirty bit propagation.
+    struct DeferredLayoutRange {
+        LayoutUnit logicalTop;
+        LayoutUnit logicalBottom;
+    };
+    // The rect (in the coordinate space of the renderer being laid out) that needs precise layout, or nullopt if the renderer
+    // can't defer the layout of its content.
+    Optional<LayoutRect> lazyLayoutRect(const RenderBox&) const;
+    static bool canSkipLayoutOfSubtree(const RenderBox&);
+    void skipLayoutOfSubtree(RenderBox&);
+    bool isLayoutOfSubtreeSkipped(const RenderBox& renderer) const { return !m_subtreesWithSkippedLayout.computesEmpty() && m_subtreesWithSkippedLayout.contains(renderer); }
+    // Marks the whole skipped subtree as needing layout. Its ancestors are left to the caller.
+    void markSkippedSubtreeForLayout(RenderBox&);
+    void setDeferredLayoutRanges(RenderBox&, Vector<DeferredLayoutRange>&&);
+    void clearDeferredLayoutRanges(const RenderBox&);
+    bool hasDeferredLayoutRanges(const RenderBox& renderer) const { return m_deferredLayoutContent.contains(&renderer); }
+    void scheduleLayoutForDeferredContentIfNeeded();
+
 private:
     friend class LayoutScope;
     friend class LayoutStateMaintainer;
@@ -187,6 +212,12 @@ private:
     int m_layoutDisallowedCount { 0 };
     unsigned m_paintOffsetCacheDisableCount { 0 };
     LayoutStateStack m_layoutStateStack;
+    struct DeferredLayoutContent {
+        WeakPtr<RenderBox> renderer;
+        Vector<DeferredLayoutRange> ranges;
+    };
+    HashMap<const RenderBox*, DeferredLayoutContent> m_deferredLayoutContent;
+    WeakHashSet<RenderBox> m_subtreesWithSkippedLayout;
 #if ENABLE(LAYOUT_FORMATTING_CONTEXT)
     std::unique_ptr<Layout::LayoutState> m_layoutState;
     std::unique_ptr<Layout::LayoutTree> m_layoutTree;
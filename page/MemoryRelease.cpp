@@ -34,6 +34,7 @@
 #include "ChromeClient.h"
 #include "CommonVM.h"
 #include "CookieJar.h"
+#include "DecodedImageCache.h"
 #include "Document.h"
 #include "FontCache.h"
 #include "Frame.h"
@@ -45,6 +46,7 @@
 #include "Logging.h"
 #include "MemoryCache.h"
 #include "Page.h"
+#include "RenderLayerFilters.h"
 #include "RenderTheme.h"
 #include "ScrollingThread.h"
 #include "StyleScope.h"
@@ -68,6 +70,10 @@ static void releaseNoncriticalMemory(MaintainMemoryCache maintainMemoryCache)
 
     FontCache::singleton().purgeInactiveFontData();
 
+    DecodedImageCache::singleton().pruneUnreferencedImages();
+
+    RenderLayerFilters::clearAllCachedResults();
+
     clearWidthCaches();
     TextPainter::clearGlyphDisplayLists();
 
@@ -101,6 +107,8 @@ static void releaseCriticalMemory(Synchronous synchronous, MaintainBackForwardCa
 
     CSSValuePool::singleton().drain();
 
+    DecodedImageCache::singleton().clear();
+
     Page::forEachPage([](auto& page) {
         page.cookieJar().clearCache();
     });
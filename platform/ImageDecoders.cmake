@@ -10,6 +10,8 @@ list(APPEND WebCore_PRIVATE_INCLUDE_DIRECTORIES
 )
 
 list(APPEND WebCore_SOURCES
+    platform/image-decoders/ImageBackingStore.cpp
+    platform/image-decoders/ImageRowDownsampler.cpp
     platform/image-decoders/ScalableImageDecoder.cpp
     platform/image-decoders/ScalableImageDecoderFrame.cpp
 
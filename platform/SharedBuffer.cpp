@@ -57,6 +57,12 @@ SharedBuffer::SharedBuffer(Vector<char>&& data)
     append(WTFMove(data));
 }
 
+SharedBuffer::SharedBuffer(Ref<DataSegment>&& segment)
+    : m_size(segment->size())
+{
+    m_segments.append({0, WTFMove(segment)});
+}
+
 #if USE(GSTREAMER)
 Ref<SharedBuffer> SharedBuffer::create(GstMappedOwnedBuffer& mappedBuffer)
 {
@@ -86,6 +92,11 @@ Ref<SharedBuffer> SharedBuffer::create(Vector<char>&& vector)
     return adoptRef(*new SharedBuffer(WTFMove(vector)));
 }
 
+Ref<SharedBuffer> SharedBuffer::create(Ref<DataSegment>&& segment)
+{
+    return adoptRef(*new SharedBuffer(WTFMove(segment)));
+}
+
 // FIXME: Move the whole class from Vector<char> to Vector<uint8_t> and make this efficient, replacing the Vector<char> version above.
 Ref<SharedBuffer> SharedBuffer::create(Vector<uint8_t>&& vector)
 {
@@ -199,6 +199,10 @@ public:
         Ref<DataSegment> segment;
     };
     using DataSegmentVector = Vector<DataSegmentVectorEntry, 1>;
+
+    // Makes a buffer that shares the segment instead of copying its data.
+    static Ref<SharedBuffer> create(Ref<DataSegment>&&);
+
     DataSegmentVector::const_iterator begin() const { return m_segments.begin(); }
     DataSegmentVector::const_iterator end() const { return m_segments.end(); }
     
@@ -220,6 +224,7 @@ private:
     explicit SharedBuffer(const unsigned char*, size_t);
     explicit SharedBuffer(Vector<char>&&);
     explicit SharedBuffer(FileSystem::MappedFileData&&);
+    explicit SharedBuffer(Ref<DataSegment>&&);
 #if USE(CF)
     explicit SharedBuffer(CFDataRef);
 #endif
@@ -9,12 +9,15 @@ list(APPEND WebCore_SOURCES
     platform/graphics/texmap/ANGLEContext.cpp
     platform/graphics/texmap/BitmapTexture.cpp
     platform/graphics/texmap/BitmapTexturePool.cpp
+    platform/graphics/texmap/BitmapTextureSoftware.cpp
+    platform/graphics/texmap/ClipStack.cpp
     platform/graphics/texmap/GraphicsContextGLTextureMapper.cpp
     platform/graphics/texmap/TextureMapper.cpp
     platform/graphics/texmap/TextureMapperBackingStore.cpp
     platform/graphics/texmap/TextureMapperFPSCounter.cpp
     platform/graphics/texmap/TextureMapperGCGLPlatformLayer.cpp
     platform/graphics/texmap/TextureMapperLayer.cpp
+    platform/graphics/texmap/TextureMapperSoftware.cpp
     platform/graphics/texmap/TextureMapperTile.cpp
 )
 
@@ -23,6 +26,7 @@ list(APPEND WebCore_PRIVATE_FRAMEWORK_HEADERS
 
     platform/graphics/texmap/ANGLEContext.h
     platform/graphics/texmap/BitmapTexture.h
+    platform/graphics/texmap/BitmapTextureSoftware.h
     platform/graphics/texmap/ClipStack.h
     platform/graphics/texmap/GraphicsLayerTextureMapper.h
     platform/graphics/texmap/TextureMapper.h
@@ -35,6 +39,7 @@ list(APPEND WebCore_PRIVATE_FRAMEWORK_HEADERS
     platform/graphics/texmap/TextureMapperPlatformLayer.h
     platform/graphics/texmap/TextureMapperPlatformLayerProxy.h
     platform/graphics/texmap/TextureMapperPlatformLayerProxyProvider.h
+    platform/graphics/texmap/TextureMapperSoftware.h
     platform/graphics/texmap/TextureMapperTile.h
     platform/graphics/texmap/TextureMapperTiledBackingStore.h
 )
@@ -42,7 +47,6 @@ list(APPEND WebCore_PRIVATE_FRAMEWORK_HEADERS
 if (USE_TEXTURE_MAPPER_GL)
     list(APPEND WebCore_SOURCES
         platform/graphics/texmap/BitmapTextureGL.cpp
-        platform/graphics/texmap/ClipStack.cpp
         platform/graphics/texmap/TextureMapperContextAttributes.cpp
         platform/graphics/texmap/TextureMapperGL.cpp
         platform/graphics/texmap/TextureMapperShaderProgram.cpp
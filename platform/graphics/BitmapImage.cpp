@@ -77,8 +77,14 @@ void BitmapImage::destroyDecodedData(bool destroyAll)
 {
     LOG(Images, "BitmapImage::%s - %p - url: %s", __FUNCTION__, this, sourceURL().string().utf8().data());
 
-    if (!destroyAll)
-        m_source->destroyDecodedDataBeforeFrame(m_currentFrame);
+    if (!destroyAll) {
+        // A streaming animation keeps no frame other than the current one, including the frames
+        // after it that are left over from the previous loop.
+        if (shouldStreamAnimation())
+            m_source->destroyAllDecodedDataExcludeFrame(m_currentFrame);
+        else
+            m_source->destroyDecodedDataBeforeFrame(m_currentFrame);
+    }
     else if (!canDestroyDecodedData())
         m_source->destroyAllDecodedDataExcludeFrame(m_currentFrame);
     else {
@@ -103,7 +109,7 @@ void BitmapImage::destroyDecodedDataIfNecessary(bool destroyAll)
     if (!data() && frameCount())
         return;
 
-    if (m_source->decodedSize() < LargeAnimationCutoff)
+    if (m_source->decodedSize() < LargeAnimationCutoff && !shouldStreamAnimation())
         return;
 
     destroyDecodedData(destroyAll);
@@ -245,6 +251,10 @@ ImageDrawResult BitmapImage::draw(GraphicsContext& context, const FloatRect& des
     auto sizeForDrawing = expandedIntSize(srcSize * scaleFactorForDrawing);
     ImageDrawResult result = ImageDrawResult::DidDraw;
 
+    // Very large images are decoded a tile at a time, only where they are drawn.
+    if ((options.orientation() == ImageOrientation::FromImage || options.orientation() == ImageOrientation::None) && m_source->usesRegionDecoding())
+        return drawRegionTiles(context, destRect, srcRect, scaleFactorForDrawing, options);
+
     m_currentSubsamplingLevel = m_allowSubsampling ? subsamplingLevelForScaleFactor(context, scaleFactorForDrawing) : SubsamplingLevel::Default;
     LOG(Images, "BitmapImage::%s - %p - url: %s [subsamplingLevel = %d scaleFactorForDrawing = (%.4f, %.4f)]", __FUNCTION__, this, sourceURL().string().utf8().data(), static_cast<int>(m_currentSubsamplingLevel), scaleFactorForDrawing.width(), scaleFactorForDrawing.height());
 
@@ -260,7 +270,8 @@ ImageDrawResult BitmapImage::draw(GraphicsContext& context, const FloatRect& des
         // it is currently being decoded. New data may have been received since the previous request was made.
         if ((!frameIsCompatible && !frameIsBeingDecoded) || m_currentFrameDecodingStatus == DecodingStatus::Invalid) {
             LOG(Images, "BitmapImage::%s - %p - url: %s [requesting large async decoding]", __FUNCTION__, this, sourceURL().string().utf8().data());
-            m_source->requestFrameAsyncDecodingAtIndex(m_currentFrame, m_currentSubsamplingLevel, sizeForDrawing);
+            // The image is being painted, so it is visible, unless script is also waiting for it to decode.
+            m_source->requestFrameAsyncDecodingAtIndex(m_currentFrame, m_currentSubsamplingLevel, sizeForDrawing, m_decodingCallbacks ? ImageDecodingPriority::DecodePromise : ImageDecodingPriority::Visible);
             m_currentFrameDecodingStatus = DecodingStatus::Decoding;
         }
 
@@ -329,6 +340,7 @@ ImageDrawResult BitmapImage::draw(GraphicsContext& context, const FloatRect& des
         drawNativeImage(*image, context, destRect, srcRect, IntSize(sourceSize(orientation)), options);
 
     m_currentFrameDecodingStatus = frameDecodingStatusAtIndex(m_currentFrame);
+    m_source->didDrawFrameAtIndex(m_currentFrame);
 
     if (imageObserver())
         imageObserver()->didDraw(*this);
@@ -336,6 +348,38 @@ ImageDrawResult BitmapImage::draw(GraphicsContext& context, const FloatRect& des
     return result;
 }
 
+ImageDrawResult BitmapImage::drawRegionTiles(GraphicsContext& context, const FloatRect& destRect, const FloatRect& srcRect, const FloatSize& scaleFactorForDrawing, const ImagePaintingOptions& options)
+{
+    // Only the part of the image inside the clip is decoded and drawn, so that showing a small
+    // part of a very large image, as when scrolling through it, doesn't decode all of it.
+    FloatRect visibleDestRect = intersection(destRect, context.clipBounds());
+    if (visibleDestRect.isEmpty())
+        return ImageDrawResult::DidNothing;
+
+    FloatRect visibleSrcRect = intersection(mapRect(visibleDestRect, destRect, srcRect), srcRect);
+    auto tiles = m_source->regionTilesForDrawing(visibleSrcRect, scaleFactorForDrawing);
+    if (tiles.isEmpty())
+        return ImageDrawResult::DidNothing;
+
+    LOG(Images, "BitmapImage::%s - %p - url: %s [drawing %zu region tiles]", __FUNCTION__, this, sourceURL().string().utf8().data(), tiles.size());
+
+    for (auto& tile : tiles) {
+        FloatRect tileSrcRect = intersection(visibleSrcRect, tile.sourceRect);
+        if (tileSrcRect.isEmpty())
+            continue;
+
+        IntSize tileImageSize = tile.image->size();
+        FloatRect tileDestRect = mapRect(tileSrcRect, srcRect, destRect);
+        FloatRect tileImageSrcRect = mapRect(tileSrcRect, tile.sourceRect, FloatRect({ }, tileImageSize));
+        context.drawNativeImage(tile.image.get(), tileImageSize, tileDestRect, tileImageSrcRect, { options, ImageOrientation::None });
+    }
+
+    if (imageObserver())
+        imageObserver()->didDraw(*this);
+
+    return ImageDrawResult::DidDraw;
+}
+
 void BitmapImage::drawPattern(GraphicsContext& ctxt, const FloatRect& destRect, const FloatRect& tileRect, const AffineTransform& transform, const FloatPoint& phase, const FloatSize& spacing, const ImagePaintingOptions& options)
 {
     if (tileRect.isEmpty())
@@ -392,7 +436,20 @@ bool BitmapImage::canUseAsyncDecodingForLargeImages() const
 
 bool BitmapImage::shouldUseAsyncDecodingForAnimatedImages() const
 {
-    return canAnimate() && m_allowAnimatedImageAsyncDecoding && (shouldUseAsyncDecodingForTesting() || m_source->canUseAsyncDecoding());
+    // A streaming animation decodes every frame it shows, so its next frame is decoded ahead of
+    // time however small its frames are.
+    return canAnimate() && m_allowAnimatedImageAsyncDecoding && (shouldUseAsyncDecodingForTesting() || shouldStreamAnimation() || m_source->canUseAsyncDecoding());
+}
+
+bool BitmapImage::shouldStreamAnimation() const
+{
+    if (!canAnimate())
+        return false;
+
+    // Decide from the size all the frames would have rather than from the size of the frames
+    // decoded so far, so a long animation never caches more than the current and next frames.
+    uint64_t animationBytes = static_cast<uint64_t>(frameCount()) * m_source->frameBytesAtIndex(0, m_currentSubsamplingLevel);
+    return animationBytes >= LargeAnimationCutoff;
 }
 
 void BitmapImage::clearTimer()
@@ -498,7 +555,7 @@ BitmapImage::StartAnimationStatus BitmapImage::internalStartAnimation()
         if (frameHasDecodedNativeImageCompatibleWithOptionsAtIndex(nextFrame, m_currentSubsamplingLevel, DecodingOptions(Optional<IntSize>())))
             LOG(Images, "BitmapImage::%s - %p - url: %s [cachedFrameCount = %ld nextFrame = %ld]", __FUNCTION__, this, sourceURL().string().utf8().data(), ++m_cachedFrameCount, nextFrame);
         else {
-            m_source->requestFrameAsyncDecodingAtIndex(nextFrame, m_currentSubsamplingLevel);
+            m_source->requestFrameAsyncDecodingAtIndex(nextFrame, m_currentSubsamplingLevel, { }, ImageDecodingPriority::NextAnimationFrame);
             m_currentFrameDecodingStatus = DecodingStatus::Decoding;
             LOG(Images, "BitmapImage::%s - %p - url: %s [requesting async decoding for nextFrame = %ld]", __FUNCTION__, this, sourceURL().string().utf8().data(), nextFrame);
         }
@@ -592,7 +649,7 @@ void BitmapImage::decode(WTF::Function<void()>&& callback)
         if (frameIsCompatible)
             internalStartAnimation();
         else if (!frameIsBeingDecoded) {
-            m_source->requestFrameAsyncDecodingAtIndex(m_currentFrame, m_currentSubsamplingLevel, Optional<IntSize>());
+            m_source->requestFrameAsyncDecodingAtIndex(m_currentFrame, m_currentSubsamplingLevel, Optional<IntSize>(), ImageDecodingPriority::DecodePromise);
             m_currentFrameDecodingStatus = DecodingStatus::Decoding;
         }
         return;
@@ -604,7 +661,7 @@ void BitmapImage::decode(WTF::Function<void()>&& callback)
     if (frameIsCompatible)
         callDecodingCallbacks();
     else if (!frameIsBeingDecoded) {
-        m_source->requestFrameAsyncDecodingAtIndex(m_currentFrame, m_currentSubsamplingLevel, Optional<IntSize>());
+        m_source->requestFrameAsyncDecodingAtIndex(m_currentFrame, m_currentSubsamplingLevel, Optional<IntSize>(), ImageDecodingPriority::DecodePromise);
         m_currentFrameDecodingStatus = DecodingStatus::Decoding;
     }
 }
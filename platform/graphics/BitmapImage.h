@@ -110,6 +110,7 @@ public:
     void setFrameDecodingDurationForTesting(Seconds duration) { m_source->setFrameDecodingDurationForTesting(duration); }
     bool canUseAsyncDecodingForLargeImages() const;
     bool shouldUseAsyncDecodingForAnimatedImages() const;
+    bool shouldStreamAnimation() const;
     void setClearDecoderAfterAsyncFrameRequestForTesting(bool value) { m_clearDecoderAfterAsyncFrameRequestForTesting = value; }
     void setLargeImageAsyncDecodingEnabledForTesting(bool enabled) { m_largeImageAsyncDecodingEnabledForTesting = enabled; }
     bool isLargeImageAsyncDecodingEnabledForTesting() const { return m_largeImageAsyncDecodingEnabledForTesting; }
@@ -117,6 +118,13 @@ public:
 
     WEBCORE_EXPORT unsigned decodeCountForTesting() const;
 
+    // Plays framesToShow frames of the animation, two loops by default, on a copy of this image and reports
+    // how much decoded frame data it keeps as the number of frames grows.
+    String runAnimationMemoryBenchmark(unsigned framesToShow);
+
+    // Decodes the first frame iterations times, each time into a copy of this image, and reports the time and pixel rate.
+    String runDecodingBenchmark(unsigned iterations);
+
     // Accessors for native image formats.
 #if USE(APPKIT)
     NSImage *nsImage() override;
@@ -173,6 +181,7 @@ private:
     bool hasDensityCorrectedSize() const override { return m_source->hasDensityCorrectedSize(); }
 
     ImageDrawResult draw(GraphicsContext&, const FloatRect& dstRect, const FloatRect& srcRect, const ImagePaintingOptions& = { }) override;
+    ImageDrawResult drawRegionTiles(GraphicsContext&, const FloatRect& dstRect, const FloatRect& srcRect, const FloatSize& scaleFactorForDrawing, const ImagePaintingOptions&);
     void drawPattern(GraphicsContext&, const FloatRect& destRect, const FloatRect& srcRect, const AffineTransform& patternTransform, const FloatPoint& phase, const FloatSize& spacing, const ImagePaintingOptions& = { }) override;
 #if PLATFORM(WIN)
     void drawFrameMatchingSourceSize(GraphicsContext&, const FloatRect& dstRect, const IntSize& srcSize, CompositeOperator) override;
@@ -214,7 +223,8 @@ private:
     void callDecodingCallbacks();
     void dump(WTF::TextStream&) const override;
 
-    // Animated images over a certain size are considered large enough that we'll only hang on to one frame at a time.
+    // Animated images over a certain size are considered large enough that we'll only hang on to one frame at a time,
+    // and decode the next one while the current one is shown. See shouldStreamAnimation().
     static const unsigned LargeAnimationCutoff = 30 * 1024 * 1024;
 
     mutable Ref<ImageSource> m_source;
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BitmapImage.h"
+
+#include "ImageSource.h"
+#include <wtf/MonotonicTime.h>
+
+#if !USE(CG) && !USE(DIRECT2D)
+#include "ImageBackingStore.h"
+#endif
+#include <wtf/text/TextStream.h>
+
+namespace WebCore {
+
+String BitmapImage::runAnimationMemoryBenchmark(unsigned framesToShow)
+{
+    if (!data() || !m_source->isAllDataReceived())
+        return "The image data is not complete."_s;
+
+    // The animation is played by an image of its own, so that the frames this image caches and the frame it shows are left
+    // alone. It has the same observer, since an image without one does not animate; the observer ignores the images it does not own.
+    auto image = BitmapImage::create(imageObserver());
+    image->setData(makeRefPtr(data()), true);
+
+    size_t frameCount = image->frameCount();
+    if (!frameCount)
+        return "The image has no frames."_s;
+    if (!framesToShow)
+        framesToShow = 2 * frameCount;
+
+    bool streams = image->shouldStreamAnimation();
+    unsigned frameBytes = image->m_source->frameBytesAtIndex(0, image->m_currentSubsamplingLevel);
+    Seconds shortestFrameDuration = Seconds::infinity();
+    for (size_t index = 0; index < frameCount; ++index)
+        shortestFrameDuration = std::min(shortestFrameDuration, image->frameDurationAtIndex(index));
+
+    TextStream stream;
+    stream << "Animated image memory benchmark: " << frameCount << " frames of " << frameBytes << " bytes, " << (streams ? "streamed" : "cached") << "\n";
+
+    Seconds decodingTime;
+    Seconds longestDecodingTime;
+    unsigned decodedFrameCount = 0;
+    unsigned peakDecodedSize = 0;
+    auto decodeFrameIfNeeded = [&](size_t index) {
+        if (image->frameHasFullSizeNativeImageAtIndex(index, image->m_currentSubsamplingLevel))
+            return;
+        auto startTime = MonotonicTime::now();
+        image->frameImageAtIndexCacheIfNeeded(index, image->m_currentSubsamplingLevel);
+        auto frameDecodingTime = MonotonicTime::now() - startTime;
+        decodingTime += frameDecodingTime;
+        longestDecodingTime = std::max(longestDecodingTime, frameDecodingTime);
+        ++decodedFrameCount;
+    };
+
+    for (unsigned shownFrameCount = 1; shownFrameCount <= framesToShow; ++shownFrameCount) {
+        // Advance the way internalAdvanceAnimation() does, then decode the frame to show. A streamed animation also decodes the
+        // next frame while this one is shown, which the decoding queue would do.
+        size_t index = (shownFrameCount - 1) % frameCount;
+        image->m_currentFrame = index;
+        image->destroyDecodedDataIfNecessary(false);
+        decodeFrameIfNeeded(index);
+        if (streams)
+            decodeFrameIfNeeded((index + 1) % frameCount);
+
+        peakDecodedSize = std::max(peakDecodedSize, image->decodedSize());
+        if (!(shownFrameCount & (shownFrameCount - 1)) || shownFrameCount == framesToShow) {
+            uint64_t cachedAnimationBytes = static_cast<uint64_t>(std::min<size_t>(shownFrameCount, frameCount)) * frameBytes;
+            stream << shownFrameCount << " frames shown: " << image->decodedSize() << " bytes decoded, " << peakDecodedSize << " bytes at most, "
+                << cachedAnimationBytes << " bytes if every frame shown stayed cached\n";
+        }
+    }
+
+    // A streamed animation has to decode every frame within the duration of the frame before it.
+    stream << decodedFrameCount << " frames decoded, " << (decodedFrameCount ? (decodingTime / decodedFrameCount).milliseconds() : 0) << "ms/frame, "
+        << longestDecodingTime.milliseconds() << "ms at most, shortest frame duration " << shortestFrameDuration.milliseconds() << "ms\n";
+    return stream.release();
+}
+
+String BitmapImage::runDecodingBenchmark(unsigned iterations)
+{
+    iterations = std::max(iterations, 1u);
+    if (!data() || !m_source->isAllDataReceived())
+        return "The image data is not complete."_s;
+
+    Seconds decodingTime;
+    IntSize frameSize;
+    for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+        // Every iteration decodes the first frame into an image of its own, so that nothing this image has decoded is reused or
+        // dropped. Creating the decoder and reading the header aren't timed.
+        auto image = BitmapImage::create();
+        image->setData(makeRefPtr(data()), true);
+        if (!image->frameCount())
+            return "The image has no frames."_s;
+        frameSize = image->m_source->size();
+
+        auto startTime = MonotonicTime::now();
+        auto nativeImage = image->frameImageAtIndexCacheIfNeeded(0);
+        decodingTime += MonotonicTime::now() - startTime;
+        if (!nativeImage)
+            return "The image can't be decoded."_s;
+    }
+
+    double megapixels = static_cast<double>(frameSize.area().unsafeGet()) / 1e6;
+    auto timePerIteration = decodingTime / iterations;
+    TextStream stream;
+    stream << "Image decoding benchmark: " << iterations << " iterations, " << frameSize.width() << "x" << frameSize.height() << " pixels\n";
+    stream << "decoding: " << timePerIteration.milliseconds() << "ms/iteration";
+    if (timePerIteration)
+        stream << ", " << megapixels / timePerIteration.seconds() << "MP/s";
+    stream << "\n";
+
+#if !USE(CG) && !USE(DIRECT2D)
+    // The row kernels the decoders write RGB rows with, against writing each pixel with setPixel(), over the same number of pixels.
+    unsigned rowWidth = std::max(frameSize.width(), 1);
+    unsigned rowCount = std::max(frameSize.height(), 1);
+    auto backingStore = ImageBackingStore::create({ static_cast<int>(rowWidth), 1 });
+    Vector<uint8_t> rgbRow(rowWidth * 3);
+    for (unsigned index = 0; index < rgbRow.size(); ++index)
+        rgbRow[index] = static_cast<uint8_t>(index * 7);
+
+    auto* destination = backingStore->pixelAt(0, 0);
+    auto startTime = MonotonicTime::now();
+    for (unsigned row = 0; row < rowCount; ++row) {
+        const uint8_t* source = rgbRow.data();
+        for (unsigned x = 0; x < rowWidth; ++x, source += 3)
+            backingStore->setPixel(destination + x, source[0], source[1], source[2], 255);
+    }
+    auto setPixelTime = MonotonicTime::now() - startTime;
+
+    startTime = MonotonicTime::now();
+    for (unsigned row = 0; row < rowCount; ++row)
+        backingStore->setRGBRow(destination, rgbRow.data(), rowWidth);
+    auto setRGBRowTime = MonotonicTime::now() - startTime;
+
+    if (setPixelTime && setRGBRowTime)
+        stream << "RGB rows: setPixel() " << megapixels / setPixelTime.seconds() << "MP/s, setRGBRow() " << megapixels / setRGBRowTime.seconds() << "MP/s\n";
+#endif
+    return stream.release();
+}
+
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DecodedImageCache.h"
+
+#include "Logging.h"
+#include <wtf/MainThread.h>
+
+namespace WebCore {
+
+DecodedImageCache& DecodedImageCache::singleton()
+{
+    static NeverDestroyed<DecodedImageCache> cache;
+    return cache;
+}
+
+static unsigned imageBytes(const NativeImage& image)
+{
+    return (image.size().area() * 4).unsafeGet();
+}
+
+RefPtr<NativeImage> DecodedImageCache::image(const DecodedImageCacheKey& key)
+{
+    ASSERT(isMainThread());
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_missCount;
+        return nullptr;
+    }
+
+    ++m_hitCount;
+    it->value.lastUseTime = MonotonicTime::now();
+    return it->value.image;
+}
+
+void DecodedImageCache::add(const DecodedImageCacheKey& key, NativeImage& image)
+{
+    ASSERT(isMainThread());
+    unsigned size = imageBytes(image);
+    if (size > m_capacity)
+        return;
+
+    auto result = m_entries.add(key, Entry { makeRef(image), size, MonotonicTime::now() });
+    if (!result.isNewEntry) {
+        m_size -= result.iterator->value.size;
+        result.iterator->value = Entry { makeRef(image), size, MonotonicTime::now() };
+    }
+    m_size += size;
+
+    pruneToSize(m_capacity);
+}
+
+void DecodedImageCache::didDraw(const DecodedImageCacheKey& key)
+{
+    ASSERT(isMainThread());
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+        it->value.lastUseTime = MonotonicTime::now();
+}
+
+void DecodedImageCache::setCapacity(unsigned capacity)
+{
+    m_capacity = capacity;
+    pruneToSize(m_capacity);
+}
+
+void DecodedImageCache::pruneToSize(unsigned targetSize)
+{
+    if (m_size <= targetSize)
+        return;
+
+    struct Candidate {
+        DecodedImageCacheKey key;
+        bool isReferenced;
+        MonotonicTime lastUseTime;
+    };
+
+    Vector<Candidate> candidates;
+    candidates.reserveInitialCapacity(m_entries.size());
+    for (auto& entry : m_entries)
+        candidates.uncheckedAppend({ entry.key, !entry.value.image->hasOneRef(), entry.value.lastUseTime });
+
+    std::sort(candidates.begin(), candidates.end(), [](auto& a, auto& b) {
+        if (a.isReferenced != b.isReferenced)
+            return !a.isReferenced;
+        return a.lastUseTime < b.lastUseTime;
+    });
+
+    for (auto& candidate : candidates) {
+        if (m_size <= targetSize)
+            break;
+        auto it = m_entries.find(candidate.key);
+        m_size -= it->value.size;
+        m_entries.remove(it);
+        ++m_evictionCount;
+    }
+
+    LOG(Images, "DecodedImageCache::%s - images: %u size: %u capacity: %u", __FUNCTION__, m_entries.size(), m_size, m_capacity);
+}
+
+void DecodedImageCache::pruneUnreferencedImages()
+{
+    ASSERT(isMainThread());
+    m_entries.removeIf([this](auto& entry) {
+        if (!entry.value.image->hasOneRef())
+            return false;
+        m_size -= entry.value.size;
+        ++m_evictionCount;
+        return true;
+    });
+}
+
+void DecodedImageCache::clear()
+{
+    ASSERT(isMainThread());
+    m_evictionCount += m_entries.size();
+    m_entries.clear();
+    m_size = 0;
+}
+
+auto DecodedImageCache::statistics() const -> Statistics
+{
+    Statistics statistics;
+    statistics.imageCount = m_entries.size();
+    statistics.size = m_size;
+    statistics.hitCount = m_hitCount;
+    statistics.missCount = m_missCount;
+    statistics.evictionCount = m_evictionCount;
+    return statistics;
+}
+
+void DecodedImageCache::resetStatistics()
+{
+    m_hitCount = 0;
+    m_missCount = 0;
+    m_evictionCount = 0;
+}
+
+} // namespace WebCore
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ImageTypes.h"
+#include "IntSize.h"
+#include "NativeImage.h"
+#include <wtf/HashMap.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// A decoded image is identified by the resource it was decoded from, and by what decoding
+// options change its pixels.
+struct DecodedImageCacheKey {
+    DecodedImageCacheKey() = default;
+
+    DecodedImageCacheKey(const String& resourceIdentifier, const IntSize& size, AlphaOption alphaOption, GammaAndColorProfileOption gammaAndColorProfileOption)
+        : resourceIdentifier(resourceIdentifier)
+        , size(size)
+        , alphaOption(alphaOption)
+        , gammaAndColorProfileOption(gammaAndColorProfileOption)
+    { }
+
+    explicit DecodedImageCacheKey(WTF::HashTableDeletedValueType)
+        : resourceIdentifier(WTF::HashTableDeletedValue)
+    { }
+
+    bool isHashTableDeletedValue() const { return resourceIdentifier.isHashTableDeletedValue(); }
+
+    bool operator==(const DecodedImageCacheKey& other) const
+    {
+        return resourceIdentifier == other.resourceIdentifier
+            && size == other.size
+            && alphaOption == other.alphaOption
+            && gammaAndColorProfileOption == other.gammaAndColorProfileOption;
+    }
+
+    String resourceIdentifier;
+    IntSize size;
+    AlphaOption alphaOption { AlphaOption::Premultiplied };
+    GammaAndColorProfileOption gammaAndColorProfileOption { GammaAndColorProfileOption::Applied };
+};
+
+struct DecodedImageCacheKeyHash {
+    static unsigned hash(const DecodedImageCacheKey& key)
+    {
+        IntegerHasher hasher;
+        hasher.add(key.resourceIdentifier.hash());
+        hasher.add(key.size.width());
+        hasher.add(key.size.height());
+        hasher.add(static_cast<unsigned>(key.alphaOption));
+        hasher.add(static_cast<unsigned>(key.gammaAndColorProfileOption));
+        return hasher.hash();
+    }
+
+    static bool equal(const DecodedImageCacheKey& a, const DecodedImageCacheKey& b)
+    {
+        return a == b;
+    }
+
+    static const bool safeToCompareToEmptyOrDeleted = false;
+};
+
+struct DecodedImageCacheKeyHashTraits : public SimpleClassHashTraits<DecodedImageCacheKey> {
+    static const bool emptyValueIsZero = false;
+};
+
+// Keeps decoded still images for every document in the process, so that an image does not
+// have to be decoded again when another image, or the same one after it destroyed its decoded
+// data, is created from the same resource. The cache is bounded by its capacity in bytes.
+// Images that no one else is keeping alive are evicted first, since evicting them releases
+// their memory, then images in the order they were last drawn, so that the images painted in
+// the viewport stay. It is only used on the main thread.
+class DecodedImageCache {
+    WTF_MAKE_NONCOPYABLE(DecodedImageCache);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    WEBCORE_EXPORT static DecodedImageCache& singleton();
+
+    static constexpr unsigned defaultCapacity = 64 * 1024 * 1024;
+
+    RefPtr<NativeImage> image(const DecodedImageCacheKey&);
+    void add(const DecodedImageCacheKey&, NativeImage&);
+    void didDraw(const DecodedImageCacheKey&);
+
+    unsigned capacity() const { return m_capacity; }
+    WEBCORE_EXPORT void setCapacity(unsigned);
+
+    // Called on memory pressure. Unreferenced images are the ones only this cache keeps alive.
+    WEBCORE_EXPORT void pruneUnreferencedImages();
+    WEBCORE_EXPORT void clear();
+
+    struct Statistics {
+        unsigned imageCount { 0 };
+        unsigned size { 0 };
+        uint64_t hitCount { 0 };
+        uint64_t missCount { 0 };
+        uint64_t evictionCount { 0 };
+    };
+    WEBCORE_EXPORT Statistics statistics() const;
+    WEBCORE_EXPORT void resetStatistics();
+
+private:
+    friend NeverDestroyed<DecodedImageCache>;
+    DecodedImageCache() = default;
+
+    struct Entry {
+        RefPtr<NativeImage> image;
+        unsigned size { 0 };
+        MonotonicTime lastUseTime;
+    };
+
+    void pruneToSize(unsigned);
+
+    HashMap<DecodedImageCacheKey, Entry, DecodedImageCacheKeyHash, DecodedImageCacheKeyHashTraits> m_entries;
+    unsigned m_capacity { defaultCapacity };
+    unsigned m_size { 0 };
+    uint64_t m_hitCount { 0 };
+    uint64_t m_missCount { 0 };
+    uint64_t m_evictionCount { 0 };
+};
+
+} // namespace WebCore
@@ -52,6 +52,13 @@ public:
         return std::unique_ptr<ImageBackingStore>(new ImageBackingStore(other));
     }
 
+    static std::unique_ptr<ImageBackingStore> create(const ImageBackingStore& other, const IntRect& rect)
+    {
+        if (rect.isEmpty() || !other.inBounds(rect))
+            return nullptr;
+        return std::unique_ptr<ImageBackingStore>(new ImageBackingStore(other, rect));
+    }
+
     PlatformImagePtr image() const;
 
     bool setSize(const IntSize& size)
@@ -147,6 +154,12 @@ public:
         setPixel(pixelAt(x, y), r, g, b, a);
     }
 
+    // Write width pixels starting at dest from packed 8-bit RGB, RGBA or gray samples, as
+    // setPixel() would one pixel at a time. RGB and gray pixels are opaque.
+    void setRGBRow(uint32_t* dest, const uint8_t* source, unsigned width);
+    void setRGBARow(uint32_t* dest, const uint8_t* source, unsigned width);
+    void setGrayRow(uint32_t* dest, const uint8_t* source, unsigned width);
+
     void blendPixel(uint32_t* dest, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
     {
         if (!a)
@@ -211,6 +224,17 @@ private:
         m_pixelsPtr = reinterpret_cast<uint32_t*>(const_cast<char*>(m_pixels->data()));
     }
 
+    ImageBackingStore(const ImageBackingStore& other, const IntRect& rect)
+        : m_premultiplyAlpha(other.m_premultiplyAlpha)
+    {
+        if (!setSize(rect.size()))
+            return;
+
+        size_t rowBytes = rect.width() * sizeof(uint32_t);
+        for (int y = 0; y < rect.height(); ++y)
+            memcpy(pixelAt(0, y), other.pixelAt(rect.x(), rect.y() + y), rowBytes);
+    }
+
     bool inBounds(const IntPoint& point) const
     {
         return IntRect(IntPoint(), m_size).contains(point);
@@ -29,10 +29,12 @@
 #include "ImageOrientation.h"
 #include "ImageTypes.h"
 #include "IntPoint.h"
+#include "IntRect.h"
 #include "IntSize.h"
 #include "PlatformImage.h"
 #include <wtf/Optional.h>
 #include <wtf/Seconds.h>
+#include <wtf/Vector.h>
 #include <wtf/text/WTFString.h>
 #include <wtf/ThreadSafeRefCounted.h>
 
@@ -81,6 +83,16 @@ public:
 
     virtual PlatformImagePtr createFrameImageAtIndex(size_t, SubsamplingLevel = SubsamplingLevel::Default, const DecodingOptions& = DecodingOptions(DecodingMode::Synchronous)) = 0;
 
+    // Region decoding decodes only part of a still image, so that an image too large to decode
+    // whole can be drawn a piece at a time. regionDownscaleFactor() returns the largest factor,
+    // no larger than maximumFactor, that the decoder can divide a region by while decoding it.
+    // createRegionImages() decodes rect divided by downscaleFactor, and returns an image, or
+    // null, for each of tileRects, which are inside rect. All rects are in image coordinates and
+    // start at multiples of downscaleFactor.
+    virtual bool supportsRegionDecoding() const { return false; }
+    virtual unsigned regionDownscaleFactor(unsigned /* maximumFactor */) const { return 1; }
+    virtual Vector<PlatformImagePtr> createRegionImages(const IntRect& /* rect */, unsigned /* downscaleFactor */, const Vector<IntRect>& /* tileRects */) { return { }; }
+
     virtual void setExpectedContentSize(long long) { }
     virtual void setData(SharedBuffer&, bool allDataReceived) = 0;
     virtual bool isAllDataReceived() const = 0;
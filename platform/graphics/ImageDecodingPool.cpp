@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ImageDecodingPool.h"
+
+#include "Logging.h"
+#include <wtf/NumberOfCores.h>
+
+namespace WebCore {
+
+// Decoding is memory bound enough that more threads than this mostly compete with the main thread.
+static const unsigned maximumDecodingThreadCount = 4;
+
+ImageDecodingPool& ImageDecodingPool::singleton()
+{
+    static NeverDestroyed<ImageDecodingPool> pool;
+    return pool;
+}
+
+static unsigned decodingThreadCount()
+{
+    // Leave a core for the main thread.
+    int cores = WTF::numberOfProcessorCores();
+    return std::max(1u, std::min(static_cast<unsigned>(std::max(cores - 1, 1)), maximumDecodingThreadCount));
+}
+
+ImageDecodingPool::ImageDecodingPool()
+    : m_workerPool(WorkerPool::create("org.webkit.ImageDecoder"_s, decodingThreadCount()))
+{
+}
+
+uint64_t ImageDecodingPool::Queue::dispatch(ImageDecodingPriority priority, Function<void()>&& function)
+{
+    auto& pool = ImageDecodingPool::singleton();
+    uint64_t identifier;
+    {
+        auto locker = holdLock(pool.m_lock);
+        identifier = pool.m_nextTaskIdentifier++;
+        // A queue that is running is put back in the list by runTasks() when its task finishes.
+        if (m_pendingTasks.isEmpty() && !m_isRunning)
+            pool.m_queuesWithPendingTasks.append(makeRef(*this));
+        m_pendingTasks.append({ identifier, priority, MonotonicTime::now(), WTFMove(function) });
+        ++pool.m_pendingTaskCount;
+    }
+
+    // Each posted job runs whatever is most urgent when a thread picks it up, not necessarily
+    // this task.
+    pool.m_workerPool->postTask([&pool] {
+        pool.runTasks();
+    });
+    return identifier;
+}
+
+bool ImageDecodingPool::Queue::raisePriorityOfPendingTask(uint64_t identifier, ImageDecodingPriority priority)
+{
+    auto& pool = ImageDecodingPool::singleton();
+    auto locker = holdLock(pool.m_lock);
+    for (auto& task : m_pendingTasks) {
+        if (task.identifier == identifier) {
+            task.priority = std::max(task.priority, priority);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ImageDecodingPool::Queue::cancel()
+{
+    auto& pool = ImageDecodingPool::singleton();
+    Deque<Task> cancelledTasks;
+    {
+        auto locker = holdLock(pool.m_lock);
+        if (m_pendingTasks.isEmpty())
+            return;
+
+        pool.m_pendingTaskCount -= m_pendingTasks.size();
+        pool.m_cancelledTaskCount += m_pendingTasks.size();
+        cancelledTasks = WTFMove(m_pendingTasks);
+        pool.m_queuesWithPendingTasks.removeFirstMatching([this](auto& queue) {
+            return queue.ptr() == this;
+        });
+    }
+    // The tasks hold references that have to be released outside the lock.
+}
+
+RefPtr<ImageDecodingPool::Queue> ImageDecodingPool::takeMostUrgentQueue()
+{
+    ASSERT(m_lock.isHeld());
+    if (m_queuesWithPendingTasks.isEmpty())
+        return nullptr;
+
+    // Tasks run in order, but a queue is as urgent as its most urgent task, and has waited as long
+    // as its first task.
+    struct Urgency {
+        ImageDecodingPriority priority;
+        MonotonicTime enqueueTime;
+        bool operator>(const Urgency& other) const
+        {
+            if (priority != other.priority)
+                return priority > other.priority;
+            return enqueueTime < other.enqueueTime;
+        }
+    };
+
+    auto urgency = [](const Queue& queue) {
+        Urgency urgency { queue.m_pendingTasks.first().priority, queue.m_pendingTasks.first().enqueueTime };
+        for (auto& task : queue.m_pendingTasks)
+            urgency.priority = std::max(urgency.priority, task.priority);
+        return urgency;
+    };
+
+    size_t mostUrgentIndex = 0;
+    auto mostUrgent = urgency(m_queuesWithPendingTasks[0]);
+    for (size_t i = 1; i < m_queuesWithPendingTasks.size(); ++i) {
+        auto queueUrgency = urgency(m_queuesWithPendingTasks[i]);
+        if (queueUrgency > mostUrgent) {
+            mostUrgent = queueUrgency;
+            mostUrgentIndex = i;
+        }
+    }
+
+    auto queue = m_queuesWithPendingTasks[mostUrgentIndex].copyRef();
+    m_queuesWithPendingTasks.remove(mostUrgentIndex);
+    return queue;
+}
+
+void ImageDecodingPool::runTasks()
+{
+    while (true) {
+        RefPtr<Queue> queue;
+        Function<void()> function;
+        MonotonicTime startTime;
+        {
+            auto locker = holdLock(m_lock);
+            queue = takeMostUrgentQueue();
+            if (!queue)
+                return;
+
+            auto task = queue->m_pendingTasks.takeFirst();
+            queue->m_isRunning = true;
+            --m_pendingTaskCount;
+            ++m_runningTaskCount;
+            startTime = MonotonicTime::now();
+            m_totalQueueLatency += startTime - task.enqueueTime;
+            function = WTFMove(task.function);
+        }
+
+        function();
+        function = nullptr;
+
+        auto locker = holdLock(m_lock);
+        queue->m_isRunning = false;
+        if (!queue->m_pendingTasks.isEmpty())
+            m_queuesWithPendingTasks.append(queue.releaseNonNull());
+        --m_runningTaskCount;
+        ++m_completedTaskCount;
+        m_totalDecodingDuration += MonotonicTime::now() - startTime;
+
+        LOG(Images, "ImageDecodingPool::%s - pending: %u running: %u average latency: %.2fms average duration: %.2fms", __FUNCTION__, m_pendingTaskCount, m_runningTaskCount, (m_totalQueueLatency / m_completedTaskCount).milliseconds(), (m_totalDecodingDuration / m_completedTaskCount).milliseconds());
+    }
+}
+
+auto ImageDecodingPool::metrics() const -> Metrics
+{
+    auto locker = holdLock(m_lock);
+    Metrics metrics;
+    metrics.pendingTaskCount = m_pendingTaskCount;
+    metrics.runningTaskCount = m_runningTaskCount;
+    metrics.completedTaskCount = m_completedTaskCount;
+    metrics.cancelledTaskCount = m_cancelledTaskCount;
+    if (m_completedTaskCount) {
+        metrics.averageQueueLatency = m_totalQueueLatency / m_completedTaskCount;
+        metrics.averageDecodingDuration = m_totalDecodingDuration / m_completedTaskCount;
+    }
+    return metrics;
+}
+
+} // namespace WebCore
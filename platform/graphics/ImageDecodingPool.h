@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/Deque.h>
+#include <wtf/Function.h>
+#include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/Vector.h>
+#include <wtf/WorkerPool.h>
+
+namespace WebCore {
+
+enum class ImageDecodingPriority : uint8_t {
+    NextAnimationFrame,
+    Visible,
+    DecodePromise,
+};
+
+// Decodes the frames of all images on one bounded set of threads. Each image decodes through its
+// own Queue, whose tasks run one at a time and in order, because decoders are not thread safe
+// and ImageSource commits the decoded frames in the order it requested them. Among the queues
+// with pending tasks, the one whose most urgent task has the highest priority runs first, and the
+// one waiting the longest among equals.
+class ImageDecodingPool {
+    WTF_MAKE_NONCOPYABLE(ImageDecodingPool);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    WEBCORE_EXPORT static ImageDecodingPool& singleton();
+
+    class Queue : public ThreadSafeRefCounted<Queue> {
+    public:
+        static Ref<Queue> create() { return adoptRef(*new Queue); }
+
+        // Returns an identifier that can be used to raise the priority of the task while it is pending.
+        uint64_t dispatch(ImageDecodingPriority, Function<void()>&&);
+
+        // Returns false if the task has started or was cancelled.
+        bool raisePriorityOfPendingTask(uint64_t identifier, ImageDecodingPriority);
+
+        // Drops the pending tasks. A task that is running finishes.
+        void cancel();
+
+    private:
+        friend class ImageDecodingPool;
+        Queue() = default;
+
+        struct Task {
+            uint64_t identifier;
+            ImageDecodingPriority priority;
+            MonotonicTime enqueueTime;
+            Function<void()> function;
+        };
+
+        Deque<Task> m_pendingTasks;
+        bool m_isRunning { false };
+    };
+
+    struct Metrics {
+        unsigned pendingTaskCount { 0 };
+        unsigned runningTaskCount { 0 };
+        uint64_t completedTaskCount { 0 };
+        uint64_t cancelledTaskCount { 0 };
+        Seconds averageQueueLatency;
+        Seconds averageDecodingDuration;
+    };
+    WEBCORE_EXPORT Metrics metrics() const;
+
+private:
+    friend NeverDestroyed<ImageDecodingPool>;
+    ImageDecodingPool();
+
+    void runTasks();
+    RefPtr<Queue> takeMostUrgentQueue();
+
+    Ref<WorkerPool> m_workerPool;
+
+    mutable Lock m_lock;
+    Vector<Ref<Queue>> m_queuesWithPendingTasks;
+    uint64_t m_nextTaskIdentifier { 1 };
+    unsigned m_pendingTaskCount { 0 };
+    unsigned m_runningTaskCount { 0 };
+    uint64_t m_completedTaskCount { 0 };
+    uint64_t m_cancelledTaskCount { 0 };
+    Seconds m_totalQueueLatency;
+    Seconds m_totalDecodingDuration;
+};
+
+} // namespace WebCore
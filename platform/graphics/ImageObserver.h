@@ -26,6 +26,7 @@
 #pragma once
 
 #include "ImageTypes.h"
+#include <wtf/text/WTFString.h>
 
 namespace WebCore {
 
@@ -42,6 +43,10 @@ public:
     virtual String mimeType() const = 0;
     virtual long long expectedContentLength() const = 0;
 
+    // Identifies the encoded data of the image, for sharing its decoded frames with other images
+    // made from the same data. Images with no identifier don't share them.
+    virtual String decodedImageCacheIdentifier() const { return { }; }
+
     virtual void encodedDataStatusChanged(const Image&, EncodedDataStatus) { };
     virtual void decodedSizeChanged(const Image&, long long delta) = 0;
 
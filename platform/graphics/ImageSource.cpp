@@ -134,10 +134,19 @@ void ImageSource::destroyDecodedData(size_t frameCount, size_t excludeFrame)
             continue;
         decodedSize += m_frames[index].clearImage();
     }
+    decodedSize += destroyRegionTiles();
 
     decodedSizeReset(decodedSize);
 }
 
+unsigned ImageSource::destroyRegionTiles()
+{
+    unsigned decodedSize = m_regionTilesDecodedSize;
+    m_regionTiles.clear();
+    m_regionTilesDecodedSize = 0;
+    return decodedSize;
+}
+
 void ImageSource::destroyIncompleteDecodedData()
 {
     unsigned decodedSize = 0;
@@ -281,6 +290,12 @@ void ImageSource::cacheMetadataAtIndex(size_t index, SubsamplingLevel subsamplin
 }
 
 void ImageSource::cachePlatformImageAtIndex(PlatformImagePtr&& platformImage, size_t index, SubsamplingLevel subsamplingLevel, const DecodingOptions& decodingOptions, DecodingStatus decodingStatus)
+{
+    cacheNativeImageAtIndex(NativeImage::create(WTFMove(platformImage)), index, subsamplingLevel, decodingOptions, decodingStatus);
+    addNativeImageToDecodedImageCache(index, subsamplingLevel);
+}
+
+void ImageSource::cacheNativeImageAtIndex(RefPtr<NativeImage>&& nativeImage, size_t index, SubsamplingLevel subsamplingLevel, const DecodingOptions& decodingOptions, DecodingStatus decodingStatus)
 {
     ASSERT(index < m_frames.size());
     ImageFrame& frame = m_frames[index];
@@ -289,12 +304,12 @@ void ImageSource::cachePlatformImageAtIndex(PlatformImagePtr&& platformImage, si
     decodedSizeDecreased(frame.clear());
 
     // Do not cache the NativeImage if adding its frameByes to the MemoryCache will cause numerical overflow.
-    size_t frameBytes = size().unclampedArea() * sizeof(uint32_t);
+    size_t frameBytes = (nativeImage ? nativeImage->size() : size()).unclampedArea() * sizeof(uint32_t);
     if (!isInBounds<unsigned>(frameBytes + decodedSize()))
         return;
 
     // Move the new image to the cache.
-    frame.m_nativeImage = NativeImage::create(WTFMove(platformImage));
+    frame.m_nativeImage = WTFMove(nativeImage);
     frame.m_decodingOptions = decodingOptions;
     cacheMetadataAtIndex(index, subsamplingLevel, decodingStatus);
 
@@ -302,6 +317,57 @@ void ImageSource::cachePlatformImageAtIndex(PlatformImagePtr&& platformImage, si
     decodedSizeIncreased(frame.frameBytes());
 }
 
+Optional<DecodedImageCacheKey> ImageSource::decodedImageCacheKey(size_t index, SubsamplingLevel subsamplingLevel)
+{
+    // Only whole, full-size frames of still images are shared.
+    if (index || subsamplingLevel != SubsamplingLevel::Default || !isMainThread() || !m_image || !m_image->imageObserver() || frameCount() != 1)
+        return WTF::nullopt;
+
+    String identifier = m_image->imageObserver()->decodedImageCacheIdentifier();
+    if (identifier.isEmpty())
+        return WTF::nullopt;
+
+    return DecodedImageCacheKey { identifier, size(ImageOrientation::None), m_alphaOption, m_gammaAndColorProfileOption };
+}
+
+bool ImageSource::cacheNativeImageFromDecodedImageCache(size_t index, SubsamplingLevel subsamplingLevel)
+{
+    auto key = decodedImageCacheKey(index, subsamplingLevel);
+    if (!key)
+        return false;
+
+    auto nativeImage = DecodedImageCache::singleton().image(*key);
+    if (!nativeImage)
+        return false;
+
+    LOG(Images, "ImageSource::%s - %p - url: %s [frame %ld is shared from the decoded image cache]", __FUNCTION__, this, sourceURL().string().utf8().data(), index);
+    bool hasAlpha = nativeImage->hasAlpha();
+    cacheNativeImageAtIndex(WTFMove(nativeImage), index, subsamplingLevel, DecodingOptions(DecodingMode::Synchronous), DecodingStatus::Complete);
+    m_frames[index].m_hasAlpha = hasAlpha;
+    m_decodedImageCacheKey = WTFMove(key);
+    return true;
+}
+
+void ImageSource::addNativeImageToDecodedImageCache(size_t index, SubsamplingLevel subsamplingLevel)
+{
+    auto& frame = m_frames[index];
+    if (!frame.isComplete() || !frame.hasNativeImage())
+        return;
+
+    auto key = decodedImageCacheKey(index, subsamplingLevel);
+    if (!key || frame.nativeImage()->size() != key->size)
+        return;
+
+    DecodedImageCache::singleton().add(*key, *frame.nativeImage());
+    m_decodedImageCacheKey = WTFMove(key);
+}
+
+void ImageSource::didDrawFrameAtIndex(size_t index)
+{
+    if (!index && m_decodedImageCacheKey)
+        DecodedImageCache::singleton().didDraw(*m_decodedImageCacheKey);
+}
+
 void ImageSource::cachePlatformImageAtIndexAsync(PlatformImagePtr&& platformImage, size_t index, SubsamplingLevel subsamplingLevel, const DecodingOptions& decodingOptions, DecodingStatus decodingStatus)
 {
     if (!isDecoderAvailable())
@@ -318,22 +384,6 @@ void ImageSource::cachePlatformImageAtIndexAsync(PlatformImagePtr&& platformImag
         m_image->imageFrameAvailableAtIndex(index);
 }
 
-WorkQueue& ImageSource::decodingQueue()
-{
-    if (!m_decodingQueue)
-        m_decodingQueue = WorkQueue::create("org.webkit.ImageDecoder", WorkQueue::Type::Serial, WorkQueue::QOS::Default);
-
-    return *m_decodingQueue;
-}
-
-ImageSource::FrameRequestQueue& ImageSource::frameRequestQueue()
-{
-    if (!m_frameRequestQueue)
-        m_frameRequestQueue = FrameRequestQueue::create();
-
-    return *m_frameRequestQueue;
-}
-
 bool ImageSource::canUseAsyncDecoding()
 {
     if (!isDecoderAvailable())
@@ -350,60 +400,77 @@ void ImageSource::startAsyncDecodingQueue()
     // Async decoding is only enabled for HTMLImageElement and CSS background images.
     ASSERT(isMainThread());
 
-    // We need to protect this, m_decodingQueue and m_decoder from being deleted while we are in the decoding loop.
-    decodingQueue().dispatch([protectedThis = makeRef(*this), protectedDecodingQueue = makeRef(decodingQueue()), protectedFrameRequestQueue = makeRef(frameRequestQueue()), protectedDecoder = makeRef(*m_decoder), sourceURL = sourceURL().string().isolatedCopy()] () mutable {
-        ImageFrameRequest frameRequest;
-        Seconds minDecodingDuration = protectedThis->frameDecodingDurationForTesting();
-
-        while (protectedFrameRequestQueue->dequeue(frameRequest)) {
-            TraceScope tracingScope(AsyncImageDecodeStart, AsyncImageDecodeEnd);
-
-            MonotonicTime startingTime;
-            if (minDecodingDuration > 0_s)
-                startingTime = MonotonicTime::now();
-
-            // Get the frame NativeImage on the decoding thread.
-            auto platformImage = protectedDecoder->createFrameImageAtIndex(frameRequest.index, frameRequest.subsamplingLevel, frameRequest.decodingOptions);
-            if (platformImage)
-                LOG(Images, "ImageSource::%s - %p - url: %s [frame %ld has been decoded]", __FUNCTION__, protectedThis.ptr(), sourceURL.utf8().data(), frameRequest.index);
-            else {
-                LOG(Images, "ImageSource::%s - %p - url: %s [decoding for frame %ld has failed]", __FUNCTION__, protectedThis.ptr(), sourceURL.utf8().data(), frameRequest.index);
-                continue;
-            }
-
-            // Pretend as if the decoding takes minDecodingDuration.
-            if (minDecodingDuration > 0_s)
-                sleep(minDecodingDuration - (MonotonicTime::now() - startingTime));
-
-            // Update the cached frames on the creation thread to avoid updating the MemoryCache from a different thread.
-            callOnMainThread([protectedThis, protectedDecodingQueue, protectedDecoder, sourceURL = sourceURL.isolatedCopy(), platformImage = WTFMove(platformImage), frameRequest] () mutable {
-                // The queue may have been closed if after we got the frame NativeImage, stopAsyncDecodingQueue() was called.
-                if (protectedDecodingQueue.ptr() == protectedThis->m_decodingQueue && protectedDecoder.ptr() == protectedThis->m_decoder) {
-                    ASSERT(protectedThis->m_frameCommitQueue.first() == frameRequest);
-                    protectedThis->m_frameCommitQueue.removeFirst();
-                    protectedThis->cachePlatformImageAtIndexAsync(WTFMove(platformImage), frameRequest.index, frameRequest.subsamplingLevel, frameRequest.decodingOptions, frameRequest.decodingStatus);
-                } else
-                    LOG(Images, "ImageSource::%s - %p - url: %s [frame %ld will not cached]", __FUNCTION__, protectedThis.ptr(), sourceURL.utf8().data(), frameRequest.index);
-            });
-        }
-
-        // Ensure destruction happens on creation thread.
-        callOnMainThread([protectedThis = WTFMove(protectedThis), protectedQueue = WTFMove(protectedDecodingQueue), protectedDecoder = WTFMove(protectedDecoder)] () mutable { });
-    });
+    // The queue runs the requests of this image one at a time, in order, on the threads shared by all images.
+    m_decodingQueue = ImageDecodingPool::Queue::create();
 }
 
-void ImageSource::requestFrameAsyncDecodingAtIndex(size_t index, SubsamplingLevel subsamplingLevel, const Optional<IntSize>& sizeForDrawing)
+void ImageSource::requestFrameAsyncDecodingAtIndex(size_t index, SubsamplingLevel subsamplingLevel, const Optional<IntSize>& sizeForDrawing, ImageDecodingPriority priority)
 {
     ASSERT(isDecoderAvailable());
+
+    // Another image already decoded the frame. It is reported available asynchronously, like a
+    // decoded frame.
+    if (cacheNativeImageFromDecodedImageCache(index, subsamplingLevel)) {
+        callOnMainThread([protectedThis = makeRef(*this), index] {
+            if (protectedThis->m_image)
+                protectedThis->m_image->imageFrameAvailableAtIndex(index);
+        });
+        return;
+    }
+
     if (!hasAsyncDecodingQueue())
         startAsyncDecodingQueue();
 
     ASSERT(index < m_frames.size());
     DecodingStatus decodingStatus = m_decoder->frameIsCompleteAtIndex(index) ? DecodingStatus::Complete : DecodingStatus::Partial;
+    ImageFrameRequest frameRequest { index, subsamplingLevel, sizeForDrawing, decodingStatus };
+
+    // An identical request that has not started yet will produce the same frame; only make it more urgent.
+    for (auto& pendingRequest : m_frameCommitQueue) {
+        if (pendingRequest == frameRequest && m_decodingQueue->raisePriorityOfPendingTask(pendingRequest.taskIdentifier, priority)) {
+            LOG(Images, "ImageSource::%s - %p - url: %s [frame %ld is already waiting for decoding]", __FUNCTION__, this, sourceURL().string().utf8().data(), index);
+            return;
+        }
+    }
 
     LOG(Images, "ImageSource::%s - %p - url: %s [enqueuing frame %ld for decoding]", __FUNCTION__, this, sourceURL().string().utf8().data(), index);
-    m_frameRequestQueue->enqueue({ index, subsamplingLevel, sizeForDrawing, decodingStatus });
-    m_frameCommitQueue.append({ index, subsamplingLevel, sizeForDrawing, decodingStatus });
+
+    // We need to protect this, m_decodingQueue and m_decoder from being deleted while the frame is decoded.
+    frameRequest.taskIdentifier = m_decodingQueue->dispatch(priority, [protectedThis = makeRef(*this), protectedDecodingQueue = makeRef(*m_decodingQueue), protectedDecoder = makeRef(*m_decoder), sourceURL = sourceURL().string().isolatedCopy(), frameRequest] () mutable {
+        TraceScope tracingScope(AsyncImageDecodeStart, AsyncImageDecodeEnd);
+
+        Seconds minDecodingDuration = protectedThis->frameDecodingDurationForTesting();
+        MonotonicTime startingTime;
+        if (minDecodingDuration > 0_s)
+            startingTime = MonotonicTime::now();
+
+        // Get the frame NativeImage on the decoding thread.
+        auto platformImage = protectedDecoder->createFrameImageAtIndex(frameRequest.index, frameRequest.subsamplingLevel, frameRequest.decodingOptions);
+        if (platformImage)
+            LOG(Images, "ImageSource::%s - %p - url: %s [frame %ld has been decoded]", __FUNCTION__, protectedThis.ptr(), sourceURL.utf8().data(), frameRequest.index);
+        else
+            LOG(Images, "ImageSource::%s - %p - url: %s [decoding for frame %ld has failed]", __FUNCTION__, protectedThis.ptr(), sourceURL.utf8().data(), frameRequest.index);
+
+        // Pretend as if the decoding takes minDecodingDuration.
+        if (platformImage && minDecodingDuration > 0_s)
+            sleep(minDecodingDuration - (MonotonicTime::now() - startingTime));
+
+        // Update the cached frames on the creation thread to avoid updating the MemoryCache from a different thread.
+        // This also ensures the references are released on the creation thread.
+        callOnMainThread([protectedThis = WTFMove(protectedThis), protectedDecodingQueue = WTFMove(protectedDecodingQueue), protectedDecoder = WTFMove(protectedDecoder), sourceURL = sourceURL.isolatedCopy(), platformImage = WTFMove(platformImage), frameRequest] () mutable {
+            // The queue may have been closed if after we got the frame NativeImage, stopAsyncDecodingQueue() was called.
+            if (protectedDecodingQueue.ptr() != protectedThis->m_decodingQueue || protectedDecoder.ptr() != protectedThis->m_decoder) {
+                LOG(Images, "ImageSource::%s - %p - url: %s [frame %ld will not cached]", __FUNCTION__, protectedThis.ptr(), sourceURL.utf8().data(), frameRequest.index);
+                return;
+            }
+
+            ASSERT(protectedThis->m_frameCommitQueue.first() == frameRequest);
+            protectedThis->m_frameCommitQueue.removeFirst();
+            if (platformImage)
+                protectedThis->cachePlatformImageAtIndexAsync(WTFMove(platformImage), frameRequest.index, frameRequest.subsamplingLevel, frameRequest.decodingOptions, frameRequest.decodingStatus);
+        });
+    });
+    m_frameCommitQueue.append(frameRequest);
 }
 
 bool ImageSource::isAsyncDecodingQueueIdle() const
@@ -424,12 +491,11 @@ void ImageSource::stopAsyncDecodingQueue()
         }
     });
 
-    // Close m_frameRequestQueue then set it to nullptr. A new decoding thread might start and a
-    // new m_frameRequestQueue will be created. So the terminating thread will not have access to it.
-    m_frameRequestQueue->close();
-    m_frameRequestQueue = nullptr;
-    m_frameCommitQueue.clear();
+    // Drop the requests that have not started, so they don't hold up other images. A request
+    // that is being decoded finishes, but its frame is not cached since m_decodingQueue changes.
+    m_decodingQueue->cancel();
     m_decodingQueue = nullptr;
+    m_frameCommitQueue.clear();
     LOG(Images, "ImageSource::%s - %p - url: %s [decoding has been stopped]", __FUNCTION__, this, sourceURL().string().utf8().data());
 }
 
@@ -454,6 +520,8 @@ const ImageFrame& ImageSource::frameAtIndexCacheIfNeeded(size_t index, ImageFram
         // Cache the image and retrieve the metadata from ImageDecoder only if there was not valid image stored.
         if (frame.hasFullSizeNativeImage(subsamplingLevel))
             break;
+        if (cacheNativeImageFromDecodedImageCache(index, subsamplingLevelValue))
+            break;
         // We have to perform synchronous image decoding in this code.
         auto platformImage = m_decoder->createFrameImageAtIndex(index, subsamplingLevelValue);
         // Clean the old native image and set a new one.
@@ -715,6 +783,114 @@ RefPtr<NativeImage> ImageSource::frameImageAtIndexCacheIfNeeded(size_t index, Su
     return frameMetadataAtIndexCacheIfNeeded<RefPtr<NativeImage>>(index, (&ImageFrame::nativeImage), nullptr, ImageFrame::Caching::MetadataAndImage, subsamplingLevel);
 }
 
+// Tiles are this many decoded pixels wide and high, whatever the downscale factor.
+static const int regionTileSize = 512;
+
+// The tiles drawn most recently are kept up to this many bytes, and so are all the tiles the
+// last draw needed. Those only cover the part of the image inside its clip, so the memory is
+// bounded by about the area shown.
+static const unsigned maximumRegionTilesDecodedSize = 32 * 1024 * 1024;
+
+// Smaller images are decoded whole, as one frame.
+static const uint64_t minimumRegionDecodingArea = 8192 * 8192;
+
+static unsigned regionTileBytes(const ImageSource::RegionTile& tile)
+{
+    return (tile.image->size().area() * 4).unsafeGet();
+}
+
+bool ImageSource::usesRegionDecoding()
+{
+    // Decoding a region skips most of the data, so it waits until all of it is there.
+    if (!isDecoderAvailable() || !isAllDataReceived() || frameCount() != 1)
+        return false;
+
+    IntSize imageSize = size(ImageOrientation::None);
+    if (static_cast<uint64_t>(imageSize.width()) * imageSize.height() < minimumRegionDecodingArea)
+        return false;
+
+    return orientation() == ImageOrientation::None && m_decoder->supportsRegionDecoding();
+}
+
+Vector<ImageSource::RegionTile> ImageSource::regionTilesForDrawing(const FloatRect& srcRect, const FloatSize& scaleFactorForDrawing)
+{
+    ASSERT(usesRegionDecoding());
+
+    IntRect imageRect({ }, size(ImageOrientation::None));
+    IntRect rect = intersection(enclosingIntRect(srcRect), imageRect);
+    if (rect.isEmpty())
+        return { };
+
+    float scale = std::max(scaleFactorForDrawing.width(), scaleFactorForDrawing.height());
+    unsigned maximumFactor = scale > 0 && scale < 1 ? static_cast<unsigned>(1 / scale) : 1;
+    unsigned downscaleFactor = m_decoder->regionDownscaleFactor(maximumFactor);
+    int tileSize = regionTileSize * downscaleFactor;
+
+    // Move the cached tiles the draw needs to the end, and collect the ones it is missing into
+    // bands of tiles next to each other in the same row.
+    struct MissingBand {
+        IntRect rect;
+        Vector<IntRect> tileRects;
+    };
+    Vector<RegionTile> tiles;
+    Vector<MissingBand> missingBands;
+    for (int y = rect.y() / tileSize * tileSize; y < rect.maxY(); y += tileSize) {
+        for (int x = rect.x() / tileSize * tileSize; x < rect.maxX(); x += tileSize) {
+            IntRect tileRect = intersection(IntRect(x, y, tileSize, tileSize), imageRect);
+            size_t index = m_regionTiles.findMatching([&](auto& tile) {
+                return tile.downscaleFactor == downscaleFactor && tile.sourceRect == tileRect;
+            });
+            if (index == notFound) {
+                if (!missingBands.isEmpty() && missingBands.last().rect.y() == tileRect.y() && missingBands.last().rect.maxX() == tileRect.x()) {
+                    missingBands.last().rect.unite(tileRect);
+                    missingBands.last().tileRects.append(tileRect);
+                } else
+                    missingBands.append({ tileRect, { tileRect } });
+                continue;
+            }
+
+            auto tile = WTFMove(m_regionTiles[index]);
+            m_regionTiles.remove(index);
+            tiles.append({ tile.sourceRect, tile.downscaleFactor, tile.image.copyRef() });
+            m_regionTiles.append(WTFMove(tile));
+        }
+    }
+
+    // The missing tiles of a band are decoded together, so the data above and left of them is
+    // only skipped once. Decoding a band never decodes a tile that is already cached, as the
+    // bounding rect of all the missing tiles would when they are scattered.
+    unsigned decodedSize = 0;
+    for (auto& band : missingBands) {
+        LOG(Images, "ImageSource::%s - %p - url: %s [decoding %zu region tiles at 1/%u]", __FUNCTION__, this, sourceURL().string().utf8().data(), band.tileRects.size(), downscaleFactor);
+        auto images = m_decoder->createRegionImages(band.rect, downscaleFactor, band.tileRects);
+        for (size_t i = 0; i < images.size(); ++i) {
+            auto image = NativeImage::create(WTFMove(images[i]));
+            if (!image)
+                continue;
+
+            RegionTile tile { band.tileRects[i], downscaleFactor, image.releaseNonNull() };
+            decodedSize += regionTileBytes(tile);
+            tiles.append({ tile.sourceRect, tile.downscaleFactor, tile.image.copyRef() });
+            m_regionTiles.append(WTFMove(tile));
+        }
+    }
+    if (decodedSize) {
+        m_regionTilesDecodedSize += decodedSize;
+        decodedSizeIncreased(decodedSize);
+    }
+
+    unsigned evictedSize = 0;
+    while (m_regionTilesDecodedSize > maximumRegionTilesDecodedSize && m_regionTiles.size() > tiles.size()) {
+        unsigned tileBytes = regionTileBytes(m_regionTiles.first());
+        m_regionTilesDecodedSize -= tileBytes;
+        evictedSize += tileBytes;
+        m_regionTiles.remove(0);
+    }
+    decodedSizeDecreased(evictedSize);
+
+    return tiles;
+}
+
 void ImageSource::dump(TextStream& ts)
 {
     ts.dumpProperty("type", filenameExtension());
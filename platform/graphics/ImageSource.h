@@ -25,19 +25,22 @@
 
 #pragma once
 
+#include "DecodedImageCache.h"
+#include "ImageDecodingPool.h"
 #include "ImageFrame.h"
+#include "IntRect.h"
 
 #include <wtf/Forward.h>
 #include <wtf/Optional.h>
 #include <wtf/RunLoop.h>
-#include <wtf/SynchronizedFixedQueue.h>
 #include <wtf/WeakPtr.h>
-#include <wtf/WorkQueue.h>
 #include <wtf/text/TextStream.h>
 
 namespace WebCore {
 
 class BitmapImage;
+class FloatRect;
+class FloatSize;
 class GraphicsContext;
 class ImageDecoder;
 class SharedBuffer;
@@ -79,7 +82,7 @@ public:
     // Asynchronous image decoding
     bool canUseAsyncDecoding();
     void startAsyncDecodingQueue();
-    void requestFrameAsyncDecodingAtIndex(size_t, SubsamplingLevel, const Optional<IntSize>& = { });
+    void requestFrameAsyncDecodingAtIndex(size_t, SubsamplingLevel, const Optional<IntSize>& = { }, ImageDecodingPriority = ImageDecodingPriority::Visible);
     void stopAsyncDecodingQueue();
     bool hasAsyncDecodingQueue() const { return m_decodingQueue; }
     bool isAsyncDecodingQueueIdle() const;
@@ -129,6 +132,17 @@ public:
     RefPtr<NativeImage> frameImageAtIndex(size_t);
     RefPtr<NativeImage> frameImageAtIndexCacheIfNeeded(size_t, SubsamplingLevel = SubsamplingLevel::Default);
 
+    // Images too large to decode whole are decoded in tiles, only where they are drawn and only
+    // at the scale they are drawn at. A tile covers sourceRect of the image, divided by
+    // downscaleFactor.
+    struct RegionTile {
+        IntRect sourceRect;
+        unsigned downscaleFactor;
+        Ref<NativeImage> image;
+    };
+    bool usesRegionDecoding();
+    Vector<RegionTile> regionTilesForDrawing(const FloatRect& srcRect, const FloatSize& scaleFactorForDrawing);
+
 private:
     ImageSource(BitmapImage*, AlphaOption = AlphaOption::Premultiplied, GammaAndColorProfileOption = GammaAndColorProfileOption::Applied);
     ImageSource(RefPtr<NativeImage>&&);
@@ -145,6 +159,8 @@ private:
     bool ensureDecoderAvailable(SharedBuffer* data);
     bool isDecoderAvailable() const { return m_decoder; }
     void destroyDecodedData(size_t frameCount, size_t excludeFrame);
+    void didDrawFrameAtIndex(size_t);
+    unsigned destroyRegionTiles();
     void decodedSizeChanged(long long decodedSize);
     void didDecodeProperties(unsigned decodedPropertiesSize);
     void decodedSizeIncreased(unsigned decodedSize);
@@ -156,11 +172,15 @@ private:
     void cacheMetadataAtIndex(size_t, SubsamplingLevel, DecodingStatus = DecodingStatus::Invalid);
     void cachePlatformImageAtIndex(PlatformImagePtr&&, size_t, SubsamplingLevel, const DecodingOptions&, DecodingStatus = DecodingStatus::Invalid);
     void cachePlatformImageAtIndexAsync(PlatformImagePtr&&, size_t, SubsamplingLevel, const DecodingOptions&, DecodingStatus);
+    void cacheNativeImageAtIndex(RefPtr<NativeImage>&&, size_t, SubsamplingLevel, const DecodingOptions&, DecodingStatus = DecodingStatus::Invalid);
+
+    // Decoded frames of still images are shared with the other images made from the same data.
+    Optional<DecodedImageCacheKey> decodedImageCacheKey(size_t, SubsamplingLevel);
+    bool cacheNativeImageFromDecodedImageCache(size_t, SubsamplingLevel);
+    void addNativeImageToDecodedImageCache(size_t, SubsamplingLevel);
 
     struct ImageFrameRequest;
     static const int BufferSize = 8;
-    WorkQueue& decodingQueue();
-    SynchronizedFixedQueue<ImageFrameRequest, BufferSize>& frameRequestQueue();
 
     const ImageFrame& frameAtIndexCacheIfNeeded(size_t, ImageFrame::Caching, const Optional<SubsamplingLevel>& = { });
 
@@ -175,22 +195,27 @@ private:
     unsigned m_decodedPropertiesSize { 0 };
     Vector<ImageFrame, 1> m_frames;
 
+    // The least recently drawn tile is first.
+    Vector<RegionTile> m_regionTiles;
+    unsigned m_regionTilesDecodedSize { 0 };
+
+    Optional<DecodedImageCacheKey> m_decodedImageCacheKey;
+
     // Asynchronous image decoding.
     struct ImageFrameRequest {
         size_t index;
         SubsamplingLevel subsamplingLevel;
         DecodingOptions decodingOptions;
         DecodingStatus decodingStatus;
+        uint64_t taskIdentifier { 0 };
         bool operator==(const ImageFrameRequest& other) const
         {
             return index == other.index && subsamplingLevel == other.subsamplingLevel && decodingOptions == other.decodingOptions && decodingStatus == other.decodingStatus;
         }
     };
-    using FrameRequestQueue = SynchronizedFixedQueue<ImageFrameRequest, BufferSize>;
     using FrameCommitQueue = Deque<ImageFrameRequest, BufferSize>;
-    RefPtr<FrameRequestQueue> m_frameRequestQueue;
     FrameCommitQueue m_frameCommitQueue;
-    RefPtr<WorkQueue> m_decodingQueue;
+    RefPtr<ImageDecodingPool::Queue> m_decodingQueue;
     Seconds m_frameDecodingDurationForTesting;
 
     // Image metadata.
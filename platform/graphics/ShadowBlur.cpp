@@ -36,10 +36,17 @@
 #include "ImageBuffer.h"
 #include "ImageData.h"
 #include "Timer.h"
+#include <wtf/MainThread.h>
 #include <wtf/MathExtras.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/Noncopyable.h>
-#include <wtf/Scope.h>
+#include <wtf/ParallelJobs.h>
+
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include <arm_neon.h>
+#endif
 
 namespace WebCore {
 
@@ -48,121 +55,100 @@ enum {
     RightLobe = 1
 };
 
-#if USE(CG)
-static inline int roundUpToMultipleOf32(int d)
-{
-    return (1 + (d >> 5)) << 5;
-}
-
-// ShadowBlur needs a scratch image as the buffer for the blur filter.
-// Instead of creating and destroying the buffer for every operation,
-// we create a buffer which will be automatically purged via a timer.
-class ScratchBuffer {
-    WTF_MAKE_FAST_ALLOCATED;
+// Blurring the nine-piece template is most of the cost of a tiled shadow, and pages tend to draw
+// many shadows that differ only in position and size, such as one box-shadow per card in a list.
+// Blurred and colored templates are kept here, keyed on everything that affects their pixels, and
+// purged by a timer once shadows stop being drawn.
+class ShadowTemplateCache {
+    WTF_MAKE_NONCOPYABLE(ShadowTemplateCache); WTF_MAKE_FAST_ALLOCATED;
 public:
-    ScratchBuffer()
-        : m_purgeTimer(*this, &ScratchBuffer::clearScratchBuffer)
-        , m_lastWasInset(false)
-#if ASSERT_ENABLED
-        , m_bufferInUse(false)
-#endif
+    struct Key {
+        bool isInset;
+        FloatSize blurRadius;
+        bool shadowsIgnoreTransforms;
+        Color color;
+        FloatRoundedRect::Radii radii;
+
+        bool operator==(const Key& other) const
+        {
+            return isInset == other.isInset && blurRadius == other.blurRadius && shadowsIgnoreTransforms == other.shadowsIgnoreTransforms
+                && color == other.color && radii == other.radii;
+        }
+    };
+
+    ShadowTemplateCache()
+        : m_purgeTimer(*this, &ShadowTemplateCache::clear)
     {
     }
 
-    ImageBuffer* getScratchBuffer(const IntSize& size)
+    RefPtr<ImageBuffer> templateForKey(const Key& key)
     {
-        ASSERT(!m_bufferInUse);
-#if ASSERT_ENABLED
-        m_bufferInUse = true;
-#endif
-        // We do not need to recreate the buffer if the current buffer is large enough.
-        if (m_imageBuffer && m_imageBuffer->logicalSize().width() >= size.width() && m_imageBuffer->logicalSize().height() >= size.height())
-            return m_imageBuffer.get();
-
-        // Round to the nearest 32 pixels so we do not grow the buffer for similar sized requests.
-        IntSize roundedSize(roundUpToMultipleOf32(size.width()), roundUpToMultipleOf32(size.height()));
-
-        clearScratchBuffer();
+        schedulePurge();
 
-        // ShadowBlur is not used with accelerated drawing, so it's OK to make an unconditionally unaccelerated buffer.
-        m_imageBuffer = ImageBuffer::create(roundedSize, RenderingMode::Unaccelerated, 1);
-        return m_imageBuffer.get();
+        auto index = m_templates.findMatching([&key](auto& entry) {
+            return entry.key == key;
+        });
+        if (index == notFound)
+            return nullptr;
+
+        // Keep the most recently used template last.
+        auto entry = WTFMove(m_templates[index]);
+        m_templates.remove(index);
+        m_templates.append(WTFMove(entry));
+        return m_templates.last().image;
     }
 
-    bool setCachedShadowValues(const FloatSize& radius, const Color& color, const FloatRect& shadowRect, const FloatRoundedRect::Radii& radii, const FloatSize& layerSize)
+    void addTemplate(const Key& key, ImageBuffer& image)
     {
-        if (!m_lastWasInset && m_lastRadius == radius && m_lastColor == color && m_lastShadowRect == shadowRect &&  m_lastRadii == radii && m_lastLayerSize == layerSize)
-            return false;
+        size_t bytes = image.memoryCost();
+        if (bytes > maximumBytes)
+            return;
 
-        m_lastWasInset = false;
-        m_lastRadius = radius;
-        m_lastColor = color;
-        m_lastShadowRect = shadowRect;
-        m_lastRadii = radii;
-        m_lastLayerSize = layerSize;
+        while (!m_templates.isEmpty() && (m_templates.size() == maximumTemplateCount || m_bytes + bytes > maximumBytes)) {
+            m_bytes -= m_templates.first().bytes;
+            m_templates.remove(0);
+        }
 
-        return true;
+        m_templates.append({ key, makeRefPtr(image), bytes });
+        m_bytes += bytes;
     }
 
-    bool setCachedInsetShadowValues(const FloatSize& radius, const Color& color, const FloatRect& bounds, const FloatRect& shadowRect, const FloatRoundedRect::Radii& radii)
-    {
-        if (m_lastWasInset && m_lastRadius == radius && m_lastColor == color && m_lastInsetBounds == bounds && shadowRect == m_lastShadowRect && radii == m_lastRadii)
-            return false;
+    static ShadowTemplateCache& singleton();
 
-        m_lastWasInset = true;
-        m_lastInsetBounds = bounds;
-        m_lastRadius = radius;
-        m_lastColor = color;
-        m_lastShadowRect = shadowRect;
-        m_lastRadii = radii;
+private:
+    static const size_t maximumTemplateCount = 64;
+    static const size_t maximumBytes = 4 * MB;
 
-        return true;
-    }
+    struct Entry {
+        Key key;
+        RefPtr<ImageBuffer> image;
+        size_t bytes;
+    };
 
-    void scheduleScratchBufferPurge()
+    void schedulePurge()
     {
-#if ASSERT_ENABLED
-        m_bufferInUse = false;
-#endif
-        if (m_purgeTimer.isActive())
-            m_purgeTimer.stop();
-
-        const Seconds scratchBufferPurgeInterval { 2_s };
-        m_purgeTimer.startOneShot(scratchBufferPurgeInterval);
+        const Seconds templateCachePurgeInterval { 2_s };
+        m_purgeTimer.startOneShot(templateCachePurgeInterval);
     }
 
-    static ScratchBuffer& singleton();
-
-private:
-    void clearScratchBuffer()
+    void clear()
     {
-        m_imageBuffer = nullptr;
-        m_lastRadius = FloatSize();
-        m_lastLayerSize = FloatSize();
+        m_templates.clear();
+        m_bytes = 0;
     }
 
-    RefPtr<ImageBuffer> m_imageBuffer;
+    Vector<Entry> m_templates;
+    size_t m_bytes { 0 };
     Timer m_purgeTimer;
-
-    FloatRect m_lastInsetBounds;
-    FloatRect m_lastShadowRect;
-    FloatRoundedRect::Radii m_lastRadii;
-    Color m_lastColor;
-    FloatSize m_lastRadius;
-    bool m_lastWasInset;
-    FloatSize m_lastLayerSize;
-
-#if ASSERT_ENABLED
-    bool m_bufferInUse;
-#endif
 };
 
-ScratchBuffer& ScratchBuffer::singleton()
+ShadowTemplateCache& ShadowTemplateCache::singleton()
 {
-    static NeverDestroyed<ScratchBuffer> scratchBuffer;
-    return scratchBuffer;
+    static NeverDestroyed<ShadowTemplateCache> cache;
+    return cache;
 }
 
+#if USE(CG)
 static float radiusToLegacyRadius(float radius)
 {
     return radius > 8 ? 8 + 4 * sqrt((radius - 8) / 2) : radius;
@@ -278,86 +264,234 @@ void ShadowBlur::clear()
     m_offset = FloatSize();
 }
 
-void ShadowBlur::blurLayerImage(unsigned char* imageData, const IntSize& size, int rowStride)
+// For each step, we blur the alpha in a channel and store the result in another channel for the subsequent step.
+static const int blurChannels[4] = { 3, 0, 1, 3 };
+
+// Blurs a single line, a row or a column, of pixels that are stride bytes apart.
+static void boxBlurLine(unsigned char* pixels, const int lobes[3][2], int dim, int stride)
 {
-    const int channels[4] = { 3, 0, 1, 3 };
+    for (int step = 0; step < 3; ++step) {
+        // We use sliding window algorithm to accumulate the alpha values.
+        // This is much more efficient than computing the sum of each pixels
+        // covered by the box kernel size for each x.
+        int side1 = lobes[step][LeftLobe];
+        int side2 = lobes[step][RightLobe];
+        int pixelCount = side1 + 1 + side2;
+        int invCount = ((1 << blurSumShift) + pixelCount - 1) / pixelCount;
+        int ofs = 1 + side2;
+        int alpha1 = pixels[blurChannels[step]];
+        int alpha2 = pixels[(dim - 1) * stride + blurChannels[step]];
+
+        unsigned char* ptr = pixels + blurChannels[step + 1];
+        unsigned char* prev = pixels + stride + blurChannels[step];
+        unsigned char* next = pixels + ofs * stride + blurChannels[step];
+
+        int i;
+        int sum = side1 * alpha1 + alpha1;
+        int limit = (dim < side2 + 1) ? dim : side2 + 1;
+
+        for (i = 1; i < limit; ++i, prev += stride)
+            sum += *prev;
+
+        if (limit <= side2)
+            sum += (side2 - limit + 1) * alpha2;
+
+        limit = (side1 < dim) ? side1 : dim;
+        for (i = 0; i < limit; ptr += stride, next += stride, ++i, ++ofs) {
+            *ptr = (sum * invCount) >> blurSumShift;
+            sum += ((ofs < dim) ? *next : alpha2) - alpha1;
+        }
 
-    int lobes[3][2]; // indexed by pass, and left/right lobe
-    calculateLobes(lobes, m_blurRadius.width(), m_shadowsIgnoreTransforms);
+        prev = pixels + blurChannels[step];
+        for (; ofs < dim; ptr += stride, prev += stride, next += stride, ++i, ++ofs) {
+            *ptr = (sum * invCount) >> blurSumShift;
+            sum += (*next) - (*prev);
+        }
 
-    // First pass is horizontal.
-    int stride = 4;
-    int delta = rowStride;
-    int final = size.height();
-    int dim = size.width();
-
-    // Two stages: horizontal and vertical
-    for (int pass = 0; pass < 2; ++pass) {
-        unsigned char* pixels = imageData;
-
-        if (!pass && !m_blurRadius.width())
-            final = 0; // Do no work if horizonal blur is zero.
-
-        for (int j = 0; j < final; ++j, pixels += delta) {
-            // For each step, we blur the alpha in a channel and store the result
-            // in another channel for the subsequent step.
-            // We use sliding window algorithm to accumulate the alpha values.
-            // This is much more efficient than computing the sum of each pixels
-            // covered by the box kernel size for each x.
-            for (int step = 0; step < 3; ++step) {
-                int side1 = lobes[step][LeftLobe];
-                int side2 = lobes[step][RightLobe];
-                int pixelCount = side1 + 1 + side2;
-                int invCount = ((1 << blurSumShift) + pixelCount - 1) / pixelCount;
-                int ofs = 1 + side2;
-                int alpha1 = pixels[channels[step]];
-                int alpha2 = pixels[(dim - 1) * stride + channels[step]];
-
-                unsigned char* ptr = pixels + channels[step + 1];
-                unsigned char* prev = pixels + stride + channels[step];
-                unsigned char* next = pixels + ofs * stride + channels[step];
-
-                int i;
-                int sum = side1 * alpha1 + alpha1;
-                int limit = (dim < side2 + 1) ? dim : side2 + 1;
-
-                for (i = 1; i < limit; ++i, prev += stride)
-                    sum += *prev;
-
-                if (limit <= side2)
-                    sum += (side2 - limit + 1) * alpha2;
-
-                limit = (side1 < dim) ? side1 : dim;
-                for (i = 0; i < limit; ptr += stride, next += stride, ++i, ++ofs) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += ((ofs < dim) ? *next : alpha2) - alpha1;
-                }
-
-                prev = pixels + channels[step];
-                for (; ofs < dim; ptr += stride, prev += stride, next += stride, ++i, ++ofs) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += (*next) - (*prev);
-                }
-
-                for (; i < dim; ptr += stride, prev += stride, ++i) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += alpha2 - (*prev);
-                }
-            }
+        for (; i < dim; ptr += stride, prev += stride, ++i) {
+            *ptr = (sum * invCount) >> blurSumShift;
+            sum += alpha2 - (*prev);
+        }
+    }
+}
+
+#if CPU(X86_SSE2) || HAVE(ARM_NEON_INTRINSICS)
+// The vector kernels blur four neighbouring lines at once, one line per 32-bit lane. Lines that are
+// a pixel apart, the columns of the vertical pass, are loaded and stored as one vector; the rows
+// of the horizontal pass are gathered and scattered a pixel at a time.
+#if CPU(X86_SSE2)
+using BlurLanes = __m128i;
+
+static inline BlurLanes loadBlurLanes(const unsigned char* pixels, int lineDelta, int channel)
+{
+    __m128i lanes;
+    if (lineDelta == 4)
+        lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    else {
+        uint32_t gathered[4];
+        for (int line = 0; line < 4; ++line)
+            memcpy(&gathered[line], pixels + line * lineDelta, sizeof(uint32_t));
+        lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gathered));
+    }
+    return _mm_and_si128(_mm_srl_epi32(lanes, _mm_cvtsi32_si128(channel * 8)), _mm_set1_epi32(0xff));
+}
+
+static inline void storeBlurLanes(unsigned char* pixels, int lineDelta, int channel, BlurLanes values)
+{
+    if (lineDelta == 4) {
+        __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+        __m128i mask = _mm_set1_epi32(static_cast<int>(0xffu << (channel * 8)));
+        lanes = _mm_or_si128(_mm_andnot_si128(mask, lanes), _mm_sll_epi32(values, _mm_cvtsi32_si128(channel * 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), lanes);
+        return;
+    }
+    uint32_t scattered[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(scattered), values);
+    for (int line = 0; line < 4; ++line)
+        pixels[line * lineDelta + channel] = scattered[line];
+}
+
+static inline BlurLanes addBlurLanes(BlurLanes a, BlurLanes b) { return _mm_add_epi32(a, b); }
+static inline BlurLanes subtractBlurLanes(BlurLanes a, BlurLanes b) { return _mm_sub_epi32(a, b); }
+
+// (sum * invCount) >> blurSumShift. SSE2 has no 32-bit multiply, so the even and odd lanes are
+// multiplied separately into 64-bit products. The sums are never negative.
+static inline BlurLanes scaleBlurLanes(BlurLanes sum, int invCount)
+{
+    __m128i multiplier = _mm_set1_epi32(invCount);
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(sum, multiplier), blurSumShift);
+    __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(sum, 32), multiplier), blurSumShift);
+    return _mm_or_si128(_mm_and_si128(even, _mm_set_epi32(0, -1, 0, -1)), _mm_slli_epi64(odd, 32));
+}
+#else
+using BlurLanes = int32x4_t;
+
+static inline BlurLanes loadBlurLanes(const unsigned char* pixels, int lineDelta, int channel)
+{
+    uint32_t gathered[4];
+    for (int line = 0; line < 4; ++line)
+        memcpy(&gathered[line], pixels + line * lineDelta, sizeof(uint32_t));
+    uint32x4_t lanes = vshlq_u32(vld1q_u32(gathered), vdupq_n_s32(-channel * 8));
+    return vreinterpretq_s32_u32(vandq_u32(lanes, vdupq_n_u32(0xff)));
+}
+
+static inline void storeBlurLanes(unsigned char* pixels, int lineDelta, int channel, BlurLanes values)
+{
+    int32_t scattered[4];
+    vst1q_s32(scattered, values);
+    for (int line = 0; line < 4; ++line)
+        pixels[line * lineDelta + channel] = scattered[line];
+}
+
+static inline BlurLanes addBlurLanes(BlurLanes a, BlurLanes b) { return vaddq_s32(a, b); }
+static inline BlurLanes subtractBlurLanes(BlurLanes a, BlurLanes b) { return vsubq_s32(a, b); }
+
+static inline BlurLanes scaleBlurLanes(BlurLanes sum, int invCount)
+{
+    return vshrq_n_s32(vmulq_s32(sum, vdupq_n_s32(invCount)), blurSumShift);
+}
+#endif
+
+// Same as boxBlurLine() for four lines lineDelta bytes apart. Reads past either end of a line
+// are clamped to its first and last pixel, which is what boxBlurLine() does with alpha1 and alpha2.
+static void boxBlurFourLines(unsigned char* pixels, const int lobes[3][2], int dim, int stride, int lineDelta)
+{
+    for (int step = 0; step < 3; ++step) {
+        int side1 = lobes[step][LeftLobe];
+        int side2 = lobes[step][RightLobe];
+        int pixelCount = side1 + 1 + side2;
+        int invCount = ((1 << blurSumShift) + pixelCount - 1) / pixelCount;
+        int sourceChannel = blurChannels[step];
+        int destinationChannel = blurChannels[step + 1];
+
+        auto alphaAt = [&](int i) {
+            return loadBlurLanes(pixels + clampTo(i, 0, dim - 1) * stride, lineDelta, sourceChannel);
+        };
+
+        BlurLanes alpha1 = alphaAt(0);
+        BlurLanes sum = alpha1;
+        for (int i = 0; i < side1; ++i)
+            sum = addBlurLanes(sum, alpha1);
+        for (int i = 1; i <= side2; ++i)
+            sum = addBlurLanes(sum, alphaAt(i));
+
+        for (int i = 0; i < dim; ++i) {
+            storeBlurLanes(pixels + i * stride, lineDelta, destinationChannel, scaleBlurLanes(sum, invCount));
+            sum = addBlurLanes(sum, subtractBlurLanes(alphaAt(i + side2 + 1), alphaAt(i - side1)));
         }
+    }
+}
+#endif
 
-        // Last pass is vertical.
-        stride = rowStride;
-        delta = 4;
-        final = size.width();
-        dim = size.height();
+struct BoxBlurParameters {
+    unsigned char* pixels;
+    const int (*lobes)[2];
+    int startLine;
+    int endLine;
+    int lineDelta;
+    int dim;
+    int stride;
+};
 
-        if (!m_blurRadius.height())
-            break;
+static void boxBlurLines(BoxBlurParameters* parameters)
+{
+    int line = parameters->startLine;
+#if CPU(X86_SSE2) || HAVE(ARM_NEON_INTRINSICS)
+    for (; line + 4 <= parameters->endLine; line += 4)
+        boxBlurFourLines(parameters->pixels + line * parameters->lineDelta, parameters->lobes, parameters->dim, parameters->stride, parameters->lineDelta);
+#endif
+    for (; line < parameters->endLine; ++line)
+        boxBlurLine(parameters->pixels + line * parameters->lineDelta, parameters->lobes, parameters->dim, parameters->stride);
+}
 
-        if (m_blurRadius.width() != m_blurRadius.height())
-            calculateLobes(lobes, m_blurRadius.height(), m_shadowsIgnoreTransforms);
+// Blurs lineCount lines of dim pixels. Every line is independent of the others, so large
+// images have their lines split between threads. Shadows are also painted on the painting
+// threads of the compositor, and the thread pool ParallelJobs uses is only safe to use from
+// one thread, so the lines are only split on the main thread.
+static void boxBlur(unsigned char* pixels, const int lobes[3][2], int lineCount, int lineDelta, int dim, int stride)
+{
+    static const int minimalArea = 256 * 256; // Empirical data limit for parallel jobs.
+    static const int minimalLinesPerJob = 16;
+
+    unsigned optimalThreadNumber = std::min<unsigned>((lineCount * dim) / minimalArea, lineCount / minimalLinesPerJob);
+    if (optimalThreadNumber > 1 && isMainThread()) {
+        WTF::ParallelJobs<BoxBlurParameters> parallelJobs(&boxBlurLines, optimalThreadNumber);
+        int jobs = parallelJobs.numberOfJobs();
+        if (jobs > 1) {
+            // Jobs start on a multiple of four lines so that they all go through the vector kernel.
+            int jobSize = (lineCount / jobs) & ~3;
+            int currentLine = 0;
+            for (int job = 0; job < jobs; ++job) {
+                BoxBlurParameters& parameters = parallelJobs.parameter(job);
+                parameters = { pixels, lobes, currentLine, job == jobs - 1 ? lineCount : currentLine + jobSize, lineDelta, dim, stride };
+                currentLine = parameters.endLine;
+            }
+            parallelJobs.execute();
+            return;
+        }
+        // Fallback to single thread model
     }
+
+    BoxBlurParameters parameters { pixels, lobes, 0, lineCount, lineDelta, dim, stride };
+    boxBlurLines(&parameters);
+}
+
+void ShadowBlur::blurLayerImage(unsigned char* imageData, const IntSize& size, int rowStride)
+{
+    int lobes[3][2]; // indexed by pass, and left/right lobe
+    calculateLobes(lobes, m_blurRadius.width(), m_shadowsIgnoreTransforms);
+
+    // Two stages: horizontal and vertical. Do no work if horizonal blur is zero.
+    if (m_blurRadius.width())
+        boxBlur(imageData, lobes, size.height(), rowStride, size.width(), 4);
+
+    if (!m_blurRadius.height())
+        return;
+
+    if (m_blurRadius.width() != m_blurRadius.height())
+        calculateLobes(lobes, m_blurRadius.height(), m_shadowsIgnoreTransforms);
+
+    boxBlur(imageData, lobes, size.width(), 4, size.height(), rowStride);
 }
 
 void ShadowBlur::adjustBlurRadius(const AffineTransform& transform)
@@ -559,7 +693,7 @@ void ShadowBlur::drawRectShadow(const AffineTransform& transform, const IntRect&
         canUseTilingTechnique = false;
 
     if (canUseTilingTechnique)
-        drawRectShadowWithTiling(transform, shadowedRect, templateSize, edgeSize, drawImage, fillRect, *layerImageProperties);
+        drawRectShadowWithTiling(transform, shadowedRect, templateSize, edgeSize, drawImage, fillRect);
     else
         drawRectShadowWithoutTiling(transform, shadowedRect, *layerImageProperties, drawBuffer);
 }
@@ -681,38 +815,11 @@ void ShadowBlur::drawInsetShadowWithoutTiling(const AffineTransform&, const Floa
      the shadow.
  */
 
-void ShadowBlur::drawRectShadowWithTiling(const AffineTransform& transform, const FloatRoundedRect& shadowedRect, const IntSize& templateSize, const IntSize& edgeSize, const DrawImageCallback& drawImage, const FillRectCallback& fillRect, const LayerImageProperties& layerImageProperties)
+void ShadowBlur::drawRectShadowWithTiling(const AffineTransform& transform, const FloatRoundedRect& shadowedRect, const IntSize& templateSize, const IntSize& edgeSize, const DrawImageCallback& drawImage, const FillRectCallback& fillRect)
 {
-#if USE(CG)
-    auto* layerImage = ScratchBuffer::singleton().getScratchBuffer(templateSize);
-    auto releaseLayerImage = makeScopeExit([] {
-        ScratchBuffer::singleton().scheduleScratchBufferPurge();
-    });
-#else
-    UNUSED_PARAM(layerImageProperties);
-    auto layerImageBuffer = ImageBuffer::create(templateSize, RenderingMode::Unaccelerated, 1);
-    auto* layerImage = layerImageBuffer.get();
-#endif
-
-    if (!layerImage)
-        return;
-
     FloatRect templateShadow = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    bool redrawNeeded = true;
-#if USE(CG)
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    redrawNeeded = ScratchBuffer::singleton().setCachedShadowValues(m_blurRadius, m_color, templateShadow, shadowedRect.radii(), layerImageProperties.layerSize);
-#endif
-
-    if (redrawNeeded) {
-        // Draw shadow into the ImageBuffer.
-        GraphicsContext& shadowContext = layerImage->context();
-        GraphicsContextStateSaver shadowStateSaver(shadowContext);
-
-        shadowContext.clearRect(FloatRect(0, 0, templateSize.width(), templateSize.height()));
-        shadowContext.setFillColor(Color::black);
-
+    auto layerImage = shadowTemplate(OuterShadow, shadowedRect.radii(), templateSize, [&](GraphicsContext& shadowContext) {
         if (shadowedRect.radii().isZero())
             shadowContext.fillRect(templateShadow);
         else {
@@ -720,8 +827,9 @@ void ShadowBlur::drawRectShadowWithTiling(const AffineTransform& transform, cons
             path.addRoundedRect(FloatRoundedRect(templateShadow, shadowedRect.radii()));
             shadowContext.fillPath(path);
         }
-        blurAndColorShadowBuffer(*layerImage, templateSize);
-    }
+    });
+    if (!layerImage)
+        return;
 
     FloatSize offset = m_offset;
     if (shadowsIgnoreTransforms())
@@ -737,37 +845,11 @@ void ShadowBlur::drawRectShadowWithTiling(const AffineTransform& transform, cons
 
 void ShadowBlur::drawInsetShadowWithTiling(const AffineTransform& transform, const FloatRect& fullRect, const FloatRoundedRect& holeRect, const IntSize& templateSize, const IntSize& edgeSize, const DrawImageCallback& drawImage, const FillRectWithHoleCallback& fillRectWithHole)
 {
-#if USE(CG)
-    auto* layerImage = ScratchBuffer::singleton().getScratchBuffer(templateSize);
-    auto releaseLayerImage = makeScopeExit([] {
-        ScratchBuffer::singleton().scheduleScratchBufferPurge();
-    });
-#else
-    auto layerImageBuffer = ImageBuffer::create(templateSize, RenderingMode::Unaccelerated, 1);
-    auto* layerImage = layerImageBuffer.get();
-#endif
-
-    if (!layerImage)
-        return;
-
     // Draw the rectangle with hole.
     FloatRect templateBounds(0, 0, templateSize.width(), templateSize.height());
     FloatRect templateHole = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    bool redrawNeeded = true;
-#if USE(CG)
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    redrawNeeded = ScratchBuffer::singleton().setCachedInsetShadowValues(m_blurRadius, m_color, templateBounds, templateHole, holeRect.radii());
-#endif
-
-    if (redrawNeeded) {
-        // Draw shadow into a new ImageBuffer.
-        GraphicsContext& shadowContext = layerImage->context();
-        GraphicsContextStateSaver shadowStateSaver(shadowContext);
-        shadowContext.clearRect(templateBounds);
-        shadowContext.setFillRule(WindRule::EvenOdd);
-        shadowContext.setFillColor(Color::black);
-
+    auto layerImage = shadowTemplate(InnerShadow, holeRect.radii(), templateSize, [&](GraphicsContext& shadowContext) {
         Path path;
         path.addRect(templateBounds);
         if (holeRect.radii().isZero())
@@ -775,10 +857,12 @@ void ShadowBlur::drawInsetShadowWithTiling(const AffineTransform& transform, con
         else
             path.addRoundedRect(FloatRoundedRect(templateHole, holeRect.radii()));
 
+        shadowContext.setFillRule(WindRule::EvenOdd);
         shadowContext.fillPath(path);
+    });
+    if (!layerImage)
+        return;
 
-        blurAndColorShadowBuffer(*layerImage, templateSize);
-    }
     FloatSize offset = m_offset;
     if (shadowsIgnoreTransforms())
         offset.scale(1 / transform.xScale(), 1 / transform.yScale());
@@ -798,6 +882,34 @@ void ShadowBlur::drawInsetShadowWithTiling(const AffineTransform& transform, con
     drawLayerPieces(*layerImage, destHoleBounds, holeRect.radii(), edgeSize, templateSize, drawImage);
 }
 
+RefPtr<ImageBuffer> ShadowBlur::shadowTemplate(ShadowDirection direction, const FloatRoundedRect::Radii& radii, const IntSize& templateSize, const DrawShadowCallback& drawTemplate)
+{
+    // The cache's purge timer ties it to the main thread; shadows painted elsewhere blur their own template.
+    bool canUseCache = isMainThread();
+    ShadowTemplateCache::Key key { direction == InnerShadow, m_blurRadius, m_shadowsIgnoreTransforms, m_color, radii };
+    if (canUseCache) {
+        if (auto layerImage = ShadowTemplateCache::singleton().templateForKey(key))
+            return layerImage;
+    }
+
+    // ShadowBlur is not used with accelerated drawing, so it's OK to make an unconditionally unaccelerated buffer.
+    auto layerImage = ImageBuffer::create(templateSize, RenderingMode::Unaccelerated, 1);
+    if (!layerImage)
+        return nullptr;
+
+    {
+        GraphicsContext& shadowContext = layerImage->context();
+        GraphicsContextStateSaver shadowStateSaver(shadowContext);
+        shadowContext.setFillColor(Color::black);
+        drawTemplate(shadowContext);
+    }
+    blurAndColorShadowBuffer(*layerImage, templateSize);
+
+    if (canUseCache)
+        ShadowTemplateCache::singleton().addTemplate(key, *layerImage);
+    return layerImage;
+}
+
 void ShadowBlur::drawLayerPieces(ImageBuffer& layerImage, const FloatRect& shadowBounds, const FloatRoundedRect::Radii& radii, const IntSize& bufferPadding, const IntSize& templateSize, const DrawImageCallback& drawImage)
 {
     const IntSize twiceRadius = IntSize(bufferPadding.width() * 2, bufferPadding.height() * 2);
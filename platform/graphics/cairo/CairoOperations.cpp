@@ -891,6 +891,16 @@ void drawPlatformImage(PlatformContextCairo& platformContext, cairo_surface_t* s
 
 void drawPattern(PlatformContextCairo& platformContext, cairo_surface_t* surface, const IntSize& size, const FloatRect& destRect, const FloatRect& tileRect, const AffineTransform& patternTransform, const FloatPoint& phase, const ImagePaintingOptions& options)
 {
+    // The surface is smaller than the image when it was decoded for drawing at a smaller size; the
+    // tile is then taken from the surface and scaled back up by the pattern transform.
+    IntSize surfaceSize = cairoSurfaceSize(surface);
+    if (!size.isEmpty() && surfaceSize != size) {
+        AffineTransform surfacePatternTransform = patternTransform;
+        surfacePatternTransform.scale(static_cast<double>(size.width()) / surfaceSize.width(), static_cast<double>(size.height()) / surfaceSize.height());
+        drawPatternToCairoContext(platformContext.cr(), surface, surfaceSize, mapRectToCairoSurface(tileRect, size, surface), surfacePatternTransform, phase, toCairoOperator(options.compositeOperator(), options.blendMode()), options.interpolationQuality(), destRect);
+        return;
+    }
+
     // FIXME: Investigate why the size has to be passed in as an IntRect.
     drawPatternToCairoContext(platformContext.cr(), surface, size, tileRect, patternTransform, phase, toCairoOperator(options.compositeOperator(), options.blendMode()), options.interpolationQuality(), destRect);
 }
@@ -34,6 +34,7 @@
 #include "Color.h"
 #include "FloatPoint.h"
 #include "FloatRect.h"
+#include "GeometryUtilities.h"
 #include "IntRect.h"
 #include "Path.h"
 #include "RefPtrCairo.h"
@@ -327,6 +328,18 @@ IntSize cairoSurfaceSize(cairo_surface_t* surface)
     }
 }
 
+// Maps a rect in the coordinates of an image of imageSize to those of the surface holding it, which
+// is smaller when the image was decoded for drawing at a smaller size.
+FloatRect mapRectToCairoSurface(const FloatRect& rect, const FloatSize& imageSize, cairo_surface_t* surface, bool usesWidthAsHeight)
+{
+    FloatSize surfaceSize = cairoSurfaceSize(surface);
+    if (usesWidthAsHeight)
+        surfaceSize = surfaceSize.transposedSize();
+    if (imageSize.isEmpty() || surfaceSize == imageSize)
+        return rect;
+    return mapRect(rect, FloatRect({ }, imageSize), FloatRect({ }, surfaceSize));
+}
+
 void flipImageSurfaceVertically(cairo_surface_t* surface)
 {
     ASSERT(cairo_surface_get_type(surface) == CAIRO_SURFACE_TYPE_IMAGE);
@@ -41,6 +41,7 @@ class AffineTransform;
 class Color;
 class FloatRect;
 class FloatPoint;
+class FloatSize;
 class IntSize;
 class IntRect;
 class Path;
@@ -88,6 +89,7 @@ void copyRectFromCairoSurfaceToContext(cairo_surface_t* from, cairo_t* to, const
 void copyRectFromOneSurfaceToAnother(cairo_surface_t* from, cairo_surface_t* to, const IntSize& offset, const IntRect&, const IntSize& = IntSize());
 
 IntSize cairoSurfaceSize(cairo_surface_t*);
+FloatRect mapRectToCairoSurface(const FloatRect&, const FloatSize& imageSize, cairo_surface_t*, bool usesWidthAsHeight = false);
 void flipImageSurfaceVertically(cairo_surface_t*);
 
 RefPtr<cairo_region_t> toCairoRegion(const Region&);
@@ -37,6 +37,7 @@
 
 #include "AffineTransform.h"
 #include "CairoOperations.h"
+#include "CairoUtilities.h"
 #include "FloatRect.h"
 #include "FloatRoundedRect.h"
 #include "GraphicsContextImpl.h"
@@ -123,14 +124,15 @@ void GraphicsContext::drawRect(const FloatRect& rect, float borderThickness)
     Cairo::drawRect(*platformContext(), rect, borderThickness, state.fillColor, state.strokeStyle, state.strokeColor);
 }
 
-void GraphicsContext::drawPlatformImage(const PlatformImagePtr& image, const FloatSize&, const FloatRect& destRect, const FloatRect& srcRect, const ImagePaintingOptions& options)
+void GraphicsContext::drawPlatformImage(const PlatformImagePtr& image, const FloatSize& imageSize, const FloatRect& destRect, const FloatRect& srcRect, const ImagePaintingOptions& options)
 {
     if (paintingDisabled())
         return;
 
     ASSERT(hasPlatformContext());
     auto& state = this->state();
-    Cairo::drawPlatformImage(*platformContext(), image.get(), destRect, srcRect, { options, state.imageInterpolationQuality }, state.alpha, Cairo::ShadowState(state));
+    FloatRect surfaceSrcRect = mapRectToCairoSurface(srcRect, imageSize, image.get(), options.orientation().usesWidthAsHeight());
+    Cairo::drawPlatformImage(*platformContext(), image.get(), destRect, surfaceSrcRect, { options, state.imageInterpolationQuality }, state.alpha, Cairo::ShadowState(state));
 }
 
 // This is only used to draw borders, so we should not draw shadows.
@@ -30,6 +30,7 @@
 #if USE(CAIRO)
 
 #include "CairoOperations.h"
+#include "CairoUtilities.h"
 #include "FloatRoundedRect.h"
 #include "Font.h"
 #include "GlyphBuffer.h"
@@ -271,9 +272,9 @@ void GraphicsContextImplCairo::drawImageBuffer(ImageBuffer& image, const FloatRe
 
 void GraphicsContextImplCairo::drawNativeImage(NativeImage& image, const FloatSize& imageSize, const FloatRect& destRect, const FloatRect& srcRect, const ImagePaintingOptions& options)
 {
-    UNUSED_PARAM(imageSize);
     auto& state = graphicsContext().state();
-    Cairo::drawPlatformImage(m_platformContext, image.platformImage().get(), destRect, srcRect, { options, state.imageInterpolationQuality }, state.alpha, Cairo::ShadowState(state));
+    FloatRect surfaceSrcRect = mapRectToCairoSurface(srcRect, imageSize, image.platformImage().get(), options.orientation().usesWidthAsHeight());
+    Cairo::drawPlatformImage(m_platformContext, image.platformImage().get(), destRect, surfaceSrcRect, { options, state.imageInterpolationQuality }, state.alpha, Cairo::ShadowState(state));
 }
 
 void GraphicsContextImplCairo::drawPattern(NativeImage& image, const FloatSize& imageSize, const FloatRect& destRect, const FloatRect& tileRect, const AffineTransform& patternTransform, const FloatPoint& phase, const FloatSize& spacing, const ImagePaintingOptions& options)
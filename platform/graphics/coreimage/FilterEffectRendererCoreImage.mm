@@ -98,6 +98,7 @@ bool FilterEffectRendererCoreImage::supportsCoreImageRendering(FilterEffect& eff
     case FilterEffect::Type::DisplacementMap:
     case FilterEffect::Type::DropShadow:
     case FilterEffect::Type::Flood:
+    case FilterEffect::Type::FusedColorTransform:
     case FilterEffect::Type::GaussianBlur:
     case FilterEffect::Type::Image:
     case FilterEffect::Type::Lighting:
@@ -153,6 +154,7 @@ RetainPtr<CIImage> FilterEffectRendererCoreImage::connectCIFilters(FilterEffect&
     case FilterEffect::Type::DisplacementMap:
     case FilterEffect::Type::DropShadow:
     case FilterEffect::Type::Flood:
+    case FilterEffect::Type::FusedColorTransform:
     case FilterEffect::Type::GaussianBlur:
     case FilterEffect::Type::Image:
     case FilterEffect::Type::Lighting:
@@ -29,6 +29,7 @@
 #include "DisplayListItemBuffer.h"
 #include "DisplayListItems.h"
 #include "Logging.h"
+#include <algorithm>
 #include <wtf/FastMalloc.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/text/TextStream.h>
@@ -55,6 +56,9 @@ DisplayList::DisplayList(DisplayList&& other)
     , m_nativeImages(std::exchange(other.m_nativeImages, { }))
     , m_items(std::exchange(other.m_items, nullptr))
     , m_drawingItemExtents(std::exchange(other.m_drawingItemExtents, { }))
+    , m_opaqueDrawingItemRects(std::exchange(other.m_opaqueDrawingItemRects, { }))
+    , m_occlusionBarriers(std::exchange(other.m_occlusionBarriers, { }))
+    , m_tracksOpaqueDrawingItemRects(std::exchange(other.m_tracksOpaqueDrawingItemRects, true))
 {
 }
 
@@ -72,6 +76,9 @@ DisplayList& DisplayList::operator=(DisplayList&& other)
     m_nativeImages = std::exchange(other.m_nativeImages, { });
     m_items = std::exchange(other.m_items, nullptr);
     m_drawingItemExtents = std::exchange(other.m_drawingItemExtents, { });
+    m_opaqueDrawingItemRects = std::exchange(other.m_opaqueDrawingItemRects, { });
+    m_occlusionBarriers = std::exchange(other.m_occlusionBarriers, { });
+    m_tracksOpaqueDrawingItemRects = std::exchange(other.m_tracksOpaqueDrawingItemRects, true);
     return *this;
 }
 
@@ -80,6 +87,9 @@ void DisplayList::clear()
     if (m_items)
         m_items->clear();
     m_drawingItemExtents.clear();
+    m_opaqueDrawingItemRects.clear();
+    m_occlusionBarriers.clear();
+    m_tracksOpaqueDrawingItemRects = true;
     m_imageBuffers.clear();
     m_nativeImages.clear();
 }
@@ -186,6 +196,69 @@ void DisplayList::setTracksDrawingItemExtents(bool value)
     m_tracksDrawingItemExtents = value;
 }
 
+BitVector DisplayList::culledDrawingItems(const FloatRect& clip) const
+{
+    BitVector culledItems;
+    if (m_drawingItemExtents.isEmpty())
+        return culledItems;
+
+    culledItems.ensureSize(m_drawingItemExtents.size());
+
+    if (!clip.isZero()) {
+        for (size_t i = 0; i < m_drawingItemExtents.size(); ++i) {
+            auto& extent = m_drawingItemExtents[i];
+            if (extent && !extent->intersects(clip))
+                culledItems.quickSet(i);
+        }
+    }
+
+    if (m_opaqueDrawingItemRects.isEmpty())
+        return culledItems;
+
+    // Walk the drawing items back to front, keeping the largest opaque rects seen so far.
+    // An item is occluded if its whole extent lies within one of them.
+    static constexpr size_t maximumOccluderCount = 8;
+    Vector<IntRect, maximumOccluderCount> occluders;
+    size_t opaqueRectIndex = m_opaqueDrawingItemRects.size();
+    size_t barrierIndex = m_occlusionBarriers.size();
+
+    for (size_t i = m_drawingItemExtents.size(); i--; ) {
+        // Opaque rects drawn after an occlusion barrier never hide what was drawn before it.
+        if (barrierIndex && m_occlusionBarriers[barrierIndex - 1] > i) {
+            while (barrierIndex && m_occlusionBarriers[barrierIndex - 1] > i)
+                --barrierIndex;
+            occluders.clear();
+        }
+
+        auto& extent = m_drawingItemExtents[i];
+        if (extent && !culledItems.quickGet(i)) {
+            for (auto& occluder : occluders) {
+                if (FloatRect(occluder).contains(*extent)) {
+                    culledItems.quickSet(i);
+                    break;
+                }
+            }
+        }
+
+        if (!opaqueRectIndex || m_opaqueDrawingItemRects[opaqueRectIndex - 1].first != i)
+            continue;
+
+        auto& opaqueRect = m_opaqueDrawingItemRects[--opaqueRectIndex].second;
+        if (occluders.size() < maximumOccluderCount) {
+            occluders.uncheckedAppend(opaqueRect);
+            continue;
+        }
+
+        auto* smallestOccluder = std::min_element(occluders.begin(), occluders.end(), [](auto& a, auto& b) {
+            return a.size().unclampedArea() < b.size().unclampedArea();
+        });
+        if (smallestOccluder->size().unclampedArea() < opaqueRect.size().unclampedArea())
+            *smallestOccluder = opaqueRect;
+    }
+
+    return culledItems;
+}
+
 void DisplayList::append(ItemHandle item)
 {
     switch (item.type()) {
@@ -339,14 +412,23 @@ void DisplayList::iterator::updateCurrentItem()
 
     auto& items = *m_displayList.m_items;
     auto itemType = static_cast<ItemType>(m_cursor[0]);
+    bool isCulled = false;
     if (isDrawingItem(itemType) && !m_displayList.m_drawingItemExtents.isEmpty()) {
         m_currentExtent = m_displayList.m_drawingItemExtents[m_drawingItemIndex];
+        isCulled = m_culledDrawingItems && m_culledDrawingItems->get(m_drawingItemIndex);
         m_drawingItemIndex++;
     } else
         m_currentExtent = WTF::nullopt;
 
     auto* client = items.m_readingClient;
     auto paddedSizeOfTypeAndItem = paddedSizeOfTypeAndItemInBytes(itemType);
+    if (isCulled) {
+        if (!isInlineItem(itemType) && client)
+            m_currentItemSizeInBuffer = 2 * sizeof(uint64_t) + roundUpToMultipleOf(alignof(uint64_t), reinterpret_cast<uint64_t*>(m_cursor)[1]);
+        else
+            m_currentItemSizeInBuffer = paddedSizeOfTypeAndItem;
+        return;
+    }
     m_currentBufferForItem = paddedSizeOfTypeAndItem <= sizeOfFixedBufferForCurrentItem ? m_fixedBufferForCurrentItem : reinterpret_cast<uint8_t*>(fastMalloc(paddedSizeOfTypeAndItem));
     if (!isInlineItem(itemType) && client) {
         auto dataLength = reinterpret_cast<uint64_t*>(m_cursor)[1];
@@ -31,6 +31,8 @@
 #include "Font.h"
 #include "GraphicsContext.h"
 #include "ImageBuffer.h"
+#include "IntRect.h"
+#include <wtf/BitVector.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/HashSet.h>
 #include <wtf/Noncopyable.h>
@@ -94,6 +96,11 @@ public:
     bool tracksDrawingItemExtents() const { return m_tracksDrawingItemExtents; }
     WEBCORE_EXPORT void setTracksDrawingItemExtents(bool);
 
+    // Returns the indices of the drawing items that don't need to be replayed, either
+    // because their extent falls outside of the given clip, or because they are entirely
+    // covered by a later opaque fill. A zero clip disables the clip check.
+    WEBCORE_EXPORT BitVector culledDrawingItems(const FloatRect& clip) const;
+
     class iterator {
     public:
         enum class ImmediatelyMoveToEnd { No, Yes };
@@ -108,6 +115,16 @@ public:
             }
         }
 
+        // Culled drawing items are stepped over without being copied or decoded, and
+        // are returned with a null item handle.
+        iterator(const DisplayList& displayList, const BitVector& culledDrawingItems)
+            : m_displayList(displayList)
+            , m_culledDrawingItems(&culledDrawingItems)
+        {
+            moveCursorToStartOfCurrentBuffer();
+            updateCurrentItem();
+        }
+
         ~iterator()
         {
             clearCurrentItem();
@@ -143,6 +160,7 @@ public:
         bool atEnd() const;
 
         const DisplayList& m_displayList;
+        const BitVector* m_culledDrawingItems { nullptr };
         uint8_t* m_cursor { nullptr };
         size_t m_readOnlyBufferIndex { 0 };
         size_t m_drawingItemIndex { 0 };
@@ -167,6 +185,34 @@ private:
         m_drawingItemExtents.append(WTFMove(extent));
     }
 
+    // Marks the last drawing item as painting every pixel of the given device rect opaquely.
+    void addOpaqueDrawingItemRect(const IntRect& rect)
+    {
+        ASSERT(m_tracksDrawingItemExtents && !m_drawingItemExtents.isEmpty());
+        if (m_tracksOpaqueDrawingItemRects)
+            m_opaqueDrawingItemRects.append({ m_drawingItemExtents.size() - 1, rect });
+    }
+
+    // Items that make the pixels drawn so far observable or change where the following items draw.
+    // Drawing items are never considered occluded by opaque rects drawn after one of these.
+    static bool isOcclusionBarrier(ItemType type)
+    {
+        return type == ItemType::MetaCommandChangeDestinationImageBuffer || type == ItemType::FlushContext || type == ItemType::PutImageData;
+    }
+
+    void addOcclusionBarrier()
+    {
+        if (m_tracksOpaqueDrawingItemRects)
+            m_occlusionBarriers.append(m_drawingItemExtents.size());
+    }
+
+    void stopTrackingOpaqueDrawingItemRects()
+    {
+        m_opaqueDrawingItemRects.clear();
+        m_occlusionBarriers.clear();
+        m_tracksOpaqueDrawingItemRects = false;
+    }
+
     void cacheImageBuffer(WebCore::ImageBuffer& imageBuffer)
     {
         m_imageBuffers.ensure(imageBuffer.renderingResourceIdentifier(), [&]() {
@@ -195,13 +241,19 @@ private:
     FontRenderingResourceMap m_fonts;
     std::unique_ptr<ItemBuffer> m_items;
     Vector<Optional<FloatRect>> m_drawingItemExtents;
+    Vector<std::pair<size_t, IntRect>> m_opaqueDrawingItemRects;
+    // The number of drawing items that preceded each occlusion barrier.
+    Vector<size_t> m_occlusionBarriers;
     bool m_tracksDrawingItemExtents { true };
+    bool m_tracksOpaqueDrawingItemRects { true };
 };
 
 template<typename T, class... Args>
 void DisplayList::append(Args&&... args)
 {
     itemBuffer().append<T>(std::forward<Args>(args)...);
+    if (isOcclusionBarrier(T::itemType))
+        addOcclusionBarrier();
 }
 
 } // DisplayList
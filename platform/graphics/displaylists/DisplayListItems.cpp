@@ -44,6 +44,43 @@ namespace DisplayList {
 // Should match RenderTheme::platformFocusRingWidth()
 static const float platformFocusRingWidth = 3;
 
+// Inline items can be copied byte for byte out of a buffer written by another process (see
+// DisplayListWireFormat.h), so isValid() reads enums and bools through their bytes before
+// anything switches on them.
+template<typename E> static bool isValidEnumBytes(const E& value)
+{
+    std::underlying_type_t<E> rawValue;
+    static_assert(sizeof(rawValue) == sizeof(value));
+    memcpy(&rawValue, &value, sizeof(rawValue));
+    return isValidEnum<E>(rawValue);
+}
+
+static bool isValidBoolBytes(const bool& value)
+{
+    uint8_t rawValue;
+    static_assert(sizeof(rawValue) == sizeof(value));
+    memcpy(&rawValue, &value, sizeof(rawValue));
+    return rawValue <= 1;
+}
+
+template<typename T> static bool isValidIdentifier(ObjectIdentifier<T> identifier)
+{
+    return ObjectIdentifier<T>::isValidIdentifier(identifier.toUInt64());
+}
+
+static bool isValidImagePaintingOptions(const ImagePaintingOptions& options)
+{
+    auto orientation = options.orientation();
+    std::underlying_type_t<ImageOrientation::Orientation> rawOrientation;
+    static_assert(sizeof(rawOrientation) == sizeof(orientation));
+    memcpy(&rawOrientation, &orientation, sizeof(rawOrientation));
+    return isValidEnumBytes(options.compositeOperator())
+        && isValidEnumBytes(options.blendMode())
+        && isValidEnumBytes(options.decodingMode())
+        && isValidEnum<ImageOrientation::Orientation>(rawOrientation)
+        && isValidEnumBytes(options.interpolationQuality());
+}
+
 void Save::apply(GraphicsContext& context) const
 {
     context.save();
@@ -151,6 +188,11 @@ SetInlineFillGradient::SetInlineFillGradient(float offsets[maxColorStopCount], S
     }
 }
 
+bool SetInlineFillGradient::isValid() const
+{
+    return m_colorStopCount <= maxColorStopCount && m_data.index() < WTF::variant_size<Gradient::Data>::value && isValidEnumBytes(m_spreadMethod);
+}
+
 void SetInlineFillGradient::apply(GraphicsContext& context) const
 {
     if (m_colorStopCount <= maxColorStopCount)
@@ -230,6 +272,11 @@ static TextStream& operator<<(TextStream& ts, const SetState& state)
     return ts;
 }
 
+bool SetLineCap::isValid() const
+{
+    return isValidEnumBytes(m_lineCap);
+}
+
 void SetLineCap::apply(GraphicsContext& context) const
 {
     context.setLineCap(m_lineCap);
@@ -253,6 +300,11 @@ static TextStream& operator<<(TextStream& ts, const SetLineDash& lineDash)
     return ts;
 }
 
+bool SetLineJoin::isValid() const
+{
+    return isValidEnumBytes(m_lineJoin);
+}
+
 void SetLineJoin::apply(GraphicsContext& context) const
 {
     context.setLineJoin(m_lineJoin);
@@ -307,6 +359,11 @@ NO_RETURN_DUE_TO_ASSERT void ClipToImageBuffer::apply(GraphicsContext&) const
     ASSERT_NOT_REACHED();
 }
 
+bool ClipToImageBuffer::isValid() const
+{
+    return isValidIdentifier(m_imageBufferIdentifier);
+}
+
 void ClipToImageBuffer::apply(GraphicsContext& context, WebCore::ImageBuffer& imageBuffer) const
 {
     context.clipToImageBuffer(imageBuffer, m_destinationRect);
@@ -426,6 +483,11 @@ NO_RETURN_DUE_TO_ASSERT void DrawImageBuffer::apply(GraphicsContext&) const
     ASSERT_NOT_REACHED();
 }
 
+bool DrawImageBuffer::isValid() const
+{
+    return isValidIdentifier(m_imageBufferIdentifier) && isValidImagePaintingOptions(m_options);
+}
+
 void DrawImageBuffer::apply(GraphicsContext& context, WebCore::ImageBuffer& imageBuffer) const
 {
     context.drawImageBuffer(imageBuffer, m_destinationRect, m_srcRect, m_options);
@@ -444,6 +506,11 @@ NO_RETURN_DUE_TO_ASSERT void DrawNativeImage::apply(GraphicsContext&) const
     ASSERT_NOT_REACHED();
 }
 
+bool DrawNativeImage::isValid() const
+{
+    return isValidIdentifier(m_imageIdentifier) && isValidImagePaintingOptions(m_options);
+}
+
 void DrawNativeImage::apply(GraphicsContext& context, NativeImage& image) const
 {
     context.drawNativeImage(image, m_imageSize, m_destinationRect, m_srcRect, m_options);
@@ -475,6 +542,11 @@ NO_RETURN_DUE_TO_ASSERT void DrawPattern::apply(GraphicsContext&) const
     ASSERT_NOT_REACHED();
 }
 
+bool DrawPattern::isValid() const
+{
+    return isValidIdentifier(m_imageIdentifier) && isValidImagePaintingOptions(m_options);
+}
+
 void DrawPattern::apply(GraphicsContext& context, NativeImage& image) const
 {
     context.drawPattern(image, m_imageSize, m_destination, m_tileRect, m_patternTransform, m_phase, m_spacing, m_options);
@@ -562,6 +634,11 @@ static TextStream& operator<<(TextStream& ts, const DrawLinesForText& item)
     return ts;
 }
 
+bool DrawDotsForDocumentMarker::isValid() const
+{
+    return isValidEnumBytes(m_style.mode) && isValidBoolBytes(m_style.shouldUseDarkAppearance);
+}
+
 void DrawDotsForDocumentMarker::apply(GraphicsContext& context) const
 {
     context.drawDotsForDocumentMarker(m_rect, m_style);
@@ -739,6 +816,11 @@ static TextStream& operator<<(TextStream& ts, const FillRectWithRoundedHole& ite
 
 #if ENABLE(INLINE_PATH_DATA)
 
+bool FillInlinePath::isValid() const
+{
+    return m_pathData.index() < WTF::variant_size<InlinePathData>::value;
+}
+
 void FillInlinePath::apply(GraphicsContext& context) const
 {
     context.fillPath(path());
@@ -814,6 +896,11 @@ PaintFrameForMedia::PaintFrameForMedia(MediaPlayer& player, const FloatRect& des
 {
 }
 
+bool PaintFrameForMedia::isValid() const
+{
+    return isValidIdentifier(m_identifier);
+}
+
 NO_RETURN_DUE_TO_ASSERT void PaintFrameForMedia::apply(GraphicsContext&) const
 {
     // Should be handled by the delegate.
@@ -927,6 +1014,11 @@ Optional<FloatRect> StrokeInlinePath::localBounds(const GraphicsContext& context
     return bounds;
 }
 
+bool StrokeInlinePath::isValid() const
+{
+    return m_pathData.index() < WTF::variant_size<InlinePathData>::value;
+}
+
 void StrokeInlinePath::apply(GraphicsContext& context) const
 {
     context.strokePath(path());
@@ -991,6 +1083,11 @@ static TextStream& operator<<(TextStream& ts, const ApplyDeviceScaleFactor& item
     return ts;
 }
 
+bool FlushContext::isValid() const
+{
+    return isValidIdentifier(m_identifier);
+}
+
 void FlushContext::apply(GraphicsContext&) const
 {
     // Handled by client.
@@ -181,6 +181,8 @@ public:
     static bool isInline(const Gradient&);
     Ref<Gradient> gradient() const;
 
+    bool isValid() const;
+
     void apply(GraphicsContext&) const;
 
 private:
@@ -600,6 +602,8 @@ public:
 
     LineCap lineCap() const { return m_lineCap; }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&) const;
 
 private:
@@ -667,6 +671,8 @@ public:
 
     LineJoin lineJoin() const { return m_lineJoin; }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&) const;
 
 private:
@@ -755,6 +761,8 @@ public:
     RenderingResourceIdentifier imageBufferIdentifier() const { return m_imageBufferIdentifier; }
     FloatRect destinationRect() const { return m_destinationRect; }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&, WebCore::ImageBuffer&) const;
 
     NO_RETURN_DUE_TO_ASSERT void apply(GraphicsContext&) const;
@@ -1035,6 +1043,8 @@ public:
     FloatRect destinationRect() const { return m_destinationRect; }
     ImagePaintingOptions options() const { return m_options; }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&, WebCore::ImageBuffer&) const;
 
     NO_RETURN_DUE_TO_ASSERT void apply(GraphicsContext&) const;
@@ -1068,6 +1078,8 @@ public:
     const FloatRect& source() const { return m_srcRect; }
     const FloatRect& destinationRect() const { return m_destinationRect; }
 
+    bool isValid() const;
+
     NO_RETURN_DUE_TO_ASSERT void apply(GraphicsContext&) const;
     void apply(GraphicsContext&, NativeImage&) const;
 
@@ -1098,6 +1110,8 @@ public:
     FloatPoint phase() const { return m_phase; }
     FloatSize spacing() const { return m_spacing; }
 
+    bool isValid() const;
+
     NO_RETURN_DUE_TO_ASSERT void apply(GraphicsContext&) const;
     void apply(GraphicsContext&, NativeImage&) const;
 
@@ -1294,6 +1308,8 @@ public:
 
     FloatRect rect() const { return m_rect; }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&) const;
 
     Optional<FloatRect> globalBounds() const { return WTF::nullopt; }
@@ -1836,6 +1852,8 @@ public:
 
     Path path() const { return Path::from(m_pathData); }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&) const;
 
     Optional<FloatRect> globalBounds() const { return WTF::nullopt; }
@@ -2000,6 +2018,8 @@ public:
     const FloatRect& destination() const { return m_destination; }
     MediaPlayerIdentifier identifier() const { return m_identifier; }
 
+    bool isValid() const;
+
     NO_RETURN_DUE_TO_ASSERT void apply(GraphicsContext&) const;
 
     Optional<FloatRect> localBounds(const GraphicsContext&) const { return WTF::nullopt; }
@@ -2075,6 +2095,8 @@ public:
 
     Path path() const { return Path::from(m_pathData); }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&) const;
 
     Optional<FloatRect> globalBounds() const { return WTF::nullopt; }
@@ -2231,6 +2253,8 @@ public:
 
     FlushIdentifier identifier() const { return m_identifier; }
 
+    bool isValid() const;
+
     void apply(GraphicsContext&) const;
 
 private:
@@ -258,11 +258,14 @@ AffineTransform Recorder::getCTM(GraphicsContext::IncludeDeviceScale)
 void Recorder::beginTransparencyLayer(float opacity)
 {
     append<BeginTransparencyLayer>(opacity);
+    ++m_transparencyLayerDepth;
 }
 
 void Recorder::endTransparencyLayer()
 {
     append<EndTransparencyLayer>();
+    if (m_transparencyLayerDepth)
+        --m_transparencyLayerDepth;
 }
 
 void Recorder::drawRect(const FloatRect& rect, float borderThickness)
@@ -308,11 +311,18 @@ void Recorder::drawFocusRing(const Vector<FloatRect>& rects, float width, float
 void Recorder::fillRect(const FloatRect& rect)
 {
     append<FillRect>(rect);
+
+    auto& state = graphicsContext().state();
+    if (!state.fillGradient && !state.fillPattern)
+        addOpaqueExtentIfNeeded(rect, state.fillColor, state.compositeOperator, state.blendMode);
 }
 
 void Recorder::fillRect(const FloatRect& rect, const Color& color)
 {
     append<FillRectWithColor>(rect, color);
+
+    auto& state = graphicsContext().state();
+    addOpaqueExtentIfNeeded(rect, color, state.compositeOperator, state.blendMode);
 }
 
 void Recorder::fillRect(const FloatRect& rect, Gradient& gradient)
@@ -323,6 +333,7 @@ void Recorder::fillRect(const FloatRect& rect, Gradient& gradient)
 void Recorder::fillRect(const FloatRect& rect, const Color& color, CompositeOperator op, BlendMode blendMode)
 {
     append<FillCompositedRect>(rect, color, op, blendMode);
+    addOpaqueExtentIfNeeded(rect, color, op, blendMode);
 }
 
 void Recorder::fillRoundedRect(const FloatRoundedRect& rect, const Color& color, BlendMode blendMode)
@@ -403,17 +414,20 @@ void Recorder::clip(const FloatRect& rect)
 
 void Recorder::clipOut(const FloatRect& rect)
 {
+    currentState().clipBoundsAreExact = false;
     append<ClipOut>(rect);
 }
 
 void Recorder::clipOut(const Path& path)
 {
+    currentState().clipBoundsAreExact = false;
     append<ClipOutToPath>(path);
 }
 
 void Recorder::clipPath(const Path& path, WindRule windRule)
 {
     currentState().clipBounds.intersect(path.fastBoundingRect());
+    currentState().clipBoundsAreExact = false;
     append<ClipPath>(path, windRule);
 }
 
@@ -426,6 +440,7 @@ IntRect Recorder::clipBounds()
 void Recorder::clipToImageBuffer(ImageBuffer& imageBuffer, const FloatRect& destRect)
 {
     m_displayList.cacheImageBuffer(imageBuffer);
+    currentState().clipBoundsAreExact = false;
     append<ClipToImageBuffer>(imageBuffer.renderingResourceIdentifier(), destRect);
 }
 
@@ -443,6 +458,7 @@ void Recorder::clipToDrawingCommands(const FloatRect& destination, ColorSpace co
 
     auto recordingContext = makeUnique<DrawingContext>(destination.size(), initialCTM);
     drawingFunction(recordingContext->context());
+    currentState().clipBoundsAreExact = false;
     append<ClipToDrawingCommands>(destination, colorSpace, recordingContext->takeDisplayList());
 }
 
@@ -462,6 +478,9 @@ void Recorder::applyDeviceScaleFactor(float deviceScaleFactor)
     // FIXME: this changes the baseCTM, which will invalidate all of our cached extents.
     // Assert that it's only called early on?
     append<ApplyDeviceScaleFactor>(deviceScaleFactor);
+
+    // Items recorded before and after this point can't be compared for occlusion.
+    m_displayList.stopTrackingOpaqueDrawingItemRects();
 }
 
 FloatRect Recorder::roundToDevicePixels(const FloatRect& rect, GraphicsContext::RoundingMode)
@@ -499,6 +518,37 @@ FloatRect Recorder::extentFromLocalBounds(const FloatRect& rect) const
     return state.ctm.mapRect(clippedExtent);
 }
 
+static IntRect enclosedIntRect(const FloatRect& rect)
+{
+    float left = std::ceil(rect.x());
+    float top = std::ceil(rect.y());
+    float width = std::max(0.f, std::floor(rect.maxX()) - left);
+    float height = std::max(0.f, std::floor(rect.maxY()) - top);
+    return { clampToInteger(left), clampToInteger(top), clampToInteger(width), clampToInteger(height) };
+}
+
+void Recorder::addOpaqueExtentIfNeeded(const FloatRect& localBounds, const Color& color, CompositeOperator op, BlendMode blendMode)
+{
+    // Record the device pixels that this fill paints opaquely, so that replay can skip
+    // earlier items it hides. This is only done when the covered area is known exactly.
+    if (!m_displayList.tracksDrawingItemExtents() || m_transparencyLayerDepth)
+        return;
+
+    if (!color.isOpaque() || graphicsContext().alpha() < 1)
+        return;
+
+    if ((op != CompositeOperator::SourceOver && op != CompositeOperator::Copy) || blendMode != BlendMode::Normal)
+        return;
+
+    auto& state = currentState();
+    if (!state.clipBoundsAreExact || !state.ctm.preservesAxisAlignment())
+        return;
+
+    auto opaqueRect = enclosedIntRect(state.ctm.mapRect(intersection(state.clipBounds, localBounds)));
+    if (!opaqueRect.isEmpty())
+        m_displayList.addOpaqueDrawingItemRect(opaqueRect);
+}
+
 const Recorder::ContextState& Recorder::currentState() const
 {
     ASSERT(m_stateStack.size());
@@ -531,6 +581,7 @@ void Recorder::ContextState::rotate(float angleInRadians)
 {
     double angleInDegrees = rad2deg(static_cast<double>(angleInRadians));
     ctm.rotate(angleInDegrees);
+    clipBoundsAreExact = false;
     
     AffineTransform rotation;
     rotation.rotate(angleInDegrees);
@@ -553,13 +604,17 @@ void Recorder::ContextState::setCTM(const AffineTransform& matrix)
 
     ctm = matrix;
 
-    if (inverseTransformForClipBounds)
+    if (inverseTransformForClipBounds) {
         clipBounds = inverseTransformForClipBounds->mapRect(clipBounds);
+        clipBoundsAreExact &= inverseTransformForClipBounds->preservesAxisAlignment();
+    } else
+        clipBoundsAreExact = false;
 }
 
 void Recorder::ContextState::concatCTM(const AffineTransform& matrix)
 {
     ctm *= matrix;
+    clipBoundsAreExact &= matrix.preservesAxisAlignment();
 
     if (Optional<AffineTransform> inverse = matrix.inverse())
         clipBounds = inverse.value().mapRect(clipBounds);
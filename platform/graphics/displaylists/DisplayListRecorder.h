@@ -174,6 +174,7 @@ private:
     void appendStateChangeItem(const GraphicsContextStateChange&, GraphicsContextState::StateChangeFlags);
 
     FloatRect extentFromLocalBounds(const FloatRect&) const;
+    void addOpaqueExtentIfNeeded(const FloatRect& localBounds, const Color&, CompositeOperator, BlendMode);
     
     const AffineTransform& ctm() const;
     const FloatRect& clipBounds() const;
@@ -184,6 +185,8 @@ private:
         GraphicsContextStateChange stateChange;
         GraphicsContextState lastDrawingState;
         bool wasUsedForDrawing { false };
+        // Whether clipBounds is exactly the clip, rather than a bounding box of it.
+        bool clipBoundsAreExact { true };
         
         ContextState(const GraphicsContextState& state, const AffineTransform& transform, const FloatRect& clip)
             : ctm(transform)
@@ -196,6 +199,7 @@ private:
         {
             ContextState state(lastDrawingState, ctm, clipBounds);
             state.stateChange = stateChange;
+            state.clipBoundsAreExact = clipBoundsAreExact;
             return state;
         }
 
@@ -213,6 +217,7 @@ private:
     Delegate* m_delegate;
 
     Vector<ContextState, 32> m_stateStack;
+    unsigned m_transparencyLayerDepth { 0 };
 
     DrawGlyphsRecorder m_drawGlyphsRecorder;
 };
@@ -124,7 +124,6 @@ std::pair<Optional<StopReplayReason>, Optional<RenderingResourceIdentifier>> Rep
 ReplayResult Replayer::replay(const FloatRect& initialClip, bool trackReplayList)
 {
     LOG_WITH_STREAM(DisplayLists, stream << "\nReplaying with clip " << initialClip);
-    UNUSED_PARAM(initialClip);
 
     std::unique_ptr<DisplayList> replayList;
     if (UNLIKELY(trackReplayList))
@@ -134,9 +133,12 @@ ReplayResult Replayer::replay(const FloatRect& initialClip, bool trackReplayList
     size_t i = 0;
 #endif
     ReplayResult result;
-    for (auto [item, extent, itemSizeInBuffer] : m_displayList) {
-        if (!initialClip.isZero() && extent && !extent->intersects(initialClip)) {
-            LOG_WITH_STREAM(DisplayLists, stream << "skipping " << i++ << " " << item);
+    auto culledDrawingItems = m_displayList.culledDrawingItems(initialClip);
+    auto end = m_displayList.end();
+    for (DisplayList::iterator it { m_displayList, culledDrawingItems }; it != end; ++it) {
+        auto [item, extent, itemSizeInBuffer] = *it;
+        if (!item) {
+            LOG_WITH_STREAM(DisplayLists, stream << "skipping " << i++ << " extent " << extent);
             result.numberOfBytesRead += itemSizeInBuffer;
             continue;
         }
@@ -0,0 +1,707 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DisplayListWireFormat.h"
+
+#include "AffineTransform.h"
+#include "DisplayList.h"
+#include "DisplayListItems.h"
+#include "FloatRoundedRect.h"
+#include "Image.h"
+#include <tuple>
+#include <wtf/FastMalloc.h>
+#include <wtf/ObjectIdentifier.h>
+#include <wtf/OptionSet.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/Variant.h>
+
+namespace WebCore {
+namespace DisplayList {
+
+static constexpr uint8_t numberOfItemTypes = static_cast<uint8_t>(ItemType::ApplyDeviceScaleFactor) + 1;
+
+class WireEncoder;
+class WireDecoder;
+
+template<typename T, typename = void> struct HasWireEncode : std::false_type { };
+template<typename T> struct HasWireEncode<T, std::void_t<decltype(std::declval<const T&>().encode(std::declval<WireEncoder&>()))>> : std::true_type { };
+
+template<typename E, typename = void> struct HasEnumTraits : std::false_type { };
+template<typename E> struct HasEnumTraits<E, std::void_t<typename EnumTraits<E>::values>> : std::true_type { };
+
+template<typename T, typename = void> struct HasWireDecode : std::false_type { };
+template<typename T> struct HasWireDecode<T, std::void_t<decltype(T::decode(std::declval<WireDecoder&>()))>>
+    : std::is_same<decltype(T::decode(std::declval<WireDecoder&>())), Optional<T>> { };
+
+// Appends the encoded form of item contents to a byte vector. Values are written unaligned and
+// in host byte order. Anything the wire format has no representation for (image data, patterns)
+// marks the encoder as failed rather than being silently dropped.
+class WireEncoder {
+public:
+    explicit WireEncoder(Vector<uint8_t>& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    bool hasFailed() const { return m_hasFailed; }
+
+    template<typename T> WireEncoder& operator<<(const T& value)
+    {
+        if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value)
+            appendBytes(&value, sizeof(value));
+        else if constexpr (HasWireEncode<T>::value)
+            value.encode(*this);
+        else
+            m_hasFailed = true;
+        return *this;
+    }
+
+    WireEncoder& operator<<(bool value)
+    {
+        return *this << static_cast<uint8_t>(value);
+    }
+
+    WireEncoder& operator<<(const FloatPoint& point)
+    {
+        return *this << point.x() << point.y();
+    }
+
+    WireEncoder& operator<<(const FloatSize& size)
+    {
+        return *this << size.width() << size.height();
+    }
+
+#if USE(CG)
+    WireEncoder& operator<<(const CGSize& size)
+    {
+        return *this << size.width << size.height;
+    }
+#endif
+
+    WireEncoder& operator<<(const FloatRect& rect)
+    {
+        return *this << rect.location() << rect.size();
+    }
+
+    WireEncoder& operator<<(const FloatRoundedRect& roundedRect)
+    {
+        auto& radii = roundedRect.radii();
+        return *this << roundedRect.rect() << radii.topLeft() << radii.topRight() << radii.bottomLeft() << radii.bottomRight();
+    }
+
+    WireEncoder& operator<<(const AffineTransform& transform)
+    {
+        return *this << transform.a() << transform.b() << transform.c() << transform.d() << transform.e() << transform.f();
+    }
+
+    WireEncoder& operator<<(Monostate)
+    {
+        return *this;
+    }
+
+    template<typename T> WireEncoder& operator<<(ObjectIdentifier<T> identifier)
+    {
+        return *this << identifier.toUInt64();
+    }
+
+    template<typename E> WireEncoder& operator<<(OptionSet<E> optionSet)
+    {
+        return *this << optionSet.toRaw();
+    }
+
+    template<typename T, size_t inlineCapacity> WireEncoder& operator<<(const Vector<T, inlineCapacity>& vector)
+    {
+        *this << static_cast<uint64_t>(vector.size());
+        for (auto& element : vector)
+            *this << element;
+        return *this;
+    }
+
+    template<typename... Types> WireEncoder& operator<<(const Variant<Types...>& variant)
+    {
+        *this << static_cast<uint32_t>(variant.index());
+        WTF::visit([this](auto& alternative) {
+            *this << alternative;
+        }, variant);
+        return *this;
+    }
+
+private:
+    void appendBytes(const void* bytes, size_t length)
+    {
+        m_buffer.append(static_cast<const uint8_t*>(bytes), length);
+    }
+
+    Vector<uint8_t>& m_buffer;
+    bool m_hasFailed { false };
+};
+
+// Reads values written by WireEncoder. Every read is bounds checked, since the buffer may come
+// from another process; once a read fails, all subsequent reads fail too.
+class WireDecoder {
+public:
+    WireDecoder(const uint8_t* data, size_t length)
+        : m_data(data)
+        , m_length(length)
+    {
+    }
+
+    bool isAtEnd() const { return m_offset == m_length; }
+    size_t remainingLength() const { return m_length - m_offset; }
+
+    template<typename T> WireDecoder& operator>>(Optional<T>& result)
+    {
+        if constexpr (HasWireDecode<T>::value)
+            result = T::decode(*this);
+        else {
+            T value;
+            if (decode(value))
+                result = WTFMove(value);
+            else
+                result = WTF::nullopt;
+        }
+        return *this;
+    }
+
+    template<typename T> bool decode(T& value)
+    {
+        if constexpr (std::is_enum<T>::value && HasEnumTraits<T>::value) {
+            // Enums are range checked before they are stored, since replaying switches on them.
+            std::underlying_type_t<T> rawValue;
+            if (!decodeBytes(&rawValue, sizeof(rawValue)) || !isValidEnum<T>(rawValue))
+                return false;
+            value = static_cast<T>(rawValue);
+            return true;
+        } else if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value)
+            return decodeBytes(&value, sizeof(value));
+        else if constexpr (HasWireDecode<T>::value) {
+            auto decodedValue = T::decode(*this);
+            if (!decodedValue)
+                return false;
+            value = WTFMove(*decodedValue);
+            return true;
+        } else
+            return false;
+    }
+
+    bool decode(bool& value)
+    {
+        uint8_t byte;
+        if (!decode(byte) || byte > 1)
+            return false;
+        value = byte;
+        return true;
+    }
+
+    bool decode(FloatPoint& point)
+    {
+        float x;
+        float y;
+        if (!decode(x) || !decode(y))
+            return false;
+        point = FloatPoint(x, y);
+        return true;
+    }
+
+    bool decode(FloatSize& size)
+    {
+        float width;
+        float height;
+        if (!decode(width) || !decode(height))
+            return false;
+        size = FloatSize(width, height);
+        return true;
+    }
+
+#if USE(CG)
+    bool decode(CGSize& size)
+    {
+        return decode(size.width) && decode(size.height);
+    }
+#endif
+
+    bool decode(FloatRect& rect)
+    {
+        FloatPoint location;
+        FloatSize size;
+        if (!decode(location) || !decode(size))
+            return false;
+        rect = FloatRect(location, size);
+        return true;
+    }
+
+    bool decode(FloatRoundedRect& roundedRect)
+    {
+        FloatRect rect;
+        FloatSize topLeft;
+        FloatSize topRight;
+        FloatSize bottomLeft;
+        FloatSize bottomRight;
+        if (!decode(rect) || !decode(topLeft) || !decode(topRight) || !decode(bottomLeft) || !decode(bottomRight))
+            return false;
+        roundedRect = FloatRoundedRect(rect, topLeft, topRight, bottomLeft, bottomRight);
+        return true;
+    }
+
+    bool decode(AffineTransform& transform)
+    {
+        double a, b, c, d, e, f;
+        if (!decode(a) || !decode(b) || !decode(c) || !decode(d) || !decode(e) || !decode(f))
+            return false;
+        transform = AffineTransform(a, b, c, d, e, f);
+        return true;
+    }
+
+    bool decode(Monostate&)
+    {
+        return true;
+    }
+
+    template<typename T> bool decode(ObjectIdentifier<T>& identifier)
+    {
+        uint64_t rawIdentifier;
+        if (!decode(rawIdentifier) || !ObjectIdentifier<T>::isValidIdentifier(rawIdentifier))
+            return false;
+        identifier = makeObjectIdentifier<T>(rawIdentifier);
+        return true;
+    }
+
+    template<typename E> bool decode(OptionSet<E>& optionSet)
+    {
+        decltype(optionSet.toRaw()) rawValue;
+        if (!decode(rawValue))
+            return false;
+        optionSet = OptionSet<E>::fromRaw(rawValue);
+        return true;
+    }
+
+    template<typename T, size_t inlineCapacity> bool decode(Vector<T, inlineCapacity>& vector)
+    {
+        uint64_t size;
+        // Every element takes up at least one byte, which bounds the allocation below by the
+        // size of the buffer rather than by an arbitrary length read from it.
+        if (!decode(size) || size > remainingLength())
+            return false;
+
+        Vector<T, inlineCapacity> result;
+        result.reserveInitialCapacity(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            Optional<T> element;
+            *this >> element;
+            if (!element)
+                return false;
+            result.uncheckedAppend(WTFMove(*element));
+        }
+        vector = WTFMove(result);
+        return true;
+    }
+
+    template<typename... Types> bool decode(Variant<Types...>& variant)
+    {
+        uint32_t index;
+        if (!decode(index))
+            return false;
+        return decodeVariantAlternative<0>(index, variant);
+    }
+
+private:
+    template<size_t alternativeIndex, typename... Types> bool decodeVariantAlternative(uint32_t index, Variant<Types...>& variant)
+    {
+        if constexpr (alternativeIndex >= sizeof...(Types))
+            return false;
+        else {
+            if (index != alternativeIndex)
+                return decodeVariantAlternative<alternativeIndex + 1>(index, variant);
+
+            Optional<std::tuple_element_t<alternativeIndex, std::tuple<Types...>>> alternative;
+            *this >> alternative;
+            if (!alternative)
+                return false;
+            variant = WTFMove(*alternative);
+            return true;
+        }
+    }
+
+    bool decodeBytes(void* bytes, size_t length)
+    {
+        if (m_hasFailed || length > remainingLength()) {
+            m_hasFailed = true;
+            return false;
+        }
+        memcpy(bytes, m_data + m_offset, length);
+        m_offset += length;
+        return true;
+    }
+
+    const uint8_t* m_data;
+    size_t m_length;
+    size_t m_offset { 0 };
+    bool m_hasFailed { false };
+};
+
+template<typename T> struct ItemTypeTag {
+    using Type = T;
+};
+
+// Calls the functor with the type of every out-of-line item that has a wire representation.
+// PutImageData would need the pixel data to be shared separately, and ClipToDrawingCommands
+// does not encode its nested display list yet, so both are left out.
+template<typename Functor>
+static auto visitEncodableOutOfLineItemType(ItemType type, Functor&& functor) -> decltype(functor(ItemTypeTag<FillPath> { }))
+{
+    switch (type) {
+    case ItemType::ClipOutToPath:
+        return functor(ItemTypeTag<ClipOutToPath> { });
+    case ItemType::ClipPath:
+        return functor(ItemTypeTag<ClipPath> { });
+    case ItemType::DrawFocusRingPath:
+        return functor(ItemTypeTag<DrawFocusRingPath> { });
+    case ItemType::DrawFocusRingRects:
+        return functor(ItemTypeTag<DrawFocusRingRects> { });
+    case ItemType::DrawGlyphs:
+        return functor(ItemTypeTag<DrawGlyphs> { });
+    case ItemType::DrawLinesForText:
+        return functor(ItemTypeTag<DrawLinesForText> { });
+    case ItemType::DrawPath:
+        return functor(ItemTypeTag<DrawPath> { });
+    case ItemType::FillCompositedRect:
+        return functor(ItemTypeTag<FillCompositedRect> { });
+    case ItemType::FillPath:
+        return functor(ItemTypeTag<FillPath> { });
+    case ItemType::FillRectWithColor:
+        return functor(ItemTypeTag<FillRectWithColor> { });
+    case ItemType::FillRectWithGradient:
+        return functor(ItemTypeTag<FillRectWithGradient> { });
+    case ItemType::FillRectWithRoundedHole:
+        return functor(ItemTypeTag<FillRectWithRoundedHole> { });
+    case ItemType::FillRoundedRect:
+        return functor(ItemTypeTag<FillRoundedRect> { });
+    case ItemType::SetLineDash:
+        return functor(ItemTypeTag<SetLineDash> { });
+    case ItemType::SetState:
+        return functor(ItemTypeTag<SetState> { });
+    case ItemType::StrokePath:
+        return functor(ItemTypeTag<StrokePath> { });
+    default:
+        return { };
+    }
+}
+
+static Optional<ItemHandle> decodeOutOfLineItem(const uint8_t* data, size_t dataLength, ItemType type, uint8_t* handleLocation)
+{
+    return visitEncodableOutOfLineItemType(type, [&](auto tag) -> Optional<ItemHandle> {
+        using ItemClass = typename decltype(tag)::Type;
+        WireDecoder decoder { data, dataLength };
+        auto item = ItemClass::decode(decoder);
+        if (!item || !decoder.isAtEnd())
+            return WTF::nullopt;
+
+        handleLocation[0] = static_cast<uint8_t>(type);
+        new (handleLocation + sizeof(uint64_t)) ItemClass(WTFMove(*item));
+        return {{ handleLocation }};
+    });
+}
+
+// Inline items are copied byte for byte by the display list iterator, so the ones with fields
+// that not every byte pattern is a valid value of are checked before they are replayed.
+static bool isValidInlineItem(ItemHandle item)
+{
+    switch (item.type()) {
+    case ItemType::SetInlineFillGradient:
+        return item.get<SetInlineFillGradient>().isValid();
+    case ItemType::SetLineCap:
+        return item.get<SetLineCap>().isValid();
+    case ItemType::SetLineJoin:
+        return item.get<SetLineJoin>().isValid();
+    case ItemType::ClipToImageBuffer:
+        return item.get<ClipToImageBuffer>().isValid();
+    case ItemType::DrawImageBuffer:
+        return item.get<DrawImageBuffer>().isValid();
+    case ItemType::DrawNativeImage:
+        return item.get<DrawNativeImage>().isValid();
+    case ItemType::DrawPattern:
+        return item.get<DrawPattern>().isValid();
+    case ItemType::DrawDotsForDocumentMarker:
+        return item.get<DrawDotsForDocumentMarker>().isValid();
+#if ENABLE(INLINE_PATH_DATA)
+    case ItemType::FillInlinePath:
+        return item.get<FillInlinePath>().isValid();
+#endif
+#if ENABLE(INLINE_PATH_DATA)
+    case ItemType::StrokeInlinePath:
+        return item.get<StrokeInlinePath>().isValid();
+#endif
+    case ItemType::PaintFrameForMedia:
+        return item.get<PaintFrameForMedia>().isValid();
+    case ItemType::FlushContext:
+        return item.get<FlushContext>().isValid();
+    default:
+        return true;
+    }
+}
+
+// Hands the out-of-line items that were decoded while validating the buffer to the display list
+// iterator, so that each of them is only decoded once.
+class WireFormatReadingClient final : public ItemBufferReadingClient {
+public:
+    ~WireFormatReadingClient()
+    {
+        for (auto& decodedItem : m_decodedItems)
+            destroyDecodedItem(decodedItem);
+    }
+
+    void appendDecodedItem(const uint8_t* data, uint8_t* itemBuffer)
+    {
+        m_decodedItems.append({ data, itemBuffer });
+    }
+
+private:
+    struct DecodedItem {
+        const uint8_t* data;
+        uint8_t* itemBuffer;
+    };
+
+    static void destroyDecodedItem(DecodedItem& decodedItem)
+    {
+        if (!decodedItem.itemBuffer)
+            return;
+        ItemHandle { decodedItem.itemBuffer }.destroy();
+        fastFree(std::exchange(decodedItem.itemBuffer, nullptr));
+    }
+
+    Optional<ItemHandle> WARN_UNUSED_RETURN decodeItem(const uint8_t* data, size_t, ItemType type, uint8_t* handleLocation) final
+    {
+        // Items are asked for in buffer order, minus the culled ones.
+        while (m_nextDecodedItem < m_decodedItems.size() && m_decodedItems[m_nextDecodedItem].data < data)
+            destroyDecodedItem(m_decodedItems[m_nextDecodedItem++]);
+        if (m_nextDecodedItem == m_decodedItems.size() || m_decodedItems[m_nextDecodedItem].data != data)
+            return WTF::nullopt;
+
+        auto& decodedItem = m_decodedItems[m_nextDecodedItem++];
+        auto handle = visitEncodableOutOfLineItemType(type, [&](auto tag) -> Optional<ItemHandle> {
+            using ItemClass = typename decltype(tag)::Type;
+            handleLocation[0] = static_cast<uint8_t>(type);
+            new (handleLocation + sizeof(uint64_t)) ItemClass(WTFMove(ItemHandle { decodedItem.itemBuffer }.get<ItemClass>()));
+            return {{ handleLocation }};
+        });
+        destroyDecodedItem(decodedItem);
+        return handle;
+    }
+
+    Vector<DecodedItem> m_decodedItems;
+    size_t m_nextDecodedItem { 0 };
+};
+
+static uint64_t itemLayoutFingerprint()
+{
+    static const uint64_t fingerprint = [] {
+        uint64_t hash = numberOfItemTypes;
+        for (uint8_t i = 0; i < numberOfItemTypes; ++i) {
+            auto type = static_cast<ItemType>(i);
+            hash = hash * 31 + ((paddedSizeOfTypeAndItemInBytes(type) << 1) | isInlineItem(type));
+        }
+        return hash;
+    }();
+    return fingerprint;
+}
+
+static size_t growZeroFilled(Vector<uint8_t>& data, size_t numberOfBytes)
+{
+    auto oldSize = data.size();
+    data.grow(oldSize + numberOfBytes);
+    memset(data.data() + oldSize, 0, numberOfBytes);
+    return oldSize;
+}
+
+Optional<Vector<uint8_t>> serializeToWireFormat(const DisplayList& displayList)
+{
+    Vector<uint8_t> data;
+    growZeroFilled(data, sizeof(WireFormatHeader));
+
+    for (auto value : displayList) {
+        auto item = value.item;
+        auto type = item.type();
+        // Buffer switches are an artifact of how the recording was chunked; the wire format
+        // is a single contiguous buffer.
+        if (type == ItemType::MetaCommandChangeItemBuffer)
+            continue;
+
+        if (isInlineItem(type)) {
+            auto paddedSizeOfTypeAndItem = paddedSizeOfTypeAndItemInBytes(type);
+            auto itemOffset = growZeroFilled(data, paddedSizeOfTypeAndItem);
+            data[itemOffset] = static_cast<uint8_t>(type);
+            memcpy(data.data() + itemOffset + sizeof(uint64_t), item.data + sizeof(uint64_t), paddedSizeOfTypeAndItem - sizeof(uint64_t));
+            continue;
+        }
+
+        auto itemOffset = growZeroFilled(data, 2 * sizeof(uint64_t));
+        data[itemOffset] = static_cast<uint8_t>(type);
+
+        WireEncoder encoder { data };
+        bool didEncode = visitEncodableOutOfLineItemType(type, [&](auto tag) {
+            item.get<typename decltype(tag)::Type>().encode(encoder);
+            return !encoder.hasFailed();
+        });
+        if (!didEncode)
+            return WTF::nullopt;
+
+        uint64_t dataLength = data.size() - itemOffset - 2 * sizeof(uint64_t);
+        memcpy(data.data() + itemOffset + sizeof(uint64_t), &dataLength, sizeof(dataLength));
+        growZeroFilled(data, roundUpToMultipleOf(alignof(uint64_t), dataLength) - dataLength);
+    }
+
+    WireFormatHeader header;
+    header.itemLayoutFingerprint = itemLayoutFingerprint();
+    header.itemDataLength = data.size() - sizeof(WireFormatHeader);
+    memcpy(data.data(), &header, sizeof(header));
+    return data;
+}
+
+static bool isValidHeader(const uint8_t* data, size_t length)
+{
+    if (!data || length < sizeof(WireFormatHeader))
+        return false;
+
+    WireFormatHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magicNumber != WireFormatHeader::magic || header.version != WireFormatHeader::currentVersion)
+        return false;
+
+    return header.itemLayoutFingerprint == itemLayoutFingerprint() && header.itemDataLength == length - sizeof(WireFormatHeader);
+}
+
+// Checks every item and decodes every out-of-line item, handing each decoded item's buffer to
+// the functor, which takes ownership of it.
+template<typename Functor>
+static bool validateItems(const uint8_t* itemData, size_t itemDataLength, Functor&& didDecodeOutOfLineItem)
+{
+    // Inline items are checked through a copy when the buffer isn't aligned the way ItemBuffer aligns them.
+    Vector<uint64_t, 32> alignedInlineItem;
+
+    auto* cursor = itemData;
+    auto* end = itemData + itemDataLength;
+    while (cursor != end) {
+        size_t remainingLength = end - cursor;
+        if (remainingLength < sizeof(uint64_t) || cursor[0] >= numberOfItemTypes)
+            return false;
+
+        auto type = static_cast<ItemType>(cursor[0]);
+        if (type == ItemType::MetaCommandChangeItemBuffer)
+            return false;
+
+        if (isInlineItem(type)) {
+            auto paddedSizeOfTypeAndItem = paddedSizeOfTypeAndItemInBytes(type);
+            if (paddedSizeOfTypeAndItem > remainingLength)
+                return false;
+
+            auto* itemBytes = const_cast<uint8_t*>(cursor);
+            if (reinterpret_cast<uintptr_t>(itemBytes) % alignof(uint64_t)) {
+                alignedInlineItem.resize(paddedSizeOfTypeAndItem / sizeof(uint64_t));
+                memcpy(alignedInlineItem.data(), cursor, paddedSizeOfTypeAndItem);
+                itemBytes = reinterpret_cast<uint8_t*>(alignedInlineItem.data());
+            }
+            if (!isValidInlineItem({ itemBytes }))
+                return false;
+
+            cursor += paddedSizeOfTypeAndItem;
+            continue;
+        }
+
+        if (remainingLength < 2 * sizeof(uint64_t))
+            return false;
+
+        uint64_t dataLength;
+        memcpy(&dataLength, cursor + sizeof(uint64_t), sizeof(dataLength));
+        if (dataLength > remainingLength - 2 * sizeof(uint64_t))
+            return false;
+
+        auto sizeInBuffer = 2 * sizeof(uint64_t) + roundUpToMultipleOf(alignof(uint64_t), dataLength);
+        if (sizeInBuffer > remainingLength)
+            return false;
+
+        auto* itemBuffer = static_cast<uint8_t*>(fastMalloc(paddedSizeOfTypeAndItemInBytes(type)));
+        if (!decodeOutOfLineItem(cursor + 2 * sizeof(uint64_t), dataLength, type, itemBuffer)) {
+            fastFree(itemBuffer);
+            return false;
+        }
+        didDecodeOutOfLineItem(cursor + 2 * sizeof(uint64_t), itemBuffer);
+
+        cursor += sizeInBuffer;
+    }
+    return true;
+}
+
+bool validateWireFormat(const uint8_t* data, size_t length)
+{
+    if (!isValidHeader(data, length))
+        return false;
+
+    return validateItems(data + sizeof(WireFormatHeader), length - sizeof(WireFormatHeader), [](const uint8_t*, uint8_t* itemBuffer) {
+        ItemHandle { itemBuffer }.destroy();
+        fastFree(itemBuffer);
+    });
+}
+
+Optional<ReplayResult> replayWireFormat(GraphicsContext& context, const uint8_t* data, size_t length, const ImageBufferHashMap& imageBuffers, const NativeImageHashMap& nativeImages, const FontRenderingResourceMap& fonts, const FloatRect& initialClip)
+{
+    if (!isValidHeader(data, length))
+        return WTF::nullopt;
+
+    auto itemDataLength = length - sizeof(WireFormatHeader);
+    if (!itemDataLength)
+        return ReplayResult { };
+
+    // The display list iterator reads items with the alignment ItemBuffer guarantees. Shared
+    // memory mappings are page aligned, so the copy is only made for callers that hand us a
+    // buffer at an arbitrary offset.
+    auto* itemData = data + sizeof(WireFormatHeader);
+    Vector<uint8_t> alignedItemData;
+    if (reinterpret_cast<uintptr_t>(itemData) % alignof(uint64_t)) {
+        alignedItemData.append(itemData, itemDataLength);
+        itemData = alignedItemData.data();
+    }
+
+    // Validation decodes the out-of-line items, and the reading client hands them to the iterator
+    // instead of decoding them again.
+    WireFormatReadingClient readingClient;
+    bool isValid = validateItems(itemData, itemDataLength, [&](const uint8_t* itemDataInBuffer, uint8_t* itemBuffer) {
+        readingClient.appendDecodedItem(itemDataInBuffer, itemBuffer);
+    });
+    if (!isValid)
+        return WTF::nullopt;
+
+    ItemBufferHandles handles;
+    handles.append(ItemBufferHandle { ItemBufferIdentifier::generate(), const_cast<uint8_t*>(itemData), itemDataLength });
+
+    DisplayList displayList { WTFMove(handles) };
+    displayList.setItemBufferClient(&readingClient);
+
+    Replayer replayer { context, displayList, &imageBuffers, &nativeImages, &fonts };
+    return replayer.replay(initialClip);
+}
+
+} // namespace DisplayList
+} // namespace WebCore
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "DisplayListReplayer.h"
+#include <wtf/Optional.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+class GraphicsContext;
+
+namespace DisplayList {
+
+class DisplayList;
+
+// The wire format is a flat, position-independent copy of a display list's item buffer, so
+// it can be written into shared memory and replayed in another process or thread without
+// re-encoding. It starts with a WireFormatHeader, followed by the items laid out exactly
+// as ItemBuffer lays them out for a reading client: inline items are stored as their
+// in-memory bytes, and out-of-line items as a length-prefixed encoding of their contents.
+// Images and fonts are referenced by RenderingResourceIdentifier and must be supplied by
+// the caller at replay time; gradients are encoded by value.
+//
+// Inline item bytes depend on the struct layout of the build that wrote them, so the
+// header carries a fingerprint of that layout, and buffers from a different build are
+// rejected instead of being misread.
+struct WireFormatHeader {
+    static constexpr uint32_t magic = 0x4c44'4b57; // "WKDL"
+    static constexpr uint32_t currentVersion = 1;
+
+    uint32_t magicNumber { magic };
+    uint32_t version { currentVersion };
+    uint64_t itemLayoutFingerprint { 0 };
+    uint64_t itemDataLength { 0 };
+};
+
+static_assert(sizeof(WireFormatHeader) == 3 * sizeof(uint64_t), "Items following the header must stay 8-byte aligned");
+
+// Returns WTF::nullopt if the display list contains an item that has no wire representation
+// (PutImageData, ClipToDrawingCommands, or state referencing a pattern).
+WEBCORE_EXPORT Optional<Vector<uint8_t>> serializeToWireFormat(const DisplayList&);
+
+// Checks that every item in the buffer is well formed, that the enum, bool and identifier
+// fields of inline items hold valid values, and that every out-of-line item decodes, without
+// touching any graphics state. The buffer may come from an untrusted source.
+WEBCORE_EXPORT bool validateWireFormat(const uint8_t* data, size_t length);
+
+// Validates and replays a buffer without re-encoding it. The display list iterator copies each
+// inline item out of the buffer as is; out-of-line items are decoded once, while the buffer is
+// validated, and handed to the iterator from there. Returns WTF::nullopt if the buffer fails
+// validation, in which case nothing is replayed.
+WEBCORE_EXPORT Optional<ReplayResult> replayWireFormat(GraphicsContext&, const uint8_t* data, size_t length, const ImageBufferHashMap&, const NativeImageHashMap&, const FontRenderingResourceMap&, const FloatRect& initialClip = { });
+
+// Records a mixed display list, serializes it and times validating and replaying the buffer.
+WEBCORE_EXPORT String runWireFormatBenchmark(unsigned iterations);
+
+// Flips bytes of a serialized display list at random, seeded so a failure can be reproduced,
+// and validates and replays each mutated buffer. Reports how many buffers were rejected.
+WEBCORE_EXPORT String runWireFormatFuzzer(unsigned iterations, unsigned seed);
+
+} // namespace DisplayList
+} // namespace WebCore
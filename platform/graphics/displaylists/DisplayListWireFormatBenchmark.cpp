@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DisplayListWireFormat.h"
+
+#include "DisplayList.h"
+#include "DisplayListDrawingContext.h"
+#include "FloatRoundedRect.h"
+#include "Gradient.h"
+#include "ImageBuffer.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/WeakRandom.h>
+#include <wtf/text/TextStream.h>
+
+namespace WebCore {
+namespace DisplayList {
+
+static const FloatSize wireFormatBenchmarkSize { 512, 512 };
+
+// A mix of inline items, inline items with enum fields, and out-of-line items, roughly in the
+// proportions a page paints them.
+static Optional<Vector<uint8_t>> recordWireFormatBenchmarkList()
+{
+    DrawingContext drawingContext { wireFormatBenchmarkSize };
+    auto& context = drawingContext.context();
+
+    auto gradient = Gradient::create(Gradient::LinearData { { 0, 0 }, { wireFormatBenchmarkSize.width(), 0 } });
+    gradient->addColorStop({ 0, Color::red });
+    gradient->addColorStop({ 1, Color::blue });
+
+    for (unsigned row = 0; row < 16; ++row) {
+        for (unsigned column = 0; column < 16; ++column) {
+            FloatRect cellRect { column * 32.f, row * 32.f, 32, 32 };
+            context.save();
+            context.clip(cellRect);
+            switch ((row + column) % 4) {
+            case 0:
+                context.setFillColor(SRGBA<uint8_t> { static_cast<uint8_t>(row * 16), static_cast<uint8_t>(column * 16), 128 });
+                context.fillRect(cellRect);
+                break;
+            case 1:
+                context.setFillGradient(gradient.copyRef());
+                context.fillRoundedRect(FloatRoundedRect { cellRect, FloatRoundedRect::Radii { 4 } }, Color::green);
+                break;
+            case 2: {
+                context.setLineCap(LineCap::Round);
+                context.setLineJoin(LineJoin::Bevel);
+                context.setStrokeThickness(2);
+                Path path;
+                path.moveTo(cellRect.minXMinYCorner());
+                path.addLineTo(cellRect.maxXMaxYCorner());
+                path.addLineTo(cellRect.minXMaxYCorner());
+                context.strokePath(path);
+                break;
+            }
+            case 3: {
+                Path path;
+                path.addEllipse(cellRect);
+                path.addRect(cellRect);
+                context.fillPath(path);
+                break;
+            }
+            }
+            context.restore();
+        }
+    }
+
+    return serializeToWireFormat(drawingContext.displayList());
+}
+
+String runWireFormatBenchmark(unsigned iterations)
+{
+    iterations = std::max(iterations, 1u);
+
+    auto data = recordWireFormatBenchmarkList();
+    if (!data)
+        return "The display list has no wire representation."_s;
+
+    auto imageBuffer = ImageBuffer::create(wireFormatBenchmarkSize, RenderingMode::Unaccelerated);
+    if (!imageBuffer)
+        return "The image buffer could not be created."_s;
+
+    Seconds validationTime;
+    Seconds replayTime;
+    size_t numberOfBytesRead = 0;
+    for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+        auto startTime = MonotonicTime::now();
+        if (!validateWireFormat(data->data(), data->size()))
+            return "The serialized display list failed validation."_s;
+        validationTime += MonotonicTime::now() - startTime;
+
+        // Replaying validates the buffer again, and decodes the out-of-line items while doing so.
+        startTime = MonotonicTime::now();
+        auto result = replayWireFormat(imageBuffer->context(), data->data(), data->size(), { }, { }, { });
+        replayTime += MonotonicTime::now() - startTime;
+        if (!result)
+            return "The serialized display list failed to replay."_s;
+        numberOfBytesRead = result->numberOfBytesRead;
+    }
+
+    TextStream stream;
+    stream << "Display list wire format benchmark: " << iterations << " iterations, " << data->size() << " bytes, " << numberOfBytesRead << " bytes replayed\n";
+    stream << "validate: " << (validationTime / iterations).milliseconds() << "ms/iteration\n";
+    stream << "validate and replay: " << (replayTime / iterations).milliseconds() << "ms/iteration\n";
+    return stream.release();
+}
+
+String runWireFormatFuzzer(unsigned iterations, unsigned seed)
+{
+    auto data = recordWireFormatBenchmarkList();
+    if (!data)
+        return "The display list has no wire representation."_s;
+
+    auto imageBuffer = ImageBuffer::create(wireFormatBenchmarkSize, RenderingMode::Unaccelerated);
+    if (!imageBuffer)
+        return "The image buffer could not be created."_s;
+
+    WeakRandom random { seed };
+    unsigned rejectedCount = 0;
+    unsigned replayedCount = 0;
+    for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+        // Flipping bytes of the header only exercises the header check, so most of them land in the items.
+        auto mutatedData = *data;
+        unsigned mutationCount = 1 + random.getUint32(8);
+        for (unsigned mutation = 0; mutation < mutationCount; ++mutation) {
+            auto offset = sizeof(WireFormatHeader) + random.getUint32(mutatedData.size() - sizeof(WireFormatHeader));
+            mutatedData[offset] ^= 1 << random.getUint32(8);
+        }
+        // Truncating the buffer is caught by the header, so the length it records is fixed up some of the time.
+        if (!random.getUint32(8)) {
+            auto truncatedLength = sizeof(WireFormatHeader) + random.getUint32(mutatedData.size() - sizeof(WireFormatHeader));
+            mutatedData.shrink(truncatedLength);
+            uint64_t itemDataLength = truncatedLength - sizeof(WireFormatHeader);
+            memcpy(mutatedData.data() + offsetof(WireFormatHeader, itemDataLength), &itemDataLength, sizeof(itemDataLength));
+        }
+
+        bool isValid = validateWireFormat(mutatedData.data(), mutatedData.size());
+        imageBuffer->context().save();
+        auto result = replayWireFormat(imageBuffer->context(), mutatedData.data(), mutatedData.size(), { }, { }, { });
+        imageBuffer->context().restore();
+        RELEASE_ASSERT(isValid == !!result);
+        if (result)
+            ++replayedCount;
+        else
+            ++rejectedCount;
+    }
+
+    TextStream stream;
+    stream << "Display list wire format fuzzer: seed " << seed << ", " << iterations << " mutated buffers, " << rejectedCount << " rejected, " << replayedCount << " replayed\n";
+    return stream.release();
+}
+
+} // namespace DisplayList
+} // namespace WebCore
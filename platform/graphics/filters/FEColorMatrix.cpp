@@ -33,6 +33,12 @@
 #include <Accelerate/Accelerate.h>
 #endif
 
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS) && CPU(ARM64)
+#include <arm_neon.h>
+#endif
+
 namespace WebCore {
 
 FEColorMatrix::FEColorMatrix(Filter& filter, ColorMatrixType type, const Vector<float>& values)
@@ -63,37 +69,131 @@ bool FEColorMatrix::setValues(const Vector<float> &values)
     return true;
 }
 
-inline void matrix(float& red, float& green, float& blue, float& alpha, const Vector<float>& values)
+static FEColorMatrix::Matrix saturateOrHueRotateMatrix(const float* components)
 {
-    float r = red;
-    float g = green;
-    float b = blue;
-    float a = alpha;
-
-    red     = values[ 0] * r + values[ 1] * g + values[ 2] * b + values[ 3] * a + values[ 4] * 255;
-    green   = values[ 5] * r + values[ 6] * g + values [7] * b + values[ 8] * a + values[ 9] * 255;
-    blue    = values[10] * r + values[11] * g + values[12] * b + values[13] * a + values[14] * 255;
-    alpha   = values[15] * r + values[16] * g + values[17] * b + values[18] * a + values[19] * 255;
+    return {
+        components[0], components[1], components[2], 0, 0,
+        components[3], components[4], components[5], 0, 0,
+        components[6], components[7], components[8], 0, 0,
+        0, 0, 0, 1, 0
+    };
 }
 
-inline void saturateAndHueRotate(float& red, float& green, float& blue, const float* components)
+// FIXME: this should use luminance(const ColorComponents<float>& sRGBCompontents).
+static FEColorMatrix::Matrix luminanceToAlphaMatrix()
 {
-    float r = red;
-    float g = green;
-    float b = blue;
+    return {
+        0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0,
+        0.2125f, 0.7154f, 0.0721f, 0, 0
+    };
+}
 
-    red     = r * components[0] + g * components[1] + b * components[2];
-    green   = r * components[3] + g * components[4] + b * components[5];
-    blue    = r * components[6] + g * components[7] + b * components[8];
+FEColorMatrix::Matrix FEColorMatrix::matrix() const
+{
+    Vector<float> values = normalizedFloats(m_values);
+    float components[9];
+
+    switch (m_type) {
+    case FECOLORMATRIX_TYPE_UNKNOWN:
+        break;
+    case FECOLORMATRIX_TYPE_MATRIX: {
+        Matrix matrix;
+        ASSERT(values.size() == matrix.size());
+        std::copy(values.begin(), values.begin() + matrix.size(), matrix.begin());
+        return matrix;
+    }
+    case FECOLORMATRIX_TYPE_SATURATE:
+        calculateSaturateComponents(components, values[0]);
+        return saturateOrHueRotateMatrix(components);
+    case FECOLORMATRIX_TYPE_HUEROTATE:
+        calculateHueRotateComponents(components, values[0]);
+        return saturateOrHueRotateMatrix(components);
+    case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
+        return luminanceToAlphaMatrix();
+    }
+
+    return {
+        1, 0, 0, 0, 0,
+        0, 1, 0, 0, 0,
+        0, 0, 1, 0, 0,
+        0, 0, 0, 1, 0
+    };
 }
 
-// FIXME: this should use luminance(const ColorComponents<float>& sRGBCompontents).
-inline void luminance(float& red, float& green, float& blue, float& alpha)
+// Rounds and clamps like Uint8ClampedArray::set().
+static inline uint8_t clampedByte(float value)
 {
-    alpha = 0.2125 * red + 0.7154 * green + 0.0721 * blue;
-    red = 0;
-    green = 0;
-    blue = 0;
+    if (!(value >= 0))
+        return 0;
+    if (value > 255)
+        return 255;
+    return lrintf(value);
+}
+
+// The vector paths add the same products in the same order as the scalar one, so all of them
+// produce the same bytes.
+void FEColorMatrix::applyMatrix(uint8_t* pixels, unsigned pixelCount, const Matrix& matrix)
+{
+    unsigned i = 0;
+
+#if CPU(X86_SSE2)
+    __m128 columns[4];
+    for (unsigned column = 0; column < 4; ++column)
+        columns[column] = _mm_setr_ps(matrix[column], matrix[5 + column], matrix[10 + column], matrix[15 + column]);
+    const __m128 offsets = _mm_setr_ps(matrix[4] * 255, matrix[9] * 255, matrix[14] * 255, matrix[19] * 255);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maximum = _mm_set1_ps(255);
+
+    for (; i < pixelCount; ++i, pixels += 4) {
+        __m128 result = _mm_mul_ps(columns[0], _mm_set1_ps(pixels[0]));
+        result = _mm_add_ps(result, _mm_mul_ps(columns[1], _mm_set1_ps(pixels[1])));
+        result = _mm_add_ps(result, _mm_mul_ps(columns[2], _mm_set1_ps(pixels[2])));
+        result = _mm_add_ps(result, _mm_mul_ps(columns[3], _mm_set1_ps(pixels[3])));
+        result = _mm_add_ps(result, offsets);
+
+        // Clamping first also turns NaN into 0, since _mm_max_ps() returns its second operand then.
+        __m128i bytes = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(result, zero), maximum));
+        bytes = _mm_packs_epi32(bytes, bytes);
+        bytes = _mm_packus_epi16(bytes, bytes);
+        uint32_t pixel = _mm_cvtsi128_si32(bytes);
+        memcpy(pixels, &pixel, sizeof(pixel));
+    }
+#elif HAVE(ARM_NEON_INTRINSICS) && CPU(ARM64)
+    float32x4_t columns[4];
+    for (unsigned column = 0; column < 4; ++column) {
+        float values[4] = { matrix[column], matrix[5 + column], matrix[10 + column], matrix[15 + column] };
+        columns[column] = vld1q_f32(values);
+    }
+    float offsetValues[4] = { matrix[4] * 255, matrix[9] * 255, matrix[14] * 255, matrix[19] * 255 };
+    const float32x4_t offsets = vld1q_f32(offsetValues);
+
+    for (; i < pixelCount; ++i, pixels += 4) {
+        float32x4_t result = vmulq_n_f32(columns[0], pixels[0]);
+        result = vaddq_f32(result, vmulq_n_f32(columns[1], pixels[1]));
+        result = vaddq_f32(result, vmulq_n_f32(columns[2], pixels[2]));
+        result = vaddq_f32(result, vmulq_n_f32(columns[3], pixels[3]));
+        result = vaddq_f32(result, offsets);
+
+        // The conversion rounds to nearest even and turns negative values and NaN into 0, and the
+        // narrowing saturates.
+        uint16x4_t halfwords = vqmovn_u32(vcvtnq_u32_f32(result));
+        uint8x8_t bytes = vqmovn_u16(vcombine_u16(halfwords, halfwords));
+        vst1_lane_u32(reinterpret_cast<uint32_t*>(pixels), vreinterpret_u32_u8(bytes), 0);
+    }
+#endif
+
+    for (; i < pixelCount; ++i, pixels += 4) {
+        float red = pixels[0];
+        float green = pixels[1];
+        float blue = pixels[2];
+        float alpha = pixels[3];
+        pixels[0] = clampedByte(matrix[ 0] * red + matrix[ 1] * green + matrix[ 2] * blue + matrix[ 3] * alpha + matrix[ 4] * 255);
+        pixels[1] = clampedByte(matrix[ 5] * red + matrix[ 6] * green + matrix[ 7] * blue + matrix[ 8] * alpha + matrix[ 9] * 255);
+        pixels[2] = clampedByte(matrix[10] * red + matrix[11] * green + matrix[12] * blue + matrix[13] * alpha + matrix[14] * 255);
+        pixels[3] = clampedByte(matrix[15] * red + matrix[16] * green + matrix[17] * blue + matrix[18] * alpha + matrix[19] * 255);
+    }
 }
 
 #if USE(ACCELERATE)
@@ -209,8 +309,9 @@ bool effectApplyAccelerated(Uint8ClampedArray& pixelArray, const Vector<float>&
 #endif
 
 template<ColorMatrixType filterType>
-void effectType(Uint8ClampedArray& pixelArray, const Vector<float>& values, IntSize bufferSize)
+void effectType(Uint8ClampedArray& pixelArray, const Vector<float>& values, const FEColorMatrix::Matrix& matrix, IntSize bufferSize)
 {
+#if USE(ACCELERATE)
     float components[9];
 
     if (filterType == FECOLORMATRIX_TYPE_SATURATE)
@@ -218,59 +319,18 @@ void effectType(Uint8ClampedArray& pixelArray, const Vector<float>& values, IntS
     else if (filterType == FECOLORMATRIX_TYPE_HUEROTATE)
         FEColorMatrix::calculateHueRotateComponents(components, values[0]);
 
-    unsigned pixelArrayLength = pixelArray.length();
-
-#if USE(ACCELERATE)
     if (effectApplyAccelerated<filterType>(pixelArray, values, components, bufferSize))
         return;
 #else
-    UNUSED_PARAM(bufferSize);
+    UNUSED_PARAM(values);
 #endif
 
-    switch (filterType) {
-    case FECOLORMATRIX_TYPE_MATRIX:
-        for (unsigned pixelByteOffset = 0; pixelByteOffset < pixelArrayLength; pixelByteOffset += 4) {
-            float red = pixelArray.item(pixelByteOffset);
-            float green = pixelArray.item(pixelByteOffset + 1);
-            float blue = pixelArray.item(pixelByteOffset + 2);
-            float alpha = pixelArray.item(pixelByteOffset + 3);
-            matrix(red, green, blue, alpha, values);
-            pixelArray.set(pixelByteOffset, red);
-            pixelArray.set(pixelByteOffset + 1, green);
-            pixelArray.set(pixelByteOffset + 2, blue);
-            pixelArray.set(pixelByteOffset + 3, alpha);
-        }
-        break;
-
-    case FECOLORMATRIX_TYPE_SATURATE:
-    case FECOLORMATRIX_TYPE_HUEROTATE:
-        for (unsigned pixelByteOffset = 0; pixelByteOffset < pixelArrayLength; pixelByteOffset += 4) {
-            float red = pixelArray.item(pixelByteOffset);
-            float green = pixelArray.item(pixelByteOffset + 1);
-            float blue = pixelArray.item(pixelByteOffset + 2);
-            float alpha = pixelArray.item(pixelByteOffset + 3);
-            saturateAndHueRotate(red, green, blue, components);
-            pixelArray.set(pixelByteOffset, red);
-            pixelArray.set(pixelByteOffset + 1, green);
-            pixelArray.set(pixelByteOffset + 2, blue);
-            pixelArray.set(pixelByteOffset + 3, alpha);
-        }
-        break;
-
-    case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
-        for (unsigned pixelByteOffset = 0; pixelByteOffset < pixelArrayLength; pixelByteOffset += 4) {
-            float red = pixelArray.item(pixelByteOffset);
-            float green = pixelArray.item(pixelByteOffset + 1);
-            float blue = pixelArray.item(pixelByteOffset + 2);
-            float alpha = pixelArray.item(pixelByteOffset + 3);
-            luminance(red, green, blue, alpha);
-            pixelArray.set(pixelByteOffset, red);
-            pixelArray.set(pixelByteOffset + 1, green);
-            pixelArray.set(pixelByteOffset + 2, blue);
-            pixelArray.set(pixelByteOffset + 3, alpha);
-        }
-        break;
-    }
+    ASSERT(pixelArray.length() == bufferSize.area().unsafeGet() * 4);
+    uint8_t* data = pixelArray.data();
+    int rowBytes = bufferSize.width() * 4;
+    FilterEffect::forEachRowBand(bufferSize, [&](int startY, int endY) {
+        FEColorMatrix::applyMatrix(data + startY * rowBytes, (endY - startY) * bufferSize.width(), matrix);
+    });
 }
 
 void FEColorMatrix::platformApplySoftware()
@@ -294,21 +354,22 @@ void FEColorMatrix::platformApplySoftware()
     IntSize pixelArrayDimensions = imageData->size();
 
     Vector<float> values = normalizedFloats(m_values);
-    
+    Matrix matrix = this->matrix();
+
     switch (m_type) {
     case FECOLORMATRIX_TYPE_UNKNOWN:
         break;
     case FECOLORMATRIX_TYPE_MATRIX:
-        effectType<FECOLORMATRIX_TYPE_MATRIX>(*pixelArray, values, pixelArrayDimensions);
+        effectType<FECOLORMATRIX_TYPE_MATRIX>(*pixelArray, values, matrix, pixelArrayDimensions);
         break;
     case FECOLORMATRIX_TYPE_SATURATE: 
-        effectType<FECOLORMATRIX_TYPE_SATURATE>(*pixelArray, values, pixelArrayDimensions);
+        effectType<FECOLORMATRIX_TYPE_SATURATE>(*pixelArray, values, matrix, pixelArrayDimensions);
         break;
     case FECOLORMATRIX_TYPE_HUEROTATE:
-        effectType<FECOLORMATRIX_TYPE_HUEROTATE>(*pixelArray, values, pixelArrayDimensions);
+        effectType<FECOLORMATRIX_TYPE_HUEROTATE>(*pixelArray, values, matrix, pixelArrayDimensions);
         break;
     case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
-        effectType<FECOLORMATRIX_TYPE_LUMINANCETOALPHA>(*pixelArray, values, pixelArrayDimensions);
+        effectType<FECOLORMATRIX_TYPE_LUMINANCETOALPHA>(*pixelArray, values, matrix, pixelArrayDimensions);
         setIsAlphaImage(true);
         break;
     }
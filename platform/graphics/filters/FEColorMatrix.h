@@ -24,6 +24,7 @@
 #include "FilterEffect.h"
 
 #include "Filter.h"
+#include <array>
 #include <wtf/Vector.h>
 
 namespace WebCore {
@@ -49,6 +50,14 @@ public:
     static inline void calculateSaturateComponents(float* components, float value);
     static inline void calculateHueRotateComponents(float* components, float value);
 
+    // The matrix of every type, in the layout of FECOLORMATRIX_TYPE_MATRIX values: for each result
+    // component, the factors of red, green, blue and alpha and an offset in units of 255.
+    using Matrix = std::array<float, 20>;
+    Matrix matrix() const;
+
+    // Rounds and clamps each result component to a byte.
+    static void applyMatrix(uint8_t* pixels, unsigned pixelCount, const Matrix&);
+
 private:
     FEColorMatrix(Filter&, ColorMatrixType, const Vector<float>&);
 
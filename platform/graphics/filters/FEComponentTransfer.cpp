@@ -121,17 +121,28 @@ void FEComponentTransfer::platformApplySoftware()
 
     IntRect drawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
     in->copyUnmultipliedResult(*pixelArray, drawingRect, operatingColorSpace());
-    unsigned pixelArrayLength = pixelArray->length();
+
+    // Table lookups do not vectorize, so this only gains from running on several threads.
+    IntSize size = imageResult->size();
+    ASSERT(pixelArray->length() == size.area().unsafeGet() * 4);
     uint8_t* data = pixelArray->data();
-    for (unsigned pixelOffset = 0; pixelOffset < pixelArrayLength; pixelOffset += 4) {
-        data[pixelOffset] = redTable[data[pixelOffset]];
-        data[pixelOffset + 1] = greenTable[data[pixelOffset + 1]];
-        data[pixelOffset + 2] = blueTable[data[pixelOffset + 2]];
-        data[pixelOffset + 3] = alphaTable[data[pixelOffset + 3]];
+    unsigned rowBytes = size.width() * 4;
+    forEachRowBand(size, [&](int startY, int endY) {
+        applyLookupTables(data + startY * rowBytes, (endY - startY) * size.width(), redTable, greenTable, blueTable, alphaTable);
+    });
+}
+
+void FEComponentTransfer::applyLookupTables(uint8_t* pixels, unsigned pixelCount, const LookupTable& redTable, const LookupTable& greenTable, const LookupTable& blueTable, const LookupTable& alphaTable)
+{
+    for (unsigned i = 0; i < pixelCount; ++i, pixels += 4) {
+        pixels[0] = redTable[pixels[0]];
+        pixels[1] = greenTable[pixels[1]];
+        pixels[2] = blueTable[pixels[2]];
+        pixels[3] = alphaTable[pixels[3]];
     }
 }
 
-void FEComponentTransfer::computeLookupTables(LookupTable& redTable, LookupTable& greenTable, LookupTable& blueTable, LookupTable& alphaTable)
+void FEComponentTransfer::computeLookupTables(LookupTable& redTable, LookupTable& greenTable, LookupTable& blueTable, LookupTable& alphaTable) const
 {
     for (unsigned i = 0; i < redTable.size(); ++i)
         redTable[i] = greenTable[i] = blueTable[i] = alphaTable[i] = i;
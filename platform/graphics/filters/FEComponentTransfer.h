@@ -61,22 +61,22 @@ public:
     ComponentTransferFunction blueFunction() const { return m_blueFunction; }
     ComponentTransferFunction alphaFunction() const { return m_alphaFunction; }
 
+    using LookupTable = std::array<uint8_t, 256>;
+    void computeLookupTables(LookupTable& redTable, LookupTable& greenTable, LookupTable& blueTable, LookupTable& alphaTable) const;
+    static void applyLookupTables(uint8_t* pixels, unsigned pixelCount, const LookupTable& redTable, const LookupTable& greenTable, const LookupTable& blueTable, const LookupTable& alphaTable);
+
 private:
     FEComponentTransfer(Filter&, const ComponentTransferFunction& redFunc, const ComponentTransferFunction& greenFunc,
                         const ComponentTransferFunction& blueFunc, const ComponentTransferFunction& alphaFunc);
 
      const char* filterName() const final { return "FEComponentTransfer"; }
 
-    using LookupTable = std::array<uint8_t, 256>;
-
     static void computeIdentityTable(LookupTable&, const ComponentTransferFunction&);
     static void computeTabularTable(LookupTable&, const ComponentTransferFunction&);
     static void computeDiscreteTable(LookupTable&, const ComponentTransferFunction&);
     static void computeLinearTable(LookupTable&, const ComponentTransferFunction&);
     static void computeGammaTable(LookupTable&, const ComponentTransferFunction&);
 
-    void computeLookupTables(LookupTable& redTable, LookupTable& greenTable, LookupTable& blueTable, LookupTable& alphaTable);
-
     void platformApplySoftware() override;
 
     WTF::TextStream& externalRepresentation(WTF::TextStream&, RepresentationType) const override;
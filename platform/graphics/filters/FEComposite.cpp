@@ -30,6 +30,10 @@
 #include "ImageData.h"
 #include <wtf/text/TextStream.h>
 
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#endif
+
 namespace WebCore {
 
 FEComposite::FEComposite(Filter& filter, const CompositeOperationType& type, float k1, float k2, float k3, float k4)
@@ -154,9 +158,58 @@ static inline void computeArithmeticPixelsUnclamped(unsigned char* source, unsig
     }
 }
 
+#if CPU(X86_SSE2)
+// Adds the same terms in the same order as computeArithmeticPixels(). Terms computeArithmeticPixels()
+// leaves out are zero here, which does not change the sum, and truncating then saturating to a byte
+// is what clampByte() does to the truncated result.
+static inline void computeArithmeticPixelsSSE2(const unsigned char* source, unsigned char* destination, int pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+    ASSERT(!(pixelArrayLength & 0xf));
+    const __m128 k1x4 = _mm_set1_ps(k1 / 255.0f);
+    const __m128 k2x4 = _mm_set1_ps(k2);
+    const __m128 k3x4 = _mm_set1_ps(k3);
+    const __m128 k4x4 = _mm_set1_ps(k4 * 255.0f);
+    const __m128i zero = _mm_setzero_si128();
+
+    auto compute = [&](__m128i sourceWords, __m128i destinationWords) {
+        __m128 i1 = _mm_cvtepi32_ps(sourceWords);
+        __m128 i2 = _mm_cvtepi32_ps(destinationWords);
+        __m128 result = _mm_add_ps(_mm_mul_ps(k2x4, i1), _mm_mul_ps(k3x4, i2));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(k1x4, i1), i2));
+        result = _mm_add_ps(result, k4x4);
+        return _mm_cvttps_epi32(result);
+    };
+
+    for (int offset = 0; offset < pixelArrayLength; offset += 16) {
+        __m128i sourceBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+        __m128i destinationBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + offset));
+        __m128i sourceHalfwords[2] = { _mm_unpacklo_epi8(sourceBytes, zero), _mm_unpackhi_epi8(sourceBytes, zero) };
+        __m128i destinationHalfwords[2] = { _mm_unpacklo_epi8(destinationBytes, zero), _mm_unpackhi_epi8(destinationBytes, zero) };
+
+        __m128i resultHalfwords[2];
+        for (unsigned half = 0; half < 2; ++half) {
+            __m128i low = compute(_mm_unpacklo_epi16(sourceHalfwords[half], zero), _mm_unpacklo_epi16(destinationHalfwords[half], zero));
+            __m128i high = compute(_mm_unpackhi_epi16(sourceHalfwords[half], zero), _mm_unpackhi_epi16(destinationHalfwords[half], zero));
+            resultHalfwords[half] = _mm_packs_epi32(low, high);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset), _mm_packus_epi16(resultHalfwords[0], resultHalfwords[1]));
+    }
+}
+#endif
+
 #if !HAVE(ARM_NEON_INTRINSICS)
 static inline void arithmeticSoftware(unsigned char* source, unsigned char* destination, int pixelArrayLength, float k1, float k2, float k3, float k4)
 {
+#if CPU(X86_SSE2)
+    int vectorLength = pixelArrayLength & ~0xf;
+    computeArithmeticPixelsSSE2(source, destination, vectorLength, k1, k2, k3, k4);
+    source += vectorLength;
+    destination += vectorLength;
+    pixelArrayLength -= vectorLength;
+    if (!pixelArrayLength)
+        return;
+#endif
+
     float upperLimit = std::max(0.0f, k1) + std::max(0.0f, k2) + std::max(0.0f, k3) + k4;
     float lowerLimit = std::min(0.0f, k1) + std::min(0.0f, k2) + std::min(0.0f, k3) + k4;
     if ((k4 >= 0.0f && k4 <= 1.0f) && (upperLimit >= 0.0f && upperLimit <= 1.0f) && (lowerLimit >= 0.0f && lowerLimit <= 1.0f)) {
@@ -188,17 +241,22 @@ static inline void arithmeticSoftware(unsigned char* source, unsigned char* dest
 }
 #endif
 
-inline void FEComposite::platformArithmeticSoftware(const Uint8ClampedArray& source, Uint8ClampedArray& destination, float k1, float k2, float k3, float k4)
+inline void FEComposite::platformArithmeticSoftware(const Uint8ClampedArray& source, Uint8ClampedArray& destination, const IntSize& size, float k1, float k2, float k3, float k4)
 {
-    int length = source.length();
-    ASSERT(length == static_cast<int>(destination.length()));
-    // The selection here eventually should happen dynamically.
+    ASSERT(source.length() == destination.length());
+    ASSERT(destination.length() == size.area().unsafeGet() * 4);
+    int rowBytes = size.width() * 4;
+    forEachRowBand(size, [&](int startY, int endY) {
+        int offset = startY * rowBytes;
+        int length = (endY - startY) * rowBytes;
+        // The selection here eventually should happen dynamically.
 #if HAVE(ARM_NEON_INTRINSICS)
-    ASSERT(!(length & 0x3));
-    platformArithmeticNeon(source.data(), destination.data(), length, k1, k2, k3, k4);
+        ASSERT(!(length & 0x3));
+        platformArithmeticNeon(source.data() + offset, destination.data() + offset, length, k1, k2, k3, k4);
 #else
-    arithmeticSoftware(source.data(), destination.data(), length, k1, k2, k3, k4);
+        arithmeticSoftware(source.data() + offset, destination.data() + offset, length, k1, k2, k3, k4);
 #endif
+    });
 }
 
 void FEComposite::determineAbsolutePaintRect()
@@ -242,7 +300,7 @@ void FEComposite::platformApplySoftware()
         IntRect effectBDrawingRect = requestedRegionOfInputImageData(in2->absolutePaintRect());
         in2->copyPremultipliedResult(*dstPixelArray, effectBDrawingRect, operatingColorSpace());
 
-        platformArithmeticSoftware(*srcPixelArray, *dstPixelArray, m_k1, m_k2, m_k3, m_k4);
+        platformArithmeticSoftware(*srcPixelArray, *dstPixelArray, resultImage->size(), m_k1, m_k2, m_k3, m_k4);
         return;
     }
 
@@ -72,7 +72,7 @@ private:
     void platformApplySoftware() override;
     WTF::TextStream& externalRepresentation(WTF::TextStream&, RepresentationType) const override;
 
-    inline void platformArithmeticSoftware(const Uint8ClampedArray& source, Uint8ClampedArray& destination, float k1, float k2, float k3, float k4);
+    inline void platformArithmeticSoftware(const Uint8ClampedArray& source, Uint8ClampedArray& destination, const IntSize&, float k1, float k2, float k3, float k4);
 
 #if HAVE(ARM_NEON_INTRINSICS)
     template <int b1, int b4>
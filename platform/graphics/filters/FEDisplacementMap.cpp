@@ -131,24 +131,27 @@ void FEDisplacementMap::platformApplySoftware()
 
     int rowBytes = paintSize.width() * 4;
 
-    for (int y = 0; y < paintSize.height(); ++y) {
-        int lineStartOffset = y * rowBytes;
-
-        for (int x = 0; x < paintSize.width(); ++x) {
-            int dstIndex = lineStartOffset + x * 4;
-            
-            int srcX = x + static_cast<int>(scaleForColorX * displacementImage->item(dstIndex + displacementChannelX) + scaledOffsetX);
-            int srcY = y + static_cast<int>(scaleForColorY * displacementImage->item(dstIndex + displacementChannelY) + scaledOffsetY);
-
-            unsigned* dstPixelPtr = reinterpret_cast<unsigned*>(dstPixelArray->data() + dstIndex);
-            if (srcX < 0 || srcX >= paintSize.width() || srcY < 0 || srcY >= paintSize.height()) {
-                *dstPixelPtr = 0;
-                continue;
-            }
+    // Rows are independent: each one only reads the input images.
+    forEachRowBand(paintSize, [&](int startY, int endY) {
+        for (int y = startY; y < endY; ++y) {
+            int lineStartOffset = y * rowBytes;
+
+            for (int x = 0; x < paintSize.width(); ++x) {
+                int dstIndex = lineStartOffset + x * 4;
+
+                int srcX = x + static_cast<int>(scaleForColorX * displacementImage->item(dstIndex + displacementChannelX) + scaledOffsetX);
+                int srcY = y + static_cast<int>(scaleForColorY * displacementImage->item(dstIndex + displacementChannelY) + scaledOffsetY);
 
-            *dstPixelPtr = *reinterpret_cast<unsigned*>(inputImage->data() + byteOffsetOfPixel(srcX, srcY, rowBytes));
+                unsigned* dstPixelPtr = reinterpret_cast<unsigned*>(dstPixelArray->data() + dstIndex);
+                if (srcX < 0 || srcX >= paintSize.width() || srcY < 0 || srcY >= paintSize.height()) {
+                    *dstPixelPtr = 0;
+                    continue;
+                }
+
+                *dstPixelPtr = *reinterpret_cast<unsigned*>(inputImage->data() + byteOffsetOfPixel(srcX, srcY, rowBytes));
+            }
         }
-    }
+    });
 }
 
 static TextStream& operator<<(TextStream& ts, const ChannelSelectorType& type)
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "FEFusedColorTransform.h"
+
+#include "ImageData.h"
+#include <wtf/text/TextStream.h>
+
+namespace WebCore {
+
+FEFusedColorTransform::FEFusedColorTransform(Filter& filter)
+    : FilterEffect(filter, Type::FusedColorTransform)
+{
+}
+
+Ref<FEFusedColorTransform> FEFusedColorTransform::create(Filter& filter)
+{
+    return adoptRef(*new FEFusedColorTransform(filter));
+}
+
+bool FEFusedColorTransform::canFuse(const FilterEffect& effect)
+{
+    if (is<FEComponentTransfer>(effect))
+        return true;
+
+    if (!is<FEColorMatrix>(effect))
+        return false;
+
+    // Luminance to alpha makes an alpha image, which the stages do not track.
+    switch (downcast<FEColorMatrix>(effect).type()) {
+    case FECOLORMATRIX_TYPE_MATRIX:
+    case FECOLORMATRIX_TYPE_SATURATE:
+    case FECOLORMATRIX_TYPE_HUEROTATE:
+        return true;
+    case FECOLORMATRIX_TYPE_UNKNOWN:
+    case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
+        return false;
+    }
+    return false;
+}
+
+void FEFusedColorTransform::appendEffect(const FilterEffect& effect)
+{
+    ASSERT(canFuse(effect));
+
+    // Matrices are not multiplied together: each one rounds and clamps its result to bytes before
+    // the next one runs, as the effects it replaces do, so it gets a stage of its own.
+    if (is<FEColorMatrix>(effect)) {
+        m_stages.append({ downcast<FEColorMatrix>(effect).matrix(), WTF::nullopt });
+        return;
+    }
+
+    LookupTables lookupTables;
+    downcast<FEComponentTransfer>(effect).computeLookupTables(lookupTables[0], lookupTables[1], lookupTables[2], lookupTables[3]);
+
+    if (m_stages.isEmpty() || !m_stages.last().lookupTables) {
+        if (m_stages.isEmpty())
+            m_stages.append({ WTF::nullopt, WTF::nullopt });
+        m_stages.last().lookupTables = lookupTables;
+        return;
+    }
+
+    // Looking up a value in one table then another is looking it up in a table of the results.
+    auto& previousLookupTables = *m_stages.last().lookupTables;
+    for (unsigned component = 0; component < 4; ++component) {
+        for (auto& value : previousLookupTables[component])
+            value = lookupTables[component][value];
+    }
+}
+
+void FEFusedColorTransform::platformApplySoftware()
+{
+    FilterEffect* in = inputEffect(0);
+
+    auto* imageResult = createUnmultipliedImageResult();
+    auto* pixelArray = imageResult ? imageResult->data() : nullptr;
+    if (!pixelArray)
+        return;
+
+    IntRect drawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
+    in->copyUnmultipliedResult(*pixelArray, drawingRect, operatingColorSpace());
+
+    IntSize size = imageResult->size();
+    ASSERT(pixelArray->length() == size.area().unsafeGet() * 4);
+    uint8_t* data = pixelArray->data();
+    unsigned rowBytes = size.width() * 4;
+
+    // Every stage runs over a band while it is still in cache.
+    forEachRowBand(size, [&](int startY, int endY) {
+        uint8_t* pixels = data + startY * rowBytes;
+        unsigned pixelCount = (endY - startY) * size.width();
+        for (auto& stage : m_stages) {
+            if (stage.matrix)
+                FEColorMatrix::applyMatrix(pixels, pixelCount, *stage.matrix);
+            if (stage.lookupTables) {
+                auto& lookupTables = *stage.lookupTables;
+                FEComponentTransfer::applyLookupTables(pixels, pixelCount, lookupTables[0], lookupTables[1], lookupTables[2], lookupTables[3]);
+            }
+        }
+    });
+}
+
+TextStream& FEFusedColorTransform::externalRepresentation(TextStream& ts, RepresentationType representation) const
+{
+    ts << indent << "[feFusedColorTransform";
+    FilterEffect::externalRepresentation(ts, representation);
+    ts << " stages=\"" << m_stages.size() << "\"]\n";
+
+    TextStream::IndentScope indentScope(ts);
+    inputEffect(0)->externalRepresentation(ts, representation);
+    return ts;
+}
+
+} // namespace WebCore
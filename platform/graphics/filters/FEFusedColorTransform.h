@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "FEColorMatrix.h"
+#include "FEComponentTransfer.h"
+#include "FilterEffect.h"
+
+namespace WebCore {
+
+// Runs a chain of FEColorMatrix and FEComponentTransfer effects as one effect, which makes a
+// single pass over the pixels and has no intermediate results. The chain is kept as stages of
+// a matrix followed by lookup tables, each rounding and clamping its result to bytes like the
+// effects it replaces. Consecutive lookup tables fold into one, since composing them is exact;
+// matrices never do, so that the rounding between them is kept.
+class FEFusedColorTransform : public FilterEffect {
+public:
+    static Ref<FEFusedColorTransform> create(Filter&);
+
+    static bool canFuse(const FilterEffect&);
+
+    // Appends the work of an effect for which canFuse() is true. The effect itself is not kept.
+    void appendEffect(const FilterEffect&);
+
+private:
+    FEFusedColorTransform(Filter&);
+
+    const char* filterName() const final { return "FEFusedColorTransform"; }
+
+    void platformApplySoftware() override;
+
+    WTF::TextStream& externalRepresentation(WTF::TextStream&, RepresentationType) const override;
+
+    using LookupTables = std::array<FEComponentTransfer::LookupTable, 4>;
+
+    struct Stage {
+        Optional<FEColorMatrix::Matrix> matrix;
+        Optional<LookupTables> lookupTables;
+    };
+
+    Vector<Stage> m_stages;
+};
+
+} // namespace WebCore
+
+SPECIALIZE_TYPE_TRAITS_BEGIN(WebCore::FEFusedColorTransform)
+    static bool isType(const WebCore::FilterEffect& effect) { return effect.filterEffectClassType() == WebCore::FilterEffect::Type::FusedColorTransform; }
+SPECIALIZE_TYPE_TRAITS_END()
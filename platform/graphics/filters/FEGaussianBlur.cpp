@@ -42,6 +42,12 @@
 #include <wtf/MathExtras.h>
 #include <wtf/ParallelJobs.h>
 
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include <arm_neon.h>
+#endif
+
 static inline float gaussianKernelFactor()
 {
     return 3 / 4.f * sqrtf(2 * piFloat);
@@ -49,6 +55,13 @@ static inline float gaussianKernelFactor()
 
 static const int gMaxKernelSize = 500;
 
+// Blurs whose kernels are at least twice this size run on a copy of the image that is downsampled
+// by a power of two, chosen so that the downsampled kernels are still at least this size. Rounding
+// the downsampled kernel size then changes the blur radius by 3% at most, and the box averaging of
+// the downsampling and the bilinear upsampling together add less than 1% to it.
+static const int gMinDownsampledKernelSize = 16;
+static const int gMaxDownsamplingFactor = 8;
+
 namespace WebCore {
 
 inline void kernelPosition(int blurIteration, unsigned& radius, int& deltaLeft, int& deltaRight)
@@ -279,6 +292,153 @@ inline void boxBlur(const Uint8ClampedArray& srcPixelArray, Uint8ClampedArray& d
     }
 }
 
+// Adds addedRow to and subtracts removedRow from the sums, one sum per byte.
+static inline void slideSums(int* sums, const uint8_t* addedRow, const uint8_t* removedRow, unsigned length)
+{
+    unsigned i = 0;
+
+#if CPU(X86_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i added = _mm_loadu_si128(reinterpret_cast<const __m128i*>(addedRow + i));
+        __m128i removed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(removedRow + i));
+        __m128i differences[2] = {
+            _mm_sub_epi16(_mm_unpacklo_epi8(added, zero), _mm_unpacklo_epi8(removed, zero)),
+            _mm_sub_epi16(_mm_unpackhi_epi8(added, zero), _mm_unpackhi_epi8(removed, zero))
+        };
+        auto* sumVectors = reinterpret_cast<__m128i*>(sums + i);
+        for (unsigned half = 0; half < 2; ++half) {
+            // Interleaving the 16-bit differences with themselves and shifting them back extends their sign.
+            __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(differences[half], differences[half]), 16);
+            __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(differences[half], differences[half]), 16);
+            _mm_storeu_si128(sumVectors, _mm_add_epi32(_mm_loadu_si128(sumVectors), low));
+            ++sumVectors;
+            _mm_storeu_si128(sumVectors, _mm_add_epi32(_mm_loadu_si128(sumVectors), high));
+            ++sumVectors;
+        }
+    }
+#elif HAVE(ARM_NEON_INTRINSICS)
+    // FIXME: This NEON path and the one in storeAverages() have not been run yet; check them against the scalar loop on ARM.
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t added = vld1q_u8(addedRow + i);
+        uint8x16_t removed = vld1q_u8(removedRow + i);
+        int16x8_t differences[2] = {
+            vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(added), vget_low_u8(removed))),
+            vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(added), vget_high_u8(removed)))
+        };
+        int* sum = sums + i;
+        for (unsigned half = 0; half < 2; ++half, sum += 8) {
+            vst1q_s32(sum, vaddw_s16(vld1q_s32(sum), vget_low_s16(differences[half])));
+            vst1q_s32(sum + 4, vaddw_s16(vld1q_s32(sum + 4), vget_high_s16(differences[half])));
+        }
+    }
+#endif
+
+    for (; i < length; ++i)
+        sums[i] += addedRow[i] - removedRow[i];
+}
+
+// Stores sum / dx for each sum. The sums are below 2^24, so they convert to float exactly, and adding
+// half of 1 / dx keeps the rounding errors of the multiplication from changing the truncated result.
+static inline void storeAverages(uint8_t* row, const int* sums, unsigned length, unsigned dx)
+{
+    float reciprocal = 1.f / dx;
+    float bias = 0.5f / dx;
+    unsigned i = 0;
+
+#if CPU(X86_SSE2)
+    const __m128 reciprocalVector = _mm_set1_ps(reciprocal);
+    const __m128 biasVector = _mm_set1_ps(bias);
+    auto averages = [&](const int* fourSums) {
+        __m128 values = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(fourSums)));
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(values, reciprocalVector), biasVector));
+    };
+    for (; i + 16 <= length; i += 16) {
+        __m128i low = _mm_packs_epi32(averages(sums + i), averages(sums + i + 4));
+        __m128i high = _mm_packs_epi32(averages(sums + i + 8), averages(sums + i + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_packus_epi16(low, high));
+    }
+#elif HAVE(ARM_NEON_INTRINSICS)
+    float32x4_t reciprocalVector = vdupq_n_f32(reciprocal);
+    float32x4_t biasVector = vdupq_n_f32(bias);
+    auto averages = [&](const int* fourSums) {
+        float32x4_t values = vcvtq_f32_s32(vld1q_s32(fourSums));
+        return vqmovun_s32(vcvtq_s32_f32(vaddq_f32(vmulq_f32(values, reciprocalVector), biasVector)));
+    };
+    for (; i + 16 <= length; i += 16) {
+        uint8x8_t low = vqmovn_u16(vcombine_u16(averages(sums + i), averages(sums + i + 4)));
+        uint8x8_t high = vqmovn_u16(vcombine_u16(averages(sums + i + 8), averages(sums + i + 12)));
+        vst1q_u8(row + i, vcombine_u8(low, high));
+    }
+#endif
+
+    for (; i < length; ++i)
+        row[i] = static_cast<uint8_t>(sums[i] * reciprocal + bias);
+}
+
+// The alpha only versions of slideSums() and storeAverages(), with one sum per pixel. Like boxBlurAlphaOnly(),
+// they never touch the color channels, which are left uninitialized in the temporary buffer of an alpha image.
+static inline void slideAlphaSums(int* sums, const uint8_t* addedRow, const uint8_t* removedRow, unsigned pixelCount)
+{
+    for (unsigned i = 0; i < pixelCount; ++i)
+        sums[i] += addedRow[i * 4 + 3] - removedRow[i * 4 + 3];
+}
+
+static inline void storeAlphaAverages(uint8_t* row, const int* sums, unsigned pixelCount, unsigned dy)
+{
+    for (unsigned i = 0; i < pixelCount; ++i)
+        row[i * 4 + 3] = static_cast<uint8_t>(sums[i] / dy);
+}
+
+// Produces what boxBlur() does along the columns of the image, but walks it one row at a time and
+// slides the sums of all the columns down together. This reads the image in memory order and works
+// on whole rows, whatever the kernel size.
+inline void boxBlurColumns(const Uint8ClampedArray& srcPixelArray, Uint8ClampedArray& dstPixelArray,
+    unsigned dy, int dyTop, int dyBottom, int strideLine, int effectHeight, bool alphaImage, EdgeModeType edgeMode)
+{
+    const uint8_t* srcData = srcPixelArray.data();
+    uint8_t* dstData = dstPixelArray.data();
+    auto row = [&](int y) {
+        return srcData + y * strideLine;
+    };
+
+    unsigned sumCount = alphaImage ? strideLine / 4 : strideLine;
+    Vector<int> sums(sumCount, 0);
+    Vector<uint8_t> zeroRow(strideLine, 0);
+    auto slide = [&](const uint8_t* addedRow, const uint8_t* removedRow) {
+        if (alphaImage)
+            slideAlphaSums(sums.data(), addedRow, removedRow, sumCount);
+        else
+            slideSums(sums.data(), addedRow, removedRow, sumCount);
+    };
+
+    // Fill the kernel. With edgeMode 'duplicate', the rows above and below the image are copies of
+    // the first and last rows.
+    if (edgeMode == EDGEMODE_NONE) {
+        for (int y = 0; y < std::min(dyBottom, effectHeight); ++y)
+            slide(row(y), zeroRow.data());
+    } else {
+        for (int y = -dyTop; y < dyBottom; ++y)
+            slide(row(clampTo<int>(y, 0, effectHeight - 1)), zeroRow.data());
+    }
+
+    // Blurring.
+    for (int y = 0; y < effectHeight; ++y) {
+        if (alphaImage)
+            storeAlphaAverages(dstData + y * strideLine, sums.data(), sumCount, dy);
+        else
+            storeAverages(dstData + y * strideLine, sums.data(), sumCount, dy);
+
+        // Shift kernel.
+        if (edgeMode == EDGEMODE_NONE) {
+            const uint8_t* removedRow = y >= dyTop ? row(y - dyTop) : zeroRow.data();
+            const uint8_t* addedRow = y + dyBottom < effectHeight ? row(y + dyBottom) : zeroRow.data();
+            slide(addedRow, removedRow);
+        } else
+            slide(row(std::min(y + dyBottom, effectHeight - 1)), row(std::max(y - dyTop, 0)));
+    }
+}
+
 #if USE(ACCELERATE)
 inline void accelerateBoxBlur(Uint8ClampedArray& ioBuffer, Uint8ClampedArray& tempBuffer, unsigned kernelSize, int stride, int effectWidth, int effectHeight)
 {
@@ -352,14 +512,8 @@ inline void standardBoxBlur(Uint8ClampedArray& ioBuffer, Uint8ClampedArray& temp
 
         if (kernelSizeY) {
             kernelPosition(i, kernelSizeY, dyLeft, dyRight);
-#if HAVE(ARM_NEON_INTRINSICS)
-            if (!isAlphaImage)
-                boxBlurNEON(*fromBuffer, *toBuffer, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width());
-            else
-                boxBlur(*fromBuffer, *toBuffer, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), true, edgeMode);
-#else
-            boxBlur(*fromBuffer, *toBuffer, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), isAlphaImage, edgeMode);
-#endif
+            // The alpha only blur ignores the edge mode.
+            boxBlurColumns(*fromBuffer, *toBuffer, kernelSizeY, dyLeft, dyRight, stride, paintSize.height(), isAlphaImage, isAlphaImage ? EDGEMODE_NONE : edgeMode);
             std::swap(fromBuffer, toBuffer);
         }
     }
@@ -367,7 +521,12 @@ inline void standardBoxBlur(Uint8ClampedArray& ioBuffer, Uint8ClampedArray& temp
     // The final result should be stored in ioBuffer.
     if (&ioBuffer != fromBuffer) {
         ASSERT(ioBuffer.length() == fromBuffer->length());
-        memcpy(ioBuffer.data(), fromBuffer->data(), ioBuffer.length());
+        if (isAlphaImage) {
+            // Only the alpha channel of the temporary buffer was written.
+            for (unsigned i = 3; i < ioBuffer.length(); i += 4)
+                ioBuffer.data()[i] = fromBuffer->data()[i];
+        } else
+            memcpy(ioBuffer.data(), fromBuffer->data(), ioBuffer.length());
     }
 }
 
@@ -461,6 +620,119 @@ inline void FEGaussianBlur::platformApply(Uint8ClampedArray& ioBuffer, Uint8Clam
     platformApplyGeneric(ioBuffer, tmpPixelArray, kernelSizeX, kernelSizeY, paintSize);
 }
 
+static int downsamplingFactorForKernelSize(int kernelSize)
+{
+    int factor = 1;
+    while (factor < gMaxDownsamplingFactor && kernelSize / (2 * factor) >= gMinDownsampledKernelSize)
+        factor *= 2;
+    return factor;
+}
+
+// Averages each factor-sized block of pixels, or the part of it inside the image.
+static void downsample(const uint8_t* source, const IntSize& size, uint8_t* destination, const IntSize& downsampledSize, const IntSize& factor)
+{
+    for (int y = 0; y < downsampledSize.height(); ++y) {
+        int startY = y * factor.height();
+        int endY = std::min(startY + factor.height(), size.height());
+        for (int x = 0; x < downsampledSize.width(); ++x) {
+            int startX = x * factor.width();
+            int endX = std::min(startX + factor.width(), size.width());
+            unsigned sums[4] = { };
+            for (int sourceY = startY; sourceY < endY; ++sourceY) {
+                const uint8_t* pixel = source + 4 * (sourceY * size.width() + startX);
+                for (int sourceX = startX; sourceX < endX; ++sourceX, pixel += 4) {
+                    for (unsigned channel = 0; channel < 4; ++channel)
+                        sums[channel] += pixel[channel];
+                }
+            }
+            unsigned count = (endY - startY) * (endX - startX);
+            uint8_t* pixel = destination + 4 * (y * downsampledSize.width() + x);
+            for (unsigned channel = 0; channel < 4; ++channel)
+                pixel[channel] = (sums[channel] + count / 2) / count;
+        }
+    }
+}
+
+struct UpsamplingTap {
+    int first;
+    int second;
+    // The weight of the second pixel, in 1 / (2 * factor) units.
+    int weight;
+};
+
+// The center of pixel i of the upsampled image is at (2 * i + 1 - factor) / (2 * factor) in the
+// downsampled image, so with a power of two factor the interpolation is exact in integers.
+static Vector<UpsamplingTap> upsamplingTaps(int size, int downsampledSize, int factor)
+{
+    Vector<UpsamplingTap> taps(size);
+    for (int i = 0; i < size; ++i) {
+        int position = 2 * i + 1 - factor;
+        int first = position >= 0 ? position / (2 * factor) : -1;
+        taps[i] = { std::max(first, 0), std::min(first + 1, downsampledSize - 1), position - 2 * factor * first };
+    }
+    return taps;
+}
+
+static void upsample(const uint8_t* source, const IntSize& downsampledSize, uint8_t* destination, const IntSize& size, const IntSize& factor)
+{
+    auto columnTaps = upsamplingTaps(size.width(), downsampledSize.width(), factor.width());
+    auto rowTaps = upsamplingTaps(size.height(), downsampledSize.height(), factor.height());
+    int horizontalScale = 2 * factor.width();
+    int verticalScale = 2 * factor.height();
+    int totalScale = horizontalScale * verticalScale;
+
+    // Both source rows of a destination row are interpolated horizontally first.
+    Vector<int> rows[2] = { Vector<int>(4 * size.width()), Vector<int>(4 * size.width()) };
+    auto interpolateRow = [&](int y, Vector<int>& row) {
+        const uint8_t* sourceRow = source + 4 * y * downsampledSize.width();
+        for (int x = 0; x < size.width(); ++x) {
+            auto& tap = columnTaps[x];
+            for (unsigned channel = 0; channel < 4; ++channel)
+                row[4 * x + channel] = sourceRow[4 * tap.first + channel] * (horizontalScale - tap.weight) + sourceRow[4 * tap.second + channel] * tap.weight;
+        }
+    };
+
+    int interpolatedRows[2] = { -1, -1 };
+    for (int y = 0; y < size.height(); ++y) {
+        auto& tap = rowTaps[y];
+        if (interpolatedRows[0] != tap.first) {
+            if (interpolatedRows[1] == tap.first) {
+                std::swap(rows[0], rows[1]);
+                std::swap(interpolatedRows[0], interpolatedRows[1]);
+            } else {
+                interpolateRow(tap.first, rows[0]);
+                interpolatedRows[0] = tap.first;
+            }
+        }
+        if (interpolatedRows[1] != tap.second) {
+            interpolateRow(tap.second, rows[1]);
+            interpolatedRows[1] = tap.second;
+        }
+
+        uint8_t* destinationRow = destination + 4 * y * size.width();
+        for (int i = 0; i < 4 * size.width(); ++i)
+            destinationRow[i] = (rows[0][i] * (verticalScale - tap.weight) + rows[1][i] * tap.weight + totalScale / 2) / totalScale;
+    }
+}
+
+inline void FEGaussianBlur::platformApplyDownsampled(Uint8ClampedArray& ioBuffer, IntSize& paintSize, const IntSize& kernelSize, const IntSize& factor)
+{
+    IntSize downsampledSize((paintSize.width() + factor.width() - 1) / factor.width(), (paintSize.height() + factor.height() - 1) / factor.height());
+    auto downsampledKernelSize = [](int size, int sizeFactor) {
+        return size ? std::max(2, (size + sizeFactor / 2) / sizeFactor) : 0;
+    };
+
+    unsigned downsampledByteLength = (downsampledSize.area() * 4).unsafeGet();
+    auto downsampledImageData = Uint8ClampedArray::tryCreateUninitialized(downsampledByteLength);
+    auto tmpImageData = Uint8ClampedArray::tryCreateUninitialized(downsampledByteLength);
+    if (!downsampledImageData || !tmpImageData)
+        return;
+
+    downsample(ioBuffer.data(), paintSize, downsampledImageData->data(), downsampledSize, factor);
+    platformApply(*downsampledImageData, *tmpImageData, downsampledKernelSize(kernelSize.width(), factor.width()), downsampledKernelSize(kernelSize.height(), factor.height()), downsampledSize);
+    upsample(downsampledImageData->data(), downsampledSize, ioBuffer.data(), paintSize, factor);
+}
+
 static int clampedToKernelSize(float value)
 {
     // Limit the kernel size to 500. A bigger radius won't make a big difference for the result image but
@@ -540,6 +812,13 @@ void FEGaussianBlur::platformApplySoftware()
 
     IntSize paintSize = absolutePaintRect().size();
     paintSize.scale(filter().filterScale());
+
+    IntSize downsamplingFactor(downsamplingFactorForKernelSize(kernelSize.width()), downsamplingFactorForKernelSize(kernelSize.height()));
+    if (downsamplingFactor != IntSize(1, 1)) {
+        platformApplyDownsampled(*dstPixelArray, paintSize, kernelSize, downsamplingFactor);
+        return;
+    }
+
     auto tmpImageData = Uint8ClampedArray::tryCreateUninitialized((paintSize.area() * 4).unsafeGet());
     if (!tmpImageData)
         return;
@@ -75,6 +75,7 @@ private:
     static void platformApplyWorker(PlatformApplyParameters*);
     void platformApply(Uint8ClampedArray& ioBuffer, Uint8ClampedArray& tempBuffer, unsigned kernelSizeX, unsigned kernelSizeY, IntSize& paintSize);
     void platformApplyGeneric(Uint8ClampedArray& ioBuffer, Uint8ClampedArray& tempBuffer, unsigned kernelSizeX, unsigned kernelSizeY, IntSize& paintSize);
+    void platformApplyDownsampled(Uint8ClampedArray& ioBuffer, IntSize& paintSize, const IntSize& kernelSize, const IntSize& downsamplingFactor);
 
     float m_stdX;
     float m_stdY;
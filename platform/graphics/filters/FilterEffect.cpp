@@ -33,9 +33,12 @@
 #include "Logging.h"
 #include <JavaScriptCore/JSCInlines.h>
 #include <JavaScriptCore/TypedArrayInlines.h>
+#include <wtf/ParallelJobs.h>
 #include <wtf/text/TextStream.h>
 
-#if HAVE(ARM_NEON_INTRINSICS)
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS)
 #include <arm_neon.h>
 #endif
 
@@ -195,20 +198,80 @@ void FilterEffect::apply()
     platformApplySoftware();
 }
 
-void FilterEffect::forceValidPreMultipliedPixels()
+// Point-wise work is cheap enough that smaller jobs cost more to dispatch than they save.
+static const int minimalRowBandJobArea = 256 * 256;
+static const int rowBandBytes = 256 * 1024;
+
+struct RowBandParameters {
+    const WTF::Function<void(int startY, int endY)>* function;
+    int startY;
+    int endY;
+    int bandHeight;
+};
+
+static void forEachRowBandWorker(RowBandParameters* parameters)
 {
-    // Must operate on pre-multiplied results; other formats cannot have invalid pixels.
-    if (!m_premultipliedImageResult)
+    for (int y = parameters->startY; y < parameters->endY; y += parameters->bandHeight)
+        (*parameters->function)(y, std::min(y + parameters->bandHeight, parameters->endY));
+}
+
+void FilterEffect::forEachRowBand(const IntSize& size, const WTF::Function<void(int startY, int endY)>& function)
+{
+    int width = size.width();
+    int height = size.height();
+    if (width <= 0 || height <= 0)
         return;
 
-    Uint8ClampedArray* imageArray = m_premultipliedImageResult->data();
-    uint8_t* pixelData = imageArray->data();
-    int pixelArrayLength = imageArray->length();
+    int bandHeight = std::max<int>(1, rowBandBytes / (static_cast<int64_t>(width) * 4));
+
+    unsigned maxNumThreads = height / 8;
+    unsigned optimalThreadNumber = std::min<uint64_t>(static_cast<uint64_t>(width) * height / minimalRowBandJobArea, maxNumThreads);
+    if (optimalThreadNumber > 1) {
+        WTF::ParallelJobs<RowBandParameters> parallelJobs(&forEachRowBandWorker, optimalThreadNumber);
+        auto numJobs = parallelJobs.numberOfJobs();
+        if (numJobs > 1) {
+            // Split the rows into "stepY"-sized jobs, distributing the extra rows into the first "jobsWithExtra" jobs.
+            int stepY = height / numJobs;
+            int jobsWithExtra = height % numJobs;
+            int startY = 0;
+            for (size_t job = 0; job < numJobs; ++job) {
+                RowBandParameters& parameters = parallelJobs.parameter(job);
+                parameters.function = &function;
+                parameters.startY = startY;
+                startY += job < static_cast<size_t>(jobsWithExtra) ? stepY + 1 : stepY;
+                parameters.endY = startY;
+                parameters.bandHeight = bandHeight;
+            }
+            parallelJobs.execute();
+            return;
+        }
+        // Fallback to single thread model
+    }
 
-    // We must have four bytes per pixel, and complete pixels
-    ASSERT(!(pixelArrayLength % 4));
+    RowBandParameters parameters { &function, 0, height, bandHeight };
+    forEachRowBandWorker(&parameters);
+}
+
+static void clampColorComponentsToAlpha(uint8_t* pixelData, int pixelArrayLength)
+{
+#if CPU(X86_SSE2)
+    if (pixelArrayLength >= 16) {
+        uint8_t* lastPixel = pixelData + (pixelArrayLength & ~0xf);
+        do {
+            // Spread the alpha byte of each pixel over the pixel; alpha itself is left unchanged.
+            __m128i fourPixels = _mm_loadu_si128(reinterpret_cast<__m128i*>(pixelData));
+            __m128i alpha = _mm_srli_epi32(fourPixels, 24);
+            alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+            alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixelData), _mm_min_epu8(fourPixels, alpha));
+            pixelData += 16;
+        } while (pixelData < lastPixel);
 
-#if HAVE(ARM_NEON_INTRINSICS)
+        pixelArrayLength &= 0xf;
+        if (!pixelArrayLength)
+            return;
+    }
+#elif HAVE(ARM_NEON_INTRINSICS)
     if (pixelArrayLength >= 64) {
         uint8_t* lastPixel = pixelData + (pixelArrayLength & ~0x3f);
         do {
@@ -244,6 +307,25 @@ void FilterEffect::forceValidPreMultipliedPixels()
     }
 }
 
+void FilterEffect::forceValidPreMultipliedPixels()
+{
+    // Must operate on pre-multiplied results; other formats cannot have invalid pixels.
+    if (!m_premultipliedImageResult)
+        return;
+
+    Uint8ClampedArray* imageArray = m_premultipliedImageResult->data();
+    IntSize size = m_premultipliedImageResult->size();
+
+    // We must have four bytes per pixel, and complete pixels
+    ASSERT(imageArray->length() == size.area().unsafeGet() * 4);
+
+    uint8_t* data = imageArray->data();
+    int rowBytes = size.width() * 4;
+    forEachRowBand(size, [&](int startY, int endY) {
+        clampColorComponentsToAlpha(data + startY * rowBytes, (endY - startY) * rowBytes);
+    });
+}
+
 void FilterEffect::clearResult()
 {
     m_imageBufferResult = nullptr;
@@ -27,6 +27,7 @@
 #include "IntRect.h"
 #include "IntRectExtent.h"
 #include <JavaScriptCore/Uint8ClampedArray.h>
+#include <wtf/Function.h>
 #include <wtf/MathExtras.h>
 #include <wtf/RefCounted.h>
 #include <wtf/RefPtr.h>
@@ -64,6 +65,7 @@ public:
         DisplacementMap,
         DropShadow,
         Flood,
+        FusedColorTransform,
         GaussianBlur,
         Image,
         Lighting,
@@ -179,6 +181,12 @@ public:
         return normalizedValues;
     }
 
+    // Calls the function on consecutive bands of rows covering an area of the given size, from
+    // several threads when the area is large enough. Each band is about the size of a cache, so a
+    // function can make several passes over its rows without reloading them. The function must
+    // only write to the rows it is given.
+    static void forEachRowBand(const IntSize&, const WTF::Function<void(int startY, int endY)>&);
+
 protected:
     FilterEffect(Filter&, Type);
     
@@ -59,14 +59,25 @@ public:
     static void replay(Buffer& buffer, const PaintingOperations& paintingOperations)
     {
         auto paintingContext = PaintingContext::createForPainting(buffer);
-        paintingContext->replay(paintingOperations);
+        paintingContext->replay(paintingOperations, WebCore::FloatRect::infiniteRect());
+    }
+
+    // Replays operations recorded for a larger area into the buffer. The functor sets up
+    // the buffer's context (clip, translation) so that the recorded device space lines up
+    // with the buffer, and operations whose bounds miss replayRect are skipped.
+    template<typename T>
+    static void replay(Buffer& buffer, const PaintingOperations& paintingOperations, const WebCore::FloatRect& replayRect, const T& prepareFunctor)
+    {
+        auto paintingContext = PaintingContext::createForPainting(buffer);
+        prepareFunctor(paintingContext->graphicsContext());
+        paintingContext->replay(paintingOperations, replayRect);
     }
 
     virtual ~PaintingContext() = default;
 
 protected:
     virtual WebCore::GraphicsContext& graphicsContext() = 0;
-    virtual void replay(const PaintingOperations&) = 0;
+    virtual void replay(const PaintingOperations&, const WebCore::FloatRect&) = 0;
 
 private:
     static std::unique_ptr<PaintingContext> createForPainting(Buffer&);
@@ -29,6 +29,7 @@
 #include "config.h"
 #include "NicosiaPaintingEngine.h"
 
+#include "NicosiaBuffer.h"
 #include "NicosiaPaintingEngineBasic.h"
 #include "NicosiaPaintingEngineThreaded.h"
 
@@ -58,4 +59,15 @@ std::unique_ptr<PaintingEngine> PaintingEngine::create()
     return std::unique_ptr<PaintingEngine>(new PaintingEngineBasic);
 }
 
+Vector<bool> PaintingEngine::paintTiles(WebCore::GraphicsLayer& layer, Vector<TileUpdate>&& tiles, float contentsScale)
+{
+    Vector<bool> didPaintTiles;
+    didPaintTiles.reserveInitialCapacity(tiles.size());
+    for (auto& tile : tiles) {
+        WebCore::IntRect targetRect { { }, tile.sourceRect.size() };
+        didPaintTiles.uncheckedAppend(paint(layer, WTFMove(tile.buffer), tile.sourceRect, tile.mappedSourceRect, targetRect, contentsScale));
+    }
+    return didPaintTiles;
+}
+
 } // namespace Nicosia
@@ -28,12 +28,13 @@
 
 #pragma once
 
+#include "IntRect.h"
 #include <memory>
 #include <wtf/Ref.h>
+#include <wtf/Vector.h>
 
 namespace WebCore {
 class GraphicsLayer;
-class IntRect;
 }
 
 namespace Nicosia {
@@ -48,6 +49,17 @@ public:
     virtual ~PaintingEngine() = default;
 
     virtual bool paint(WebCore::GraphicsLayer&, Ref<Buffer>&&, const WebCore::IntRect&, const WebCore::IntRect&, const WebCore::IntRect&, float) = 0;
+
+    struct TileUpdate {
+        Ref<Buffer> buffer;
+        WebCore::IntRect sourceRect;
+        WebCore::IntRect mappedSourceRect;
+    };
+
+    // Paints several tiles of the same layer. Each tile's buffer covers exactly its source rect.
+    // Returns whether each tile was painted, in the order of the tiles. The default implementation
+    // paints each tile separately.
+    virtual Vector<bool> paintTiles(WebCore::GraphicsLayer&, Vector<TileUpdate>&&, float);
 };
 
 } /// namespace Nicosia
@@ -35,6 +35,7 @@
 #include "GraphicsLayer.h"
 #include "NicosiaBuffer.h"
 #include "NicosiaPaintingContext.h"
+#include <wtf/ThreadSafeRefCounted.h>
 
 namespace Nicosia {
 using namespace WebCore;
@@ -59,6 +60,17 @@ static void paintLayer(GraphicsContext& context, GraphicsLayer& layer, const Int
     context.restore();
 }
 
+// A recording replayed into several tiles at once. The operations are const once recorded, and
+// PaintingOperation::execute() is const, so the replaying threads only ever read them.
+struct SharedPaintingOperations : ThreadSafeRefCounted<SharedPaintingOperations> {
+    explicit SharedPaintingOperations(PaintingOperations&& operations)
+        : operations(WTFMove(operations))
+    {
+    }
+
+    const PaintingOperations operations;
+};
+
 PaintingEngineThreaded::PaintingEngineThreaded(unsigned numThreads)
     : m_workerPool(WorkerPool::create("PaintingThread"_s, numThreads))
 {
@@ -87,6 +99,64 @@ bool PaintingEngineThreaded::paint(GraphicsLayer& layer, Ref<Buffer>&& buffer, c
     return true;
 }
 
+Vector<bool> PaintingEngineThreaded::paintTiles(GraphicsLayer& layer, Vector<TileUpdate>&& tiles, float contentsScale)
+{
+    // Record the layer contents once for the area covering all the tiles and replay that
+    // recording into each tile on the worker threads, instead of painting the layer once
+    // per tile. This only pays off when the tiles are mostly adjacent, since the recording
+    // covers the whole bounding rect.
+    IntRect sourceRect;
+    uint64_t tilesArea = 0;
+    for (auto& tile : tiles) {
+        sourceRect.unite(tile.sourceRect);
+        tilesArea += static_cast<uint64_t>(tile.sourceRect.width()) * tile.sourceRect.height();
+    }
+
+    uint64_t sourceArea = static_cast<uint64_t>(sourceRect.width()) * sourceRect.height();
+    if (tiles.size() < 2 || sourceArea > 2 * tilesArea)
+        return PaintingEngine::paintTiles(layer, WTFMove(tiles), contentsScale);
+
+    IntRect mappedSourceRect;
+    for (auto& tile : tiles)
+        mappedSourceRect.unite(tile.mappedSourceRect);
+
+    PaintingOperations paintingOperations;
+    PaintingContext::record(paintingOperations,
+        [&](GraphicsContext& context)
+        {
+            // The recorded device space is the contents-scaled layer space, so each tile's
+            // source rect can be used directly to cull the recorded operations.
+            context.clip(sourceRect);
+            context.scale(FloatSize(contentsScale, contentsScale));
+            layer.paintGraphicsLayerContents(context, mappedSourceRect);
+        });
+    auto recording = adoptRef(*new SharedPaintingOperations(WTFMove(paintingOperations)));
+
+    for (auto& tile : tiles) {
+        tile.buffer->beginPainting();
+
+        m_workerPool->postTask([recording = recording.copyRef(), buffer = WTFMove(tile.buffer), tileRect = tile.sourceRect] {
+            bool supportsAlpha = buffer->supportsAlpha();
+            PaintingContext::replay(buffer, recording->operations, tileRect,
+                [&](GraphicsContext& context)
+                {
+                    context.clip(IntRect(IntPoint::zero(), tileRect.size()));
+
+                    if (supportsAlpha) {
+                        context.setCompositeOperation(CompositeOperator::Copy);
+                        context.fillRect(IntRect(IntPoint::zero(), tileRect.size()), Color::transparentBlack);
+                        context.setCompositeOperation(CompositeOperator::SourceOver);
+                    }
+
+                    context.translate(-tileRect.x(), -tileRect.y());
+                });
+            buffer->completePainting();
+        });
+    }
+
+    return Vector<bool>(tiles.size(), true);
+}
+
 } // namespace Nicosia
 
 #endif // USE(COORDINATED_GRAPHICS)
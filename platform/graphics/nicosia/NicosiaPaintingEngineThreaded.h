@@ -42,6 +42,7 @@ public:
 
 private:
     bool paint(WebCore::GraphicsLayer&, Ref<Buffer>&&, const WebCore::IntRect&, const WebCore::IntRect&, const WebCore::IntRect&, float) override;
+    Vector<bool> paintTiles(WebCore::GraphicsLayer&, Vector<TileUpdate>&&, float) override;
 
     Ref<WorkerPool> m_workerPool;
 };
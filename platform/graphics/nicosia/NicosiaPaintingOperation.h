@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "FloatRect.h"
 #include <memory>
 #include <wtf/Vector.h>
 
@@ -42,8 +43,14 @@ struct PaintingOperationReplay { };
 struct PaintingOperation {
     WTF_MAKE_STRUCT_FAST_ALLOCATED;
     virtual ~PaintingOperation() = default;
-    virtual void execute(PaintingOperationReplay&) = 0;
+    // One recording can be replayed into several tiles at once on different threads, so executing
+    // an operation must leave it, and the data it refers to, unchanged.
+    virtual void execute(PaintingOperationReplay&) const = 0;
     virtual void dump(WTF::TextStream&) = 0;
+
+    // Device-space extent of the pixels this operation can touch, used to skip
+    // the operation when replaying into a region it doesn't intersect.
+    WebCore::FloatRect bounds { WebCore::FloatRect::infiniteRect() };
 };
 
 using PaintingOperations = Vector<std::unique_ptr<PaintingOperation>>;
@@ -30,6 +30,7 @@
 #include "NicosiaCairoOperationRecorder.h"
 
 #include "CairoOperations.h"
+#include "CairoUtilities.h"
 #include "FloatRoundedRect.h"
 #include "Gradient.h"
 #include "ImageBuffer.h"
@@ -72,6 +73,13 @@ auto createCommand() -> std::enable_if_t<std::is_base_of<OperationData<>, T>::va
     return makeUnique<T>();
 }
 
+static FloatRect inflatedRect(const FloatRect& rect, float delta)
+{
+    FloatRect inflated = rect;
+    inflated.inflate(delta);
+    return inflated;
+}
+
 CairoOperationRecorder::CairoOperationRecorder(GraphicsContext& context, PaintingOperations& commandList)
     : GraphicsContextImpl(context, FloatRect { }, AffineTransform { })
     , m_commandList(commandList)
@@ -85,7 +93,7 @@ void CairoOperationRecorder::updateState(const GraphicsContextState& state, Grap
         struct StrokeThicknessChange final : PaintingOperation, OperationData<float> {
             virtual ~StrokeThicknessChange() = default;
 
-            void execute(PaintingOperationReplay& replayer) override
+            void execute(PaintingOperationReplay& replayer) const override
             {
                 Cairo::State::setStrokeThickness(contextForReplay(replayer), arg<0>());
             }
@@ -103,7 +111,7 @@ void CairoOperationRecorder::updateState(const GraphicsContextState& state, Grap
         struct StrokeStyleChange final : PaintingOperation, OperationData<StrokeStyle> {
             virtual ~StrokeStyleChange() = default;
 
-            void execute(PaintingOperationReplay& replayer) override
+            void execute(PaintingOperationReplay& replayer) const override
             {
                 Cairo::State::setStrokeStyle(contextForReplay(replayer), arg<0>());
             }
@@ -121,7 +129,7 @@ void CairoOperationRecorder::updateState(const GraphicsContextState& state, Grap
         struct CompositeOperationChange final : PaintingOperation, OperationData<CompositeOperator, BlendMode> {
             virtual ~CompositeOperationChange() = default;
 
-            void execute(PaintingOperationReplay& replayer) override
+            void execute(PaintingOperationReplay& replayer) const override
             {
                 Cairo::State::setCompositeOperation(contextForReplay(replayer), arg<0>(), arg<1>());
             }
@@ -139,7 +147,7 @@ void CairoOperationRecorder::updateState(const GraphicsContextState& state, Grap
         struct ShouldAntialiasChange final : PaintingOperation, OperationData<bool> {
             virtual ~ShouldAntialiasChange() = default;
 
-            void execute(PaintingOperationReplay& replayer) override
+            void execute(PaintingOperationReplay& replayer) const override
             {
                 Cairo::State::setShouldAntialias(contextForReplay(replayer), arg<0>());
             }
@@ -163,7 +171,7 @@ void CairoOperationRecorder::setLineCap(LineCap lineCap)
     struct SetLineCap final : PaintingOperation, OperationData<LineCap> {
         virtual ~SetLineCap() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::setLineCap(contextForReplay(replayer), arg<0>());
         }
@@ -182,7 +190,7 @@ void CairoOperationRecorder::setLineDash(const DashArray& dashes, float dashOffs
     struct SetLineDash final : PaintingOperation, OperationData<DashArray, float> {
         virtual ~SetLineDash() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::setLineDash(contextForReplay(replayer), arg<0>(), arg<1>());
         }
@@ -201,7 +209,7 @@ void CairoOperationRecorder::setLineJoin(LineJoin lineJoin)
     struct SetLineJoin final : PaintingOperation, OperationData<LineJoin> {
         virtual ~SetLineJoin() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::setLineJoin(contextForReplay(replayer), arg<0>());
         }
@@ -220,7 +228,7 @@ void CairoOperationRecorder::setMiterLimit(float miterLimit)
     struct SetMiterLimit final : PaintingOperation, OperationData<float> {
         virtual ~SetMiterLimit() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::setMiterLimit(contextForReplay(replayer), arg<0>());
         }
@@ -239,7 +247,7 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect)
     struct FillRect final : PaintingOperation, OperationData<FloatRect, Cairo::FillSource, Cairo::ShadowState> {
         virtual ~FillRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::fillRect(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>());
         }
@@ -251,7 +259,7 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect)
     };
 
     auto& state = graphicsContext().state();
-    append(createCommand<FillRect>(rect, Cairo::FillSource(state), Cairo::ShadowState(state)));
+    append(createCommand<FillRect>(rect, Cairo::FillSource(state), Cairo::ShadowState(state)), rect);
 }
 
 void CairoOperationRecorder::fillRect(const FloatRect& rect, const Color& color)
@@ -259,7 +267,7 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect, const Color& color)
     struct FillRect final : PaintingOperation, OperationData<FloatRect, Color, Cairo::ShadowState> {
         virtual ~FillRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::fillRect(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>());
         }
@@ -270,7 +278,7 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect, const Color& color)
         }
     };
 
-    append(createCommand<FillRect>(rect, color, Cairo::ShadowState(graphicsContext().state())));
+    append(createCommand<FillRect>(rect, color, Cairo::ShadowState(graphicsContext().state())), rect);
 }
 
 void CairoOperationRecorder::fillRect(const FloatRect& rect, Gradient& gradient)
@@ -278,7 +286,7 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect, Gradient& gradient)
     struct FillRect final : PaintingOperation, OperationData<FloatRect, RefPtr<cairo_pattern_t>> {
         virtual ~FillRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             auto& platformContext = contextForReplay(replayer);
             Cairo::save(platformContext);
@@ -292,7 +300,7 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect, Gradient& gradient)
         }
     };
 
-    append(createCommand<FillRect>(rect, gradient.createPattern(1.0)));
+    append(createCommand<FillRect>(rect, gradient.createPattern(1.0)), rect);
 }
 
 void CairoOperationRecorder::fillRect(const FloatRect& rect, const Color& color, CompositeOperator compositeOperator, BlendMode blendMode)
@@ -300,7 +308,7 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect, const Color& color,
     struct FillRect final : PaintingOperation, OperationData<FloatRect, Color, CompositeOperator, BlendMode, Cairo::ShadowState, CompositeOperator> {
         virtual ~FillRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             auto& platformContext = contextForReplay(replayer);
 
@@ -316,7 +324,11 @@ void CairoOperationRecorder::fillRect(const FloatRect& rect, const Color& color,
     };
 
     auto& state = graphicsContext().state();
-    append(createCommand<FillRect>(rect, color, compositeOperator, blendMode, Cairo::ShadowState(state), state.compositeOperator));
+    auto command = createCommand<FillRect>(rect, color, compositeOperator, blendMode, Cairo::ShadowState(state), state.compositeOperator);
+    if (compositeOperator == CompositeOperator::SourceOver && blendMode == BlendMode::Normal)
+        append(WTFMove(command), rect);
+    else
+        append(WTFMove(command));
 }
 
 void CairoOperationRecorder::fillRoundedRect(const FloatRoundedRect& roundedRect, const Color& color, BlendMode blendMode)
@@ -324,7 +336,7 @@ void CairoOperationRecorder::fillRoundedRect(const FloatRoundedRect& roundedRect
     struct FillRoundedRect final : PaintingOperation, OperationData<FloatRoundedRect, Color, CompositeOperator, BlendMode, Cairo::ShadowState> {
         virtual ~FillRoundedRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             auto& platformContext = contextForReplay(replayer);
 
@@ -346,7 +358,11 @@ void CairoOperationRecorder::fillRoundedRect(const FloatRoundedRect& roundedRect
     };
 
     auto& state = graphicsContext().state();
-    append(createCommand<FillRoundedRect>(roundedRect, color, state.compositeOperator, blendMode, Cairo::ShadowState(state)));
+    auto command = createCommand<FillRoundedRect>(roundedRect, color, state.compositeOperator, blendMode, Cairo::ShadowState(state));
+    if (blendMode == BlendMode::Normal)
+        append(WTFMove(command), roundedRect.rect());
+    else
+        append(WTFMove(command));
 }
 
 void CairoOperationRecorder::fillRectWithRoundedHole(const FloatRect& rect, const FloatRoundedRect& roundedHoleRect, const Color& color)
@@ -354,7 +370,7 @@ void CairoOperationRecorder::fillRectWithRoundedHole(const FloatRect& rect, cons
     struct FillRectWithRoundedHole final : PaintingOperation, OperationData<FloatRect, FloatRoundedRect, Cairo::ShadowState> {
         virtual ~FillRectWithRoundedHole() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::fillRectWithRoundedHole(contextForReplay(replayer), arg<0>(), arg<1>(), { }, arg<2>());
         }
@@ -366,7 +382,7 @@ void CairoOperationRecorder::fillRectWithRoundedHole(const FloatRect& rect, cons
     };
 
     UNUSED_PARAM(color);
-    append(createCommand<FillRectWithRoundedHole>(rect, roundedHoleRect, Cairo::ShadowState(graphicsContext().state())));
+    append(createCommand<FillRectWithRoundedHole>(rect, roundedHoleRect, Cairo::ShadowState(graphicsContext().state())), rect);
 }
 
 void CairoOperationRecorder::fillPath(const Path& path)
@@ -374,7 +390,7 @@ void CairoOperationRecorder::fillPath(const Path& path)
     struct FillPath final : PaintingOperation, OperationData<Path, Cairo::FillSource, Cairo::ShadowState> {
         virtual ~FillPath() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::fillPath(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>());
         }
@@ -386,7 +402,7 @@ void CairoOperationRecorder::fillPath(const Path& path)
     };
 
     auto& state = graphicsContext().state();
-    append(createCommand<FillPath>(path, Cairo::FillSource(state), Cairo::ShadowState(state)));
+    append(createCommand<FillPath>(path, Cairo::FillSource(state), Cairo::ShadowState(state)), path.fastBoundingRect());
 }
 
 void CairoOperationRecorder::fillEllipse(const FloatRect& rect)
@@ -394,7 +410,7 @@ void CairoOperationRecorder::fillEllipse(const FloatRect& rect)
     struct FillEllipse final : PaintingOperation, OperationData<FloatRect, Cairo::FillSource, Cairo::ShadowState> {
         virtual ~FillEllipse() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Path path;
             path.addEllipse(arg<0>());
@@ -408,7 +424,7 @@ void CairoOperationRecorder::fillEllipse(const FloatRect& rect)
     };
 
     auto& state = graphicsContext().state();
-    append(createCommand<FillEllipse>(rect, Cairo::FillSource(state), Cairo::ShadowState(state)));
+    append(createCommand<FillEllipse>(rect, Cairo::FillSource(state), Cairo::ShadowState(state)), rect);
 }
 
 void CairoOperationRecorder::strokeRect(const FloatRect& rect, float lineWidth)
@@ -416,7 +432,7 @@ void CairoOperationRecorder::strokeRect(const FloatRect& rect, float lineWidth)
     struct StrokeRect final : PaintingOperation, OperationData<FloatRect, float, Cairo::StrokeSource, Cairo::ShadowState> {
         virtual ~StrokeRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::strokeRect(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>(), arg<3>());
         }
@@ -428,7 +444,7 @@ void CairoOperationRecorder::strokeRect(const FloatRect& rect, float lineWidth)
     };
 
     auto& state = graphicsContext().state();
-    append(createCommand<StrokeRect>(rect, lineWidth, Cairo::StrokeSource(state), Cairo::ShadowState(state)));
+    append(createCommand<StrokeRect>(rect, lineWidth, Cairo::StrokeSource(state), Cairo::ShadowState(state)), inflatedRect(rect, lineWidth));
 }
 
 void CairoOperationRecorder::strokePath(const Path& path)
@@ -436,7 +452,7 @@ void CairoOperationRecorder::strokePath(const Path& path)
     struct StrokePath final : PaintingOperation, OperationData<Path, Cairo::StrokeSource, Cairo::ShadowState> {
         virtual ~StrokePath() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::strokePath(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>());
         }
@@ -456,7 +472,7 @@ void CairoOperationRecorder::strokeEllipse(const FloatRect& rect)
     struct StrokeEllipse final : PaintingOperation, OperationData<FloatRect, Cairo::StrokeSource, Cairo::ShadowState> {
         virtual ~StrokeEllipse() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Path path;
             path.addEllipse(arg<0>());
@@ -478,7 +494,7 @@ void CairoOperationRecorder::clearRect(const FloatRect& rect)
     struct ClearRect final : PaintingOperation, OperationData<FloatRect> {
         virtual ~ClearRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::clearRect(contextForReplay(replayer), arg<0>());
         }
@@ -489,7 +505,7 @@ void CairoOperationRecorder::clearRect(const FloatRect& rect)
         }
     };
 
-    append(createCommand<ClearRect>(rect));
+    append(createCommand<ClearRect>(rect), rect);
 }
 
 void CairoOperationRecorder::drawGlyphs(const Font& font, const GlyphBuffer& glyphBuffer, unsigned from, unsigned numGlyphs, const FloatPoint& point, FontSmoothingMode fontSmoothing)
@@ -497,7 +513,7 @@ void CairoOperationRecorder::drawGlyphs(const Font& font, const GlyphBuffer& gly
     struct DrawGlyphs final : PaintingOperation, OperationData<Cairo::FillSource, Cairo::StrokeSource, Cairo::ShadowState, FloatPoint, RefPtr<cairo_scaled_font_t>, float, Vector<cairo_glyph_t>, float, TextDrawingModeFlags, float, FloatSize, Color, FontSmoothingMode> {
         virtual ~DrawGlyphs() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawGlyphs(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>(), arg<3>(), arg<4>().get(),
                 arg<5>(), arg<6>(), arg<7>(), arg<8>(), arg<9>(), arg<10>(), arg<11>(), arg<12>());
@@ -544,7 +560,7 @@ void CairoOperationRecorder::drawNativeImage(NativeImage& nativeImage, const Flo
     struct DrawNativeImage final : PaintingOperation, OperationData<RefPtr<cairo_surface_t>, FloatRect, FloatRect, ImagePaintingOptions, float, Cairo::ShadowState> {
         virtual ~DrawNativeImage() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawPlatformImage(contextForReplay(replayer), arg<0>().get(), arg<1>(), arg<2>(), arg<3>(), arg<4>(), arg<5>());
         }
@@ -555,9 +571,13 @@ void CairoOperationRecorder::drawNativeImage(NativeImage& nativeImage, const Flo
         }
     };
 
-    UNUSED_PARAM(imageSize);
     auto& state = graphicsContext().state();
-    append(createCommand<DrawNativeImage>(nativeImage.platformImage(), destRect, srcRect, ImagePaintingOptions(options, state.imageInterpolationQuality), state.alpha, Cairo::ShadowState(state)));
+    FloatRect surfaceSrcRect = mapRectToCairoSurface(srcRect, imageSize, nativeImage.platformImage().get(), options.orientation().usesWidthAsHeight());
+    auto command = createCommand<DrawNativeImage>(nativeImage.platformImage(), destRect, surfaceSrcRect, ImagePaintingOptions(options, state.imageInterpolationQuality), state.alpha, Cairo::ShadowState(state));
+    if (options.compositeOperator() == CompositeOperator::SourceOver && options.blendMode() == BlendMode::Normal)
+        append(WTFMove(command), destRect);
+    else
+        append(WTFMove(command));
 }
 
 void CairoOperationRecorder::drawPattern(NativeImage& nativeImage, const FloatSize& imageSize, const FloatRect& destRect, const FloatRect& tileRect, const AffineTransform& patternTransform, const FloatPoint& phase, const FloatSize& spacing, const ImagePaintingOptions& options)
@@ -565,7 +585,7 @@ void CairoOperationRecorder::drawPattern(NativeImage& nativeImage, const FloatSi
     struct DrawPattern final : PaintingOperation, OperationData<RefPtr<cairo_surface_t>, IntSize, FloatRect, FloatRect, AffineTransform, FloatPoint, ImagePaintingOptions> {
         virtual ~DrawPattern() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawPattern(contextForReplay(replayer), arg<0>().get(), arg<1>(), arg<2>(), arg<3>(), arg<4>(), arg<5>(), arg<6>());
         }
@@ -577,7 +597,11 @@ void CairoOperationRecorder::drawPattern(NativeImage& nativeImage, const FloatSi
     };
 
     UNUSED_PARAM(spacing);
-    append(createCommand<DrawPattern>(nativeImage.platformImage(), IntSize(imageSize), destRect, tileRect, patternTransform, phase, options));
+    auto command = createCommand<DrawPattern>(nativeImage.platformImage(), IntSize(imageSize), destRect, tileRect, patternTransform, phase, options);
+    if (options.compositeOperator() == CompositeOperator::SourceOver && options.blendMode() == BlendMode::Normal)
+        append(WTFMove(command), destRect);
+    else
+        append(WTFMove(command));
 }
 
 void CairoOperationRecorder::drawRect(const FloatRect& rect, float borderThickness)
@@ -585,7 +609,7 @@ void CairoOperationRecorder::drawRect(const FloatRect& rect, float borderThickne
     struct DrawRect final : PaintingOperation, OperationData<FloatRect, float, Color, StrokeStyle, Color> {
         virtual ~DrawRect() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawRect(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>(), arg<3>(), arg<4>());
         }
@@ -597,7 +621,7 @@ void CairoOperationRecorder::drawRect(const FloatRect& rect, float borderThickne
     };
 
     auto& state = graphicsContext().state();
-    append(createCommand<DrawRect>(rect, borderThickness, state.fillColor, state.strokeStyle, state.strokeColor));
+    append(createCommand<DrawRect>(rect, borderThickness, state.fillColor, state.strokeStyle, state.strokeColor), rect);
 }
 
 void CairoOperationRecorder::drawLine(const FloatPoint& point1, const FloatPoint& point2)
@@ -605,7 +629,7 @@ void CairoOperationRecorder::drawLine(const FloatPoint& point1, const FloatPoint
     struct DrawLine final : PaintingOperation, OperationData<FloatPoint, FloatPoint, StrokeStyle, Color, float, bool> {
         virtual ~DrawLine() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawLine(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>(), arg<3>(), arg<4>(), arg<5>());
         }
@@ -625,7 +649,7 @@ void CairoOperationRecorder::drawLinesForText(const FloatPoint& point, float thi
     struct DrawLinesForText final : PaintingOperation, OperationData<FloatPoint, float, DashArray, bool, bool, Color> {
         virtual ~DrawLinesForText() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawLinesForText(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>(), arg<3>(), arg<4>(), arg<5>());
         }
@@ -645,7 +669,7 @@ void CairoOperationRecorder::drawDotsForDocumentMarker(const FloatRect& rect, Do
     struct DrawDotsForDocumentMarker final : PaintingOperation, OperationData<FloatRect, DocumentMarkerLineStyle> {
         virtual ~DrawDotsForDocumentMarker() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawDotsForDocumentMarker(contextForReplay(replayer), arg<0>(), arg<1>());
         }
@@ -664,7 +688,7 @@ void CairoOperationRecorder::drawEllipse(const FloatRect& rect)
     struct DrawEllipse final : PaintingOperation, OperationData<FloatRect, Color, StrokeStyle, Color, float> {
         virtual ~DrawEllipse() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawEllipse(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>(), arg<3>(), arg<4>());
         }
@@ -688,7 +712,7 @@ void CairoOperationRecorder::drawFocusRing(const Path& path, float width, float
     struct DrawFocusRing final : PaintingOperation, OperationData<Path, float, Color> {
         virtual ~DrawFocusRing() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawFocusRing(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>());
         }
@@ -708,7 +732,7 @@ void CairoOperationRecorder::drawFocusRing(const Vector<FloatRect>& rects, float
     struct DrawFocusRing final : PaintingOperation, OperationData<Vector<FloatRect>, float, Color> {
         virtual ~DrawFocusRing() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::drawFocusRing(contextForReplay(replayer), arg<0>(), arg<1>(), arg<2>());
         }
@@ -728,7 +752,7 @@ void CairoOperationRecorder::save()
     struct Save final : PaintingOperation, OperationData<> {
         virtual ~Save() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::save(contextForReplay(replayer));
         }
@@ -749,7 +773,7 @@ void CairoOperationRecorder::restore()
     struct Restore final : PaintingOperation, OperationData<> {
         virtual ~Restore() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::restore(contextForReplay(replayer));
         }
@@ -773,7 +797,7 @@ void CairoOperationRecorder::translate(float x, float y)
     struct Translate final : PaintingOperation, OperationData<float, float> {
         virtual ~Translate() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::translate(contextForReplay(replayer), arg<0>(), arg<1>());
         }
@@ -801,7 +825,7 @@ void CairoOperationRecorder::rotate(float angleInRadians)
     struct Rotate final : PaintingOperation, OperationData<float> {
         virtual ~Rotate() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::rotate(contextForReplay(replayer), arg<0>());
         }
@@ -829,7 +853,7 @@ void CairoOperationRecorder::scale(const FloatSize& size)
     struct Scale final : PaintingOperation, OperationData<FloatSize> {
         virtual ~Scale() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::scale(contextForReplay(replayer), arg<0>());
         }
@@ -857,7 +881,7 @@ void CairoOperationRecorder::concatCTM(const AffineTransform& transform)
     struct ConcatCTM final : PaintingOperation, OperationData<AffineTransform> {
         virtual ~ConcatCTM() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::concatCTM(contextForReplay(replayer), arg<0>());
         }
@@ -884,9 +908,10 @@ void CairoOperationRecorder::setCTM(const AffineTransform& transform)
     struct SetCTM final : PaintingOperation, OperationData<AffineTransform> {
         virtual ~SetCTM() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
-            Cairo::State::setCTM(contextForReplay(replayer), arg<0>());
+            auto& operationReplay = static_cast<PaintingOperationReplayCairo&>(replayer);
+            Cairo::State::setCTM(operationReplay.platformContext, operationReplay.baseCTM * arg<0>());
         }
 
         void dump(TextStream& ts) override
@@ -916,7 +941,7 @@ void CairoOperationRecorder::beginTransparencyLayer(float opacity)
     struct BeginTransparencyLayer final : PaintingOperation, OperationData<float> {
         virtual ~BeginTransparencyLayer() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::beginTransparencyLayer(contextForReplay(replayer), arg<0>());
         }
@@ -935,7 +960,7 @@ void CairoOperationRecorder::endTransparencyLayer()
     struct EndTransparencyLayer final : PaintingOperation, OperationData<> {
         virtual ~EndTransparencyLayer() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::endTransparencyLayer(contextForReplay(replayer));
         }
@@ -954,7 +979,7 @@ void CairoOperationRecorder::clip(const FloatRect& rect)
     struct Clip final : PaintingOperation, OperationData<FloatRect> {
         virtual ~Clip() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::clip(contextForReplay(replayer), arg<0>());
         }
@@ -978,7 +1003,7 @@ void CairoOperationRecorder::clipOut(const FloatRect& rect)
     struct ClipOut final : PaintingOperation, OperationData<FloatRect> {
         virtual ~ClipOut() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::clipOut(contextForReplay(replayer), arg<0>());
         }
@@ -997,7 +1022,7 @@ void CairoOperationRecorder::clipOut(const Path& path)
     struct ClipOut final : PaintingOperation, OperationData<Path> {
         virtual ~ClipOut() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::clipOut(contextForReplay(replayer), arg<0>());
         }
@@ -1016,7 +1041,7 @@ void CairoOperationRecorder::clipPath(const Path& path, WindRule clipRule)
     struct ClipPath final : PaintingOperation, OperationData<Path, WindRule> {
         virtual ~ClipPath() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::clipPath(contextForReplay(replayer), arg<0>(), arg<1>());
         }
@@ -1046,7 +1071,7 @@ void CairoOperationRecorder::clipToImageBuffer(ImageBuffer& buffer, const FloatR
     struct ClipToImageBuffer final: PaintingOperation, OperationData<RefPtr<cairo_surface_t>, FloatRect> {
         virtual ~ClipToImageBuffer() = default;
 
-        void execute(PaintingOperationReplay& replayer) override
+        void execute(PaintingOperationReplay& replayer) const override
         {
             Cairo::clipToImageBuffer(contextForReplay(replayer), arg<0>().get(), arg<1>());
         }
@@ -1079,6 +1104,23 @@ void CairoOperationRecorder::append(std::unique_ptr<PaintingOperation>&& command
     m_commandList.append(WTFMove(command));
 }
 
+void CairoOperationRecorder::append(std::unique_ptr<PaintingOperation>&& command, const FloatRect& rect)
+{
+    // Shadows and non-default compositing can touch pixels outside of the drawn geometry,
+    // so such operations keep their unbounded extent and are never culled on replay.
+    auto& context = graphicsContext();
+    if (!context.hasShadow() && context.compositeOperation() == CompositeOperator::SourceOver && context.blendModeOperation() == BlendMode::Normal) {
+        auto& state = m_stateStack.last();
+        auto bounds = state.ctm.mapRect(rect);
+        // Account for antialiasing along the edges of the geometry.
+        bounds.inflate(1);
+        bounds.intersect(state.clipBounds);
+        command->bounds = bounds;
+    }
+
+    append(WTFMove(command));
+}
+
 void CairoOperationRecorder::clipToDrawingCommands(const FloatRect&, ColorSpace, Function<void(GraphicsContext&)>&&)
 {
     // FIXME: Not implemented.
@@ -106,6 +106,7 @@ private:
     WebCore::FloatRect roundToDevicePixels(const WebCore::FloatRect&, WebCore::GraphicsContext::RoundingMode) override;
 
     void append(std::unique_ptr<PaintingOperation>&&);
+    void append(std::unique_ptr<PaintingOperation>&&, const WebCore::FloatRect&);
     PaintingOperations& m_commandList;
 
     struct State {
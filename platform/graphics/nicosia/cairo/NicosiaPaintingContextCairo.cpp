@@ -31,6 +31,7 @@
 
 #if USE(CAIRO)
 
+#include "CairoOperations.h"
 #include "GraphicsContext.h"
 #include "GraphicsContextImplCairo.h"
 #include "NicosiaBuffer.h"
@@ -95,11 +96,14 @@ WebCore::GraphicsContext& PaintingContextCairo::ForPainting::graphicsContext()
     return *m_graphicsContext;
 }
 
-void PaintingContextCairo::ForPainting::replay(const PaintingOperations& paintingOperations)
+void PaintingContextCairo::ForPainting::replay(const PaintingOperations& paintingOperations, const WebCore::FloatRect& replayRect)
 {
-    PaintingOperationReplayCairo operationReplay { *m_platformContext };
-    for (auto& operation : paintingOperations)
+    PaintingOperationReplayCairo operationReplay { *m_platformContext, WebCore::Cairo::State::getCTM(*m_platformContext) };
+    for (auto& operation : paintingOperations) {
+        if (!operation->bounds.intersects(replayRect))
+            continue;
         operation->execute(operationReplay);
+    }
 }
 
 PaintingContextCairo::ForRecording::ForRecording(PaintingOperations& paintingOperations)
@@ -118,7 +122,7 @@ WebCore::GraphicsContext& PaintingContextCairo::ForRecording::graphicsContext()
     return *m_graphicsContext;
 }
 
-void PaintingContextCairo::ForRecording::replay(const PaintingOperations&)
+void PaintingContextCairo::ForRecording::replay(const PaintingOperations&, const WebCore::FloatRect&)
 {
     ASSERT_NOT_REACHED();
 }
@@ -53,7 +53,7 @@ public:
 
     private:
         WebCore::GraphicsContext& graphicsContext() override;
-        void replay(const PaintingOperations&) override;
+        void replay(const PaintingOperations&, const WebCore::FloatRect&) override;
 
         struct {
             RefPtr<cairo_surface_t> surface;
@@ -74,7 +74,7 @@ public:
 
     private:
         WebCore::GraphicsContext& graphicsContext() override;
-        void replay(const PaintingOperations&) override;
+        void replay(const PaintingOperations&, const WebCore::FloatRect&) override;
 
         std::unique_ptr<WebCore::GraphicsContext> m_graphicsContext;
     };
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "AffineTransform.h"
 #include "NicosiaPaintingOperation.h"
 
 namespace WebCore {
@@ -37,11 +38,15 @@ class PlatformContextCairo;
 namespace Nicosia {
 
 struct PaintingOperationReplayCairo : PaintingOperationReplay {
-    PaintingOperationReplayCairo(WebCore::PlatformContextCairo& platformContext)
+    PaintingOperationReplayCairo(WebCore::PlatformContextCairo& platformContext, const WebCore::AffineTransform& baseCTM)
         : platformContext(platformContext)
+        , baseCTM(baseCTM)
     { }
 
     WebCore::PlatformContextCairo& platformContext;
+    // Transform in effect before the replay started. Recorded absolute transforms
+    // are applied on top of it.
+    WebCore::AffineTransform baseCTM;
 };
 
 }
@@ -27,36 +27,141 @@
 #include "config.h"
 #include "BitmapTexturePool.h"
 
+#include "BitmapTextureSoftware.h"
+
 #if USE(TEXTURE_MAPPER_GL)
 #include "BitmapTextureGL.h"
 #endif
 
+#include <wtf/HashSet.h>
+#include <wtf/MemoryPressureHandler.h>
+
 namespace WebCore {
 
 static const Seconds releaseUnusedSecondsTolerance { 3_s };
 static const Seconds releaseUnusedTexturesTimerInterval { 500_ms };
+static const size_t defaultMemoryBudget = 128 * MB;
+// Under memory pressure the pool only keeps a fraction of its budget in unused textures.
+static const unsigned memoryPressureBudgetDivisor = 4;
+
+static size_t textureBytes(const IntSize& size)
+{
+    return size.unclampedArea() * 4;
+}
 
 #if USE(TEXTURE_MAPPER_GL)
 BitmapTexturePool::BitmapTexturePool(const TextureMapperContextAttributes& contextAttributes)
     : m_contextAttributes(contextAttributes)
+    , m_memoryBudget(defaultMemoryBudget)
     , m_releaseUnusedTexturesTimer(RunLoop::current(), this, &BitmapTexturePool::releaseUnusedTexturesTimerFired)
 {
 }
 #endif
 
+BitmapTexturePool::BitmapTexturePool()
+    : m_memoryBudget(defaultMemoryBudget)
+    , m_releaseUnusedTexturesTimer(RunLoop::current(), this, &BitmapTexturePool::releaseUnusedTexturesTimerFired)
+{
+}
+
+auto BitmapTexturePool::sizeClass(const IntSize& size) -> SizeClass
+{
+    return WTF::fastLog2(std::max(size.width(), 1)) << 16 | WTF::fastLog2(std::max(size.height(), 1));
+}
+
 RefPtr<BitmapTexture> BitmapTexturePool::acquireTexture(const IntSize& size, const BitmapTexture::Flags flags)
 {
-    Entry* selectedEntry = std::find_if(m_textures.begin(), m_textures.end(),
-        [&size](Entry& entry) { return entry.m_texture->refCount() == 1 && entry.m_texture->size() == size; });
+    auto& bucket = m_buckets.add(sizeClass(size), Vector<Entry>()).iterator->value;
+
+    // Prefer a texture of the exact size, whose storage can be reused as is. Any other free texture in
+    // the bucket still saves creating a new one, and is reallocated to at most four times its size.
+    Entry* selectedEntry = nullptr;
+    for (auto& entry : bucket) {
+        if (entry.isInUse())
+            continue;
+        if (entry.m_size == size) {
+            selectedEntry = &entry;
+            break;
+        }
+        if (!selectedEntry)
+            selectedEntry = &entry;
+    }
 
-    if (selectedEntry == m_textures.end()) {
-        m_textures.append(Entry(createTexture(flags)));
-        selectedEntry = &m_textures.last();
+    if (selectedEntry) {
+        m_statistics.hits++;
+        m_statistics.bytes -= textureBytes(selectedEntry->m_size);
+        selectedEntry->m_size = size;
+    } else {
+        m_statistics.misses++;
+        m_statistics.textureCount++;
+        bucket.append(Entry(createTexture(flags), size));
+        selectedEntry = &bucket.last();
     }
+    m_statistics.bytes += textureBytes(size);
 
-    scheduleReleaseUnusedTextures();
     selectedEntry->markIsInUse();
-    return selectedEntry->m_texture.copyRef();
+    auto texture = selectedEntry->m_texture.copyRef();
+
+    enforceMemoryBudget();
+    scheduleReleaseUnusedTextures();
+    return texture;
+}
+
+void BitmapTexturePool::removeEntries(const WTF::Function<bool(const Entry&)>& shouldRemove)
+{
+    Vector<SizeClass> emptyBuckets;
+    for (auto& bucket : m_buckets) {
+        bucket.value.removeAllMatching([&](const Entry& entry) {
+            if (!shouldRemove(entry))
+                return false;
+            m_statistics.textureCount--;
+            m_statistics.bytes -= textureBytes(entry.m_size);
+            return true;
+        });
+        if (bucket.value.isEmpty())
+            emptyBuckets.append(bucket.key);
+    }
+
+    for (auto sizeClass : emptyBuckets)
+        m_buckets.remove(sizeClass);
+}
+
+void BitmapTexturePool::enforceMemoryBudget()
+{
+    size_t budget = m_memoryBudget;
+    if (MemoryPressureHandler::singleton().isUnderMemoryPressure())
+        budget /= memoryPressureBudgetDivisor;
+
+    if (m_statistics.bytes <= budget)
+        return;
+
+    Vector<std::pair<MonotonicTime, const Entry*>> candidates;
+    for (auto& bucket : m_buckets.values()) {
+        for (auto& entry : bucket) {
+            if (!entry.isInUse())
+                candidates.append({ entry.m_lastUsedTime, &entry });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](auto& a, auto& b) {
+        return a.first < b.first;
+    });
+
+    HashSet<const Entry*> evictedEntries;
+    size_t bytes = m_statistics.bytes;
+    for (auto& candidate : candidates) {
+        if (bytes <= budget)
+            break;
+        bytes -= textureBytes(candidate.second->m_size);
+        evictedEntries.add(candidate.second);
+    }
+
+    if (evictedEntries.isEmpty())
+        return;
+
+    m_statistics.evictions += evictedEntries.size();
+    removeEntries([&evictedEntries](const Entry& entry) {
+        return evictedEntries.contains(&entry);
+    });
 }
 
 void BitmapTexturePool::scheduleReleaseUnusedTextures()
@@ -69,28 +174,30 @@ void BitmapTexturePool::scheduleReleaseUnusedTextures()
 
 void BitmapTexturePool::releaseUnusedTexturesTimerFired()
 {
-    if (m_textures.isEmpty())
+    if (m_buckets.isEmpty())
         return;
 
     // Delete entries, which have been unused in releaseUnusedSecondsTolerance.
     MonotonicTime minUsedTime = MonotonicTime::now() - releaseUnusedSecondsTolerance;
 
-    m_textures.removeAllMatching([&minUsedTime](const Entry& entry) {
+    removeEntries([&minUsedTime](const Entry& entry) {
         return entry.canBeReleased(minUsedTime);
     });
 
-    if (!m_textures.isEmpty())
+    // Memory pressure may have started since the last acquisition.
+    enforceMemoryBudget();
+
+    if (!m_buckets.isEmpty())
         scheduleReleaseUnusedTextures();
 }
 
 RefPtr<BitmapTexture> BitmapTexturePool::createTexture(const BitmapTexture::Flags flags)
 {
 #if USE(TEXTURE_MAPPER_GL)
-    return BitmapTextureGL::create(m_contextAttributes, flags);
-#else
-    UNUSED_PARAM(flags);
-    return nullptr;
+    if (m_contextAttributes)
+        return BitmapTextureGL::create(*m_contextAttributes, flags);
 #endif
+    return BitmapTextureSoftware::create(flags);
 }
 
 } // namespace WebCore
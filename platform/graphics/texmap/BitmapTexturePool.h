@@ -28,13 +28,15 @@
 #define BitmapTexturePool_h
 
 #include "BitmapTexture.h"
+#include "IntSize.h"
 #include "TextureMapperContextAttributes.h"
+#include <wtf/Function.h>
+#include <wtf/HashMap.h>
+#include <wtf/Optional.h>
 #include <wtf/RunLoop.h>
 
 namespace WebCore {
 
-class IntSize;
-
 class BitmapTexturePool {
     WTF_MAKE_NONCOPYABLE(BitmapTexturePool);
     WTF_MAKE_FAST_ALLOCATED;
@@ -42,31 +44,58 @@ public:
 #if USE(TEXTURE_MAPPER_GL)
     explicit BitmapTexturePool(const TextureMapperContextAttributes&);
 #endif
+    // Pools software textures, for TextureMapperSoftware.
+    BitmapTexturePool();
 
     RefPtr<BitmapTexture> acquireTexture(const IntSize&, const BitmapTexture::Flags);
 
+    // Textures that are not in use are evicted, least recently used first, whenever the pool holds
+    // more than this many bytes. Textures in use are never evicted, so the pool can exceed it.
+    void setMemoryBudget(size_t budget) { m_memoryBudget = budget; }
+
+    struct Statistics {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+        uint64_t evictions { 0 };
+        size_t textureCount { 0 };
+        size_t bytes { 0 };
+    };
+    const Statistics& statistics() const { return m_statistics; }
+
 private:
     struct Entry {
-        explicit Entry(RefPtr<BitmapTexture>&& texture)
+        Entry(RefPtr<BitmapTexture>&& texture, const IntSize& size)
             : m_texture(WTFMove(texture))
+            , m_size(size)
         { }
 
         void markIsInUse() { m_lastUsedTime = MonotonicTime::now(); }
-        bool canBeReleased (MonotonicTime minUsedTime) const { return m_lastUsedTime < minUsedTime && m_texture->refCount() == 1; }
+        bool isInUse() const { return m_texture->refCount() > 1; }
+        bool canBeReleased (MonotonicTime minUsedTime) const { return m_lastUsedTime < minUsedTime && !isInUse(); }
 
         RefPtr<BitmapTexture> m_texture;
+        IntSize m_size;
         MonotonicTime m_lastUsedTime;
     };
 
+    // Textures are bucketed by the power-of-two class of their width and height, so a lookup only
+    // looks at textures that could be reused without a much larger or smaller allocation.
+    using SizeClass = unsigned;
+    static SizeClass sizeClass(const IntSize&);
+
     void scheduleReleaseUnusedTextures();
     void releaseUnusedTexturesTimerFired();
+    void enforceMemoryBudget();
+    void removeEntries(const WTF::Function<bool(const Entry&)>&);
     RefPtr<BitmapTexture> createTexture(const BitmapTexture::Flags);
 
 #if USE(TEXTURE_MAPPER_GL)
-    TextureMapperContextAttributes m_contextAttributes;
+    Optional<TextureMapperContextAttributes> m_contextAttributes;
 #endif
 
-    Vector<Entry> m_textures;
+    HashMap<SizeClass, Vector<Entry>, IntHash<SizeClass>, WTF::UnsignedWithZeroKeyHashTraits<SizeClass>> m_buckets;
+    size_t m_memoryBudget;
+    Statistics m_statistics;
     RunLoop::Timer<BitmapTexturePool> m_releaseUnusedTexturesTimer;
 };
 
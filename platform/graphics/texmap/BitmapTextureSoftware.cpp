@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "config.h"
+#include "BitmapTextureSoftware.h"
+
+#include "Image.h"
+#include "NativeImage.h"
+#include "NotImplemented.h"
+
+#if USE(CAIRO)
+#include <cairo.h>
+#endif
+
+namespace WebCore {
+
+BitmapTextureSoftware::BitmapTextureSoftware(const Flags flags)
+{
+    reset({ }, flags);
+}
+
+void BitmapTextureSoftware::didReset()
+{
+    m_shouldClear = true;
+    if (m_size == contentSize())
+        return;
+
+    m_size = contentSize();
+    m_pixels.resize(m_size.unclampedArea());
+}
+
+void BitmapTextureSoftware::bindAsSurface()
+{
+    if (m_shouldClear) {
+        std::fill(m_pixels.begin(), m_pixels.end(), 0);
+        m_shouldClear = false;
+    }
+    m_clipStack.reset(IntRect(IntPoint::zero(), m_size), ClipStack::YAxisMode::Default);
+}
+
+void BitmapTextureSoftware::updateContents(const void* srcData, const IntRect& targetRect, const IntPoint& sourceOffset, int bytesPerLine)
+{
+    IntRect rect = intersection(targetRect, IntRect(IntPoint::zero(), m_size));
+    if (rect.isEmpty())
+        return;
+
+    IntPoint offset = sourceOffset + (rect.location() - targetRect.location());
+    const char* data = static_cast<const char*>(srcData);
+
+    // The alpha byte of opaque contents may be garbage, as it is for CAIRO_FORMAT_RGB24, and
+    // compositing with opacity reads it.
+    uint32_t alphaMask = isOpaque() ? 0xff000000 : 0;
+    for (int y = 0; y < rect.height(); ++y) {
+        auto* source = reinterpret_cast<const uint32_t*>(data + (offset.y() + y) * bytesPerLine) + offset.x();
+        auto* destination = row(rect.y() + y) + rect.x();
+        if (!alphaMask) {
+            memcpy(destination, source, rect.width() * sizeof(uint32_t));
+            continue;
+        }
+        for (int x = 0; x < rect.width(); ++x)
+            destination[x] = source[x] | alphaMask;
+    }
+}
+
+void BitmapTextureSoftware::updateContents(Image* image, const IntRect& targetRect, const IntPoint& offset)
+{
+    if (!image)
+        return;
+    auto frameImage = image->nativeImageForCurrentFrame();
+    if (!frameImage)
+        return;
+
+#if USE(CAIRO)
+    cairo_surface_t* surface = frameImage->platformImage().get();
+    updateContents(cairo_image_surface_get_data(surface), targetRect, offset, cairo_image_surface_get_stride(surface));
+#else
+    UNUSED_PARAM(targetRect);
+    UNUSED_PARAM(offset);
+    notImplemented();
+#endif
+}
+
+} // namespace WebCore
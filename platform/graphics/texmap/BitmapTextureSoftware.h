@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "BitmapTexture.h"
+#include "ClipStack.h"
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// A texture kept in main memory, used by TextureMapperSoftware. Pixels are premultiplied 32-bit
+// ARGB in native byte order, the same layout cairo uses for CAIRO_FORMAT_ARGB32, top row first.
+class BitmapTextureSoftware final : public BitmapTexture {
+public:
+    static Ref<BitmapTexture> create(const Flags flags = NoFlag)
+    {
+        return adoptRef(*new BitmapTextureSoftware(flags));
+    }
+
+    IntSize size() const override { return m_size; }
+    bool isValid() const override { return !m_size.isEmpty(); }
+    void didReset() override;
+    void updateContents(Image*, const IntRect&, const IntPoint&) override;
+    void updateContents(const void*, const IntRect& target, const IntPoint& sourceOffset, int bytesPerLine) override;
+
+    void bindAsSurface();
+    ClipStack& clipStack() { return m_clipStack; }
+
+    uint32_t* row(int y) { return m_pixels.data() + y * m_size.width(); }
+    const uint32_t* row(int y) const { return m_pixels.data() + y * m_size.width(); }
+    const uint32_t* data() const { return m_pixels.data(); }
+    size_t bytesPerLine() const { return m_size.width() * sizeof(uint32_t); }
+
+private:
+    explicit BitmapTextureSoftware(const Flags);
+
+    IntSize m_size;
+    Vector<uint32_t> m_pixels;
+    ClipStack m_clipStack;
+    bool m_shouldClear { true };
+};
+
+} // namespace WebCore
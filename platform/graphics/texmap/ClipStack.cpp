@@ -22,7 +22,9 @@
 #include "config.h"
 #include "ClipStack.h"
 
+#if USE(TEXTURE_MAPPER_GL)
 #include "TextureMapperGLHeaders.h"
+#endif
 
 namespace WebCore {
 
@@ -95,6 +97,7 @@ void ClipStack::addRoundedRect(const FloatRoundedRect& roundedRect, const Transf
 
 void ClipStack::apply()
 {
+#if USE(TEXTURE_MAPPER_GL)
     if (clipState.scissorBox.isEmpty())
         return;
 
@@ -107,6 +110,7 @@ void ClipStack::apply()
         glDisable(GL_STENCIL_TEST);
     else
         glEnable(GL_STENCIL_TEST);
+#endif
 }
 
 void ClipStack::applyIfNeeded()
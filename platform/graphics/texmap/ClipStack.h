@@ -80,6 +80,8 @@ public:
     bool isRoundedRectClipEnabled() const { return !!clipState.roundedRectCount; }
     bool isRoundedRectClipAllowed() const { return clipState.roundedRectCount < s_roundedRectMaxClips; }
 
+    // Applies the clip to the current GL scissor and stencil state. Software surfaces read the
+    // clip from the stack instead.
     void apply();
     void applyIfNeeded();
 
@@ -23,6 +23,7 @@
 #include "BitmapTexturePool.h"
 #include "FilterOperations.h"
 #include "GraphicsLayer.h"
+#include "TextureMapperSoftware.h"
 #include "Timer.h"
 
 namespace WebCore {
@@ -40,7 +41,9 @@ RefPtr<BitmapTexture> TextureMapper::acquireTextureFromPool(const IntSize& size,
 
 std::unique_ptr<TextureMapper> TextureMapper::create()
 {
-    return platformCreateAccelerated();
+    if (auto textureMapper = platformCreateAccelerated())
+        return textureMapper;
+    return TextureMapperSoftware::create();
 }
 
 } // namespace
@@ -92,6 +92,7 @@ public:
     virtual IntSize maxTextureSize() const = 0;
 
     virtual RefPtr<BitmapTexture> acquireTextureFromPool(const IntSize&, const BitmapTexture::Flags = BitmapTexture::SupportsAlpha);
+    BitmapTexturePool* texturePool() const { return m_texturePool.get(); }
 
     void setPatternTransform(const TransformationMatrix& p) { m_patternTransform = p; }
     void setWrapMode(WrapMode m) { m_wrapMode = m; }
@@ -0,0 +1,596 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "config.h"
+#include "TextureMapperSoftware.h"
+
+#include "BitmapTexturePool.h"
+#include "BitmapTextureSoftware.h"
+#include "ColorUtilities.h"
+#include "FloatQuad.h"
+#include "FloatRoundedRect.h"
+#include "NotImplemented.h"
+
+#if USE(CAIRO)
+#include <cairo.h>
+#include <wtf/text/CString.h>
+#endif
+
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include <arm_neon.h>
+#endif
+
+namespace WebCore {
+
+static inline uint32_t divideBy255(uint32_t value)
+{
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+// Scales the four channels of a pixel by scale / 255, rounding to nearest.
+static inline uint32_t scalePixel(uint32_t pixel, uint32_t scale)
+{
+    uint32_t redBlue = (pixel & 0x00ff00ff) * scale + 0x00800080;
+    redBlue = ((redBlue + ((redBlue >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+    uint32_t alphaGreen = ((pixel >> 8) & 0x00ff00ff) * scale + 0x00800080;
+    alphaGreen = (alphaGreen + ((alphaGreen >> 8) & 0x00ff00ff)) & 0xff00ff00;
+    return redBlue | alphaGreen;
+}
+
+#if CPU(X86_SSE2)
+// These work on pixels unpacked to one channel per 16-bit lane.
+static inline __m128i divideBy255(__m128i value)
+{
+    value = _mm_add_epi16(value, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+static inline __m128i scalePixels(__m128i pixels, __m128i scale)
+{
+    return divideBy255(_mm_mullo_epi16(pixels, scale));
+}
+
+static inline __m128i broadcastAlpha(__m128i pixels)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+#elif HAVE(ARM_NEON_INTRINSICS)
+static inline uint8x8_t divideBy255(uint16x8_t value)
+{
+    return vrshrn_n_u16(vrsraq_n_u16(value, value, 8), 8);
+}
+#endif
+
+// destination = source * opacity + destination * (1 - sourceAlpha * opacity), on premultiplied pixels.
+static void blendSourceOver(uint32_t* destination, const uint32_t* source, unsigned count, uint32_t opacity)
+{
+    unsigned i = 0;
+#if CPU(X86_SSE2)
+    __m128i zero = _mm_setzero_si128();
+    __m128i opacity16 = _mm_set1_epi16(opacity);
+    __m128i max16 = _mm_set1_epi16(255);
+    for (; i + 4 <= count; i += 4) {
+        __m128i sourcePixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m128i destinationPixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+        __m128i sourceLow = _mm_unpacklo_epi8(sourcePixels, zero);
+        __m128i sourceHigh = _mm_unpackhi_epi8(sourcePixels, zero);
+        if (opacity != 255) {
+            sourceLow = scalePixels(sourceLow, opacity16);
+            sourceHigh = scalePixels(sourceHigh, opacity16);
+        }
+        __m128i destinationLow = scalePixels(_mm_unpacklo_epi8(destinationPixels, zero), _mm_sub_epi16(max16, broadcastAlpha(sourceLow)));
+        __m128i destinationHigh = scalePixels(_mm_unpackhi_epi8(destinationPixels, zero), _mm_sub_epi16(max16, broadcastAlpha(sourceHigh)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(_mm_add_epi16(sourceLow, destinationLow), _mm_add_epi16(sourceHigh, destinationHigh)));
+    }
+#elif HAVE(ARM_NEON_INTRINSICS)
+    uint8x8_t opacity8 = vdup_n_u8(opacity);
+    for (; i + 8 <= count; i += 8) {
+        uint8x8x4_t sourcePixels = vld4_u8(reinterpret_cast<const uint8_t*>(source + i));
+        uint8x8x4_t destinationPixels = vld4_u8(reinterpret_cast<const uint8_t*>(destination + i));
+        if (opacity != 255) {
+            for (unsigned channel = 0; channel < 4; ++channel)
+                sourcePixels.val[channel] = divideBy255(vmull_u8(sourcePixels.val[channel], opacity8));
+        }
+        uint8x8_t inverseAlpha = vmvn_u8(sourcePixels.val[3]);
+        for (unsigned channel = 0; channel < 4; ++channel)
+            destinationPixels.val[channel] = vqadd_u8(sourcePixels.val[channel], divideBy255(vmull_u8(destinationPixels.val[channel], inverseAlpha)));
+        vst4_u8(reinterpret_cast<uint8_t*>(destination + i), destinationPixels);
+    }
+#endif
+    for (; i < count; ++i) {
+        uint32_t sourcePixel = opacity == 255 ? source[i] : scalePixel(source[i], opacity);
+        destination[i] = sourcePixel + scalePixel(destination[i], 255 - (sourcePixel >> 24));
+    }
+}
+
+// destination = destination * sourceAlpha * opacity, which is how masks are applied.
+static void blendDestinationIn(uint32_t* destination, const uint32_t* source, unsigned count, uint32_t opacity)
+{
+    unsigned i = 0;
+#if CPU(X86_SSE2)
+    __m128i zero = _mm_setzero_si128();
+    __m128i opacity16 = _mm_set1_epi16(opacity);
+    for (; i + 4 <= count; i += 4) {
+        __m128i sourcePixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m128i destinationPixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+        __m128i alphaLow = broadcastAlpha(_mm_unpacklo_epi8(sourcePixels, zero));
+        __m128i alphaHigh = broadcastAlpha(_mm_unpackhi_epi8(sourcePixels, zero));
+        if (opacity != 255) {
+            alphaLow = scalePixels(alphaLow, opacity16);
+            alphaHigh = scalePixels(alphaHigh, opacity16);
+        }
+        __m128i destinationLow = scalePixels(_mm_unpacklo_epi8(destinationPixels, zero), alphaLow);
+        __m128i destinationHigh = scalePixels(_mm_unpackhi_epi8(destinationPixels, zero), alphaHigh);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(destinationLow, destinationHigh));
+    }
+#elif HAVE(ARM_NEON_INTRINSICS)
+    uint8x8_t opacity8 = vdup_n_u8(opacity);
+    for (; i + 8 <= count; i += 8) {
+        uint8x8x4_t sourcePixels = vld4_u8(reinterpret_cast<const uint8_t*>(source + i));
+        uint8x8x4_t destinationPixels = vld4_u8(reinterpret_cast<const uint8_t*>(destination + i));
+        uint8x8_t alpha = sourcePixels.val[3];
+        if (opacity != 255)
+            alpha = divideBy255(vmull_u8(alpha, opacity8));
+        for (unsigned channel = 0; channel < 4; ++channel)
+            destinationPixels.val[channel] = divideBy255(vmull_u8(destinationPixels.val[channel], alpha));
+        vst4_u8(reinterpret_cast<uint8_t*>(destination + i), destinationPixels);
+    }
+#endif
+    for (; i < count; ++i)
+        destination[i] = scalePixel(destination[i], divideBy255((source[i] >> 24) * opacity));
+}
+
+static uint32_t pixelForColor(const Color& color)
+{
+    auto [r, g, b, a] = premultipliedCeiling(color.toSRGBALossy<uint8_t>());
+    return static_cast<uint32_t>(a) << 24 | static_cast<uint32_t>(r) << 16 | static_cast<uint32_t>(g) << 8 | b;
+}
+
+static uint32_t opacityToAlpha(float opacity)
+{
+    return static_cast<uint32_t>(std::round(clampTo(opacity, 0.f, 1.f) * 255));
+}
+
+// Interpolates between two pixels, weight being the share of the second one out of 256.
+static inline uint32_t interpolatePixels(uint32_t first, uint32_t second, uint32_t weight)
+{
+    uint32_t redBlue = (((first & 0x00ff00ff) * (256 - weight) + (second & 0x00ff00ff) * weight) >> 8) & 0x00ff00ff;
+    uint32_t alphaGreen = (((first >> 8) & 0x00ff00ff) * (256 - weight) + ((second >> 8) & 0x00ff00ff) * weight) & 0xff00ff00;
+    return redBlue | alphaGreen;
+}
+
+static inline int wrapTexelCoordinate(int coordinate, int size, bool repeat)
+{
+    if (!repeat)
+        return clampTo(coordinate, 0, size - 1);
+    coordinate %= size;
+    return coordinate < 0 ? coordinate + size : coordinate;
+}
+
+// Samples the texture at a point in texel space, like GL_LINEAR does.
+static uint32_t sampleBilinear(const BitmapTextureSoftware& texture, float u, float v, bool repeat)
+{
+    IntSize size = texture.size();
+    u -= 0.5f;
+    v -= 0.5f;
+    float x = std::floor(u);
+    float y = std::floor(v);
+    uint32_t weightX = static_cast<uint32_t>((u - x) * 256);
+    uint32_t weightY = static_cast<uint32_t>((v - y) * 256);
+
+    // Keep the coordinates within integer range before converting them.
+    if (repeat) {
+        x -= size.width() * std::floor(x / size.width());
+        y -= size.height() * std::floor(y / size.height());
+    } else {
+        x = clampTo(x, -1.f, static_cast<float>(size.width()));
+        y = clampTo(y, -1.f, static_cast<float>(size.height()));
+    }
+
+    int left = static_cast<int>(x);
+    int top = static_cast<int>(y);
+    int x0 = wrapTexelCoordinate(left, size.width(), repeat);
+    int x1 = wrapTexelCoordinate(left + 1, size.width(), repeat);
+    const uint32_t* row0 = texture.row(wrapTexelCoordinate(top, size.height(), repeat));
+    const uint32_t* row1 = texture.row(wrapTexelCoordinate(top + 1, size.height(), repeat));
+    return interpolatePixels(interpolatePixels(row0[x0], row0[x1], weightX), interpolatePixels(row1[x0], row1[x1], weightX), weightY);
+}
+
+static inline FloatPoint mapPixelCenter(const TransformationMatrix& matrix, int x, int y)
+{
+    FloatPoint center(x + 0.5f, y + 0.5f);
+    return matrix.isAffine() ? matrix.mapPoint(center) : matrix.projectPoint(center);
+}
+
+static bool roundedRectContains(const FloatRoundedRect& roundedRect, const FloatPoint& point)
+{
+    const FloatRect& rect = roundedRect.rect();
+    if (!rect.contains(point))
+        return false;
+
+    auto isInsideCorner = [&point](const FloatSize& radius, float centerX, float centerY) {
+        if (radius.isEmpty())
+            return true;
+        float dx = (point.x() - centerX) / radius.width();
+        float dy = (point.y() - centerY) / radius.height();
+        return dx * dx + dy * dy <= 1;
+    };
+
+    const auto& radii = roundedRect.radii();
+    if (point.x() < rect.x() + radii.topLeft().width() && point.y() < rect.y() + radii.topLeft().height())
+        return isInsideCorner(radii.topLeft(), rect.x() + radii.topLeft().width(), rect.y() + radii.topLeft().height());
+    if (point.x() > rect.maxX() - radii.topRight().width() && point.y() < rect.y() + radii.topRight().height())
+        return isInsideCorner(radii.topRight(), rect.maxX() - radii.topRight().width(), rect.y() + radii.topRight().height());
+    if (point.x() < rect.x() + radii.bottomLeft().width() && point.y() > rect.maxY() - radii.bottomLeft().height())
+        return isInsideCorner(radii.bottomLeft(), rect.x() + radii.bottomLeft().width(), rect.maxY() - radii.bottomLeft().height());
+    if (point.x() > rect.maxX() - radii.bottomRight().width() && point.y() > rect.maxY() - radii.bottomRight().height())
+        return isInsideCorner(radii.bottomRight(), rect.maxX() - radii.bottomRight().width(), rect.maxY() - radii.bottomRight().height());
+    return true;
+}
+
+struct RoundedRectClip {
+    FloatRoundedRect rect;
+    TransformationMatrix inverse;
+};
+
+// ClipStack keeps rounded rect clips in the layout TextureMapperGL uploads to its shaders.
+static Vector<RoundedRectClip, s_roundedRectMaxClips> roundedRectClips(const ClipStack& clipStack)
+{
+    Vector<RoundedRectClip, s_roundedRectMaxClips> clips;
+    for (unsigned i = 0; i < clipStack.roundedRectCount(); ++i) {
+        const float* r = clipStack.roundedRectComponents() + i * s_roundedRectComponentsPerRect;
+        const float* m = clipStack.roundedRectInverseTransformComponents() + i * s_roundedRectInverseTransformComponentsPerRect;
+        FloatRoundedRect::Radii radii({ r[4], r[5] }, { r[6], r[7] }, { r[8], r[9] }, { r[10], r[11] });
+        clips.append({ FloatRoundedRect(FloatRect(r[0], r[1], r[2], r[3]), radii),
+            TransformationMatrix(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]) });
+    }
+    return clips;
+}
+
+std::unique_ptr<TextureMapperSoftware> TextureMapperSoftware::create()
+{
+    return makeUnique<TextureMapperSoftware>();
+}
+
+TextureMapperSoftware::TextureMapperSoftware()
+{
+    m_texturePool = makeUnique<BitmapTexturePool>();
+}
+
+TextureMapperSoftware::~TextureMapperSoftware() = default;
+
+void TextureMapperSoftware::setDefaultSurface(RefPtr<BitmapTexture>&& surface)
+{
+    ASSERT(!surface || !surface->isBackedByOpenGL());
+    m_defaultSurface = static_cast<BitmapTextureSoftware*>(surface.get());
+    m_currentSurface = m_defaultSurface;
+}
+
+ClipStack* TextureMapperSoftware::clipStack()
+{
+    return m_currentSurface ? &m_currentSurface->clipStack() : nullptr;
+}
+
+void TextureMapperSoftware::beginPainting(PaintFlags)
+{
+    // Software surfaces are always stored top row first, so PaintingMirrored makes no difference.
+    if (m_defaultSurface)
+        m_defaultSurface->clipStack().reset(IntRect(IntPoint::zero(), m_defaultSurface->size()), ClipStack::YAxisMode::Default);
+    bindSurface(nullptr);
+}
+
+template<typename ShadeSpan>
+void TextureMapperSoftware::drawQuad(const FloatRect& rect, const TransformationMatrix& modelViewMatrix, const ShadeSpan& shadeSpan)
+{
+    auto* clip = clipStack();
+    if (!clip || rect.isEmpty())
+        return;
+
+    auto inverse = modelViewMatrix.inverse();
+    if (!inverse)
+        return;
+
+    FloatQuad quad = modelViewMatrix.projectQuad(rect);
+    bool isRectilinear = modelViewMatrix.isAffine() && quad.isRectilinear();
+
+    IntRect bounds;
+    if (isRectilinear) {
+        // Exactly the pixels whose centers are inside the rect.
+        FloatRect boundingBox = quad.boundingBox();
+        int minX = clampToInteger(std::round(boundingBox.x()));
+        int minY = clampToInteger(std::round(boundingBox.y()));
+        bounds = IntRect(minX, minY, clampToInteger(std::round(boundingBox.maxX())) - minX, clampToInteger(std::round(boundingBox.maxY())) - minY);
+    } else
+        bounds = quad.enclosingBoundingBox();
+    bounds.intersect(clip->current().scissorBox);
+    bounds.intersect(IntRect(IntPoint::zero(), m_currentSurface->size()));
+    if (bounds.isEmpty())
+        return;
+
+    auto clips = roundedRectClips(*clip);
+    auto covers = [&](int x, int y) {
+        if (!isRectilinear && !rect.contains(mapPixelCenter(*inverse, x, y)))
+            return false;
+        for (auto& roundedRectClip : clips) {
+            if (!roundedRectContains(roundedRectClip.rect, mapPixelCenter(roundedRectClip.inverse, x, y)))
+                return false;
+        }
+        return true;
+    };
+    bool needsCoverageTest = !isRectilinear || !clips.isEmpty();
+
+    for (int y = bounds.y(); y < bounds.maxY(); ++y) {
+        int startX = bounds.x();
+        int endX = bounds.maxX();
+        if (needsCoverageTest) {
+            // The quad and every clip are convex, so the pixels they cover in a row are contiguous.
+            while (startX < endX && !covers(startX, y))
+                ++startX;
+            int x = startX;
+            while (x < endX && covers(x, y))
+                ++x;
+            endX = x;
+        }
+        if (startX < endX)
+            shadeSpan(m_currentSurface->row(y) + startX, startX, y, endX - startX);
+    }
+}
+
+void TextureMapperSoftware::drawTexture(const BitmapTexture& texture, const FloatRect& targetRect, const TransformationMatrix& modelViewMatrix, float opacity, unsigned)
+{
+    if (!texture.isValid() || texture.isBackedByOpenGL())
+        return;
+
+    auto& source = static_cast<const BitmapTextureSoftware&>(texture);
+    uint32_t alpha = opacityToAlpha(opacity);
+    BlendMode mode = BlendMode::SourceOver;
+    if (isInMaskMode())
+        mode = BlendMode::DestinationIn;
+    else if (!alpha)
+        return;
+    else if (source.isOpaque() && alpha == 255)
+        mode = BlendMode::Copy;
+
+    auto blendSpan = [mode, alpha](uint32_t* destination, const uint32_t* sourcePixels, unsigned count) {
+        switch (mode) {
+        case BlendMode::Copy:
+            memcpy(destination, sourcePixels, count * sizeof(uint32_t));
+            break;
+        case BlendMode::SourceOver:
+            blendSourceOver(destination, sourcePixels, count, alpha);
+            break;
+        case BlendMode::DestinationIn:
+            blendDestinationIn(destination, sourcePixels, count, alpha);
+            break;
+        }
+    };
+
+    IntSize size = source.size();
+
+    // Texels map one to one onto pixels, so rows of the texture are blended in place.
+    if (patternTransform().isIdentity() && targetRect.size() == FloatSize(size) && modelViewMatrix.isIntegerTranslation()
+        && targetRect.x() == std::floor(targetRect.x()) && targetRect.y() == std::floor(targetRect.y())) {
+        int offsetX = modelViewMatrix.e() + targetRect.x();
+        int offsetY = modelViewMatrix.f() + targetRect.y();
+        drawQuad(targetRect, modelViewMatrix, [&](uint32_t* destination, int x, int y, unsigned count) {
+            blendSpan(destination, source.row(y - offsetY) + x - offsetX, count);
+        });
+        return;
+    }
+
+    auto inverse = modelViewMatrix.inverse();
+    if (!inverse)
+        return;
+
+    // Maps surface coordinates to texel coordinates, the way TextureMapperGL's texture space matrix does.
+    TransformationMatrix surfaceToTexture;
+    surfaceToTexture.scaleNonUniform(size.width(), size.height());
+    surfaceToTexture.multiply(patternTransform());
+    surfaceToTexture.multiply(TransformationMatrix::rectToRect(targetRect, FloatRect(0, 0, 1, 1)));
+    surfaceToTexture.multiply(*inverse);
+    bool repeat = wrapMode() == RepeatWrap;
+
+    drawQuad(targetRect, modelViewMatrix, [&](uint32_t* destination, int x, int y, unsigned count) {
+        if (m_spanBuffer.size() < count)
+            m_spanBuffer.grow(count);
+
+        if (surfaceToTexture.isAffine()) {
+            FloatPoint texel = mapPixelCenter(surfaceToTexture, x, y);
+            float stepX = surfaceToTexture.a();
+            float stepY = surfaceToTexture.b();
+            for (unsigned i = 0; i < count; ++i)
+                m_spanBuffer[i] = sampleBilinear(source, texel.x() + i * stepX, texel.y() + i * stepY, repeat);
+        } else {
+            for (unsigned i = 0; i < count; ++i) {
+                FloatPoint texel = mapPixelCenter(surfaceToTexture, x + i, y);
+                m_spanBuffer[i] = sampleBilinear(source, texel.x(), texel.y(), repeat);
+            }
+        }
+
+        blendSpan(destination, m_spanBuffer.data(), count);
+    });
+}
+
+void TextureMapperSoftware::drawSolidColor(const FloatRect& rect, const TransformationMatrix& matrix, const Color& color, bool isBlendingAllowed)
+{
+    if (!m_currentSurface)
+        return;
+
+    uint32_t pixel = pixelForColor(color);
+    BlendMode mode = BlendMode::SourceOver;
+    if (isInMaskMode())
+        mode = BlendMode::DestinationIn;
+    else if ((pixel >> 24) == 255 || !isBlendingAllowed)
+        mode = BlendMode::Copy;
+
+    if (mode != BlendMode::Copy)
+        m_spanBuffer.fill(pixel, m_currentSurface->size().width());
+
+    drawQuad(rect, matrix, [&](uint32_t* destination, int, int, unsigned count) {
+        switch (mode) {
+        case BlendMode::Copy:
+            std::fill_n(destination, count, pixel);
+            break;
+        case BlendMode::SourceOver:
+            blendSourceOver(destination, m_spanBuffer.data(), count, 255);
+            break;
+        case BlendMode::DestinationIn:
+            blendDestinationIn(destination, m_spanBuffer.data(), count, 255);
+            break;
+        }
+    });
+}
+
+void TextureMapperSoftware::clearColor(const Color& color)
+{
+    auto* clip = clipStack();
+    if (!clip)
+        return;
+
+    // Like glClear(), this only honors the scissor box.
+    IntRect rect = intersection(clip->current().scissorBox, IntRect(IntPoint::zero(), m_currentSurface->size()));
+    uint32_t pixel = pixelForColor(color);
+    for (int y = rect.y(); y < rect.maxY(); ++y)
+        std::fill_n(m_currentSurface->row(y) + rect.x(), rect.width(), pixel);
+}
+
+void TextureMapperSoftware::drawBorder(const Color& color, float width, const FloatRect& targetRect, const TransformationMatrix& modelViewMatrix)
+{
+    if (!clipStack() || clipStack()->isCurrentScissorBoxEmpty())
+        return;
+
+    // TextureMapperGL draws a line loop; draw its four sides as rects centered on the edges.
+    float halfWidth = width / 2;
+    FloatRect outerRect(targetRect);
+    outerRect.inflate(halfWidth);
+    FloatRect innerRect(targetRect);
+    innerRect.inflate(-halfWidth);
+
+    drawSolidColor(FloatRect(outerRect.x(), outerRect.y(), outerRect.width(), width), modelViewMatrix, color, true);
+    drawSolidColor(FloatRect(outerRect.x(), innerRect.maxY(), outerRect.width(), width), modelViewMatrix, color, true);
+    drawSolidColor(FloatRect(outerRect.x(), innerRect.y(), width, innerRect.height()), modelViewMatrix, color, true);
+    drawSolidColor(FloatRect(innerRect.maxX(), innerRect.y(), width, innerRect.height()), modelViewMatrix, color, true);
+}
+
+void TextureMapperSoftware::drawNumber(int number, const Color& color, const FloatPoint& targetPoint, const TransformationMatrix& modelViewMatrix)
+{
+    int pointSize = 8;
+
+#if USE(CAIRO)
+    CString counterString = String::number(number).ascii();
+    // cairo_text_extents() requires a cairo_t, so dimensions need to be guesstimated.
+    int width = counterString.length() * pointSize * 1.2;
+    int height = pointSize * 1.5;
+
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+
+    // Software textures use cairo's pixel layout, so unlike TextureMapperGL there is no R+B swap.
+    auto [r, g, b, a] = color.toSRGBALossy<float>();
+    cairo_set_source_rgba(cr, r, g, b, a);
+
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_fill(cr);
+
+    cairo_select_font_face(cr, "Monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, pointSize);
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_move_to(cr, 2, pointSize);
+    cairo_show_text(cr, counterString.data());
+    cairo_surface_flush(surface);
+
+    IntSize size(width, height);
+    IntRect sourceRect(IntPoint::zero(), size);
+    IntRect targetRect(roundedIntPoint(targetPoint), size);
+
+    RefPtr<BitmapTexture> texture = acquireTextureFromPool(size);
+    texture->updateContents(cairo_image_surface_get_data(surface), sourceRect, IntPoint::zero(), cairo_image_surface_get_stride(surface));
+    drawTexture(*texture, targetRect, modelViewMatrix, 1.0f, AllEdges);
+
+    cairo_surface_destroy(surface);
+    cairo_destroy(cr);
+#else
+    UNUSED_PARAM(number);
+    UNUSED_PARAM(color);
+    UNUSED_PARAM(pointSize);
+    UNUSED_PARAM(targetPoint);
+    UNUSED_PARAM(modelViewMatrix);
+    notImplemented();
+#endif
+}
+
+void TextureMapperSoftware::bindSurface(BitmapTexture* surface)
+{
+    if (!surface) {
+        m_currentSurface = m_defaultSurface;
+        return;
+    }
+
+    ASSERT(!surface->isBackedByOpenGL());
+    auto& softwareSurface = static_cast<BitmapTextureSoftware&>(*surface);
+    softwareSurface.bindAsSurface();
+    m_currentSurface = &softwareSurface;
+}
+
+void TextureMapperSoftware::beginClip(const TransformationMatrix& modelViewMatrix, const FloatRoundedRect& targetRect)
+{
+    auto* clip = clipStack();
+    if (!clip)
+        return;
+
+    clip->push();
+
+    FloatQuad quad = modelViewMatrix.projectQuad(targetRect.rect());
+    clip->intersect(quad.enclosingBoundingBox());
+
+    // Rectilinear clips only narrow the scissor box. Everything else is tested per pixel by
+    // drawQuad(), through the same rounded rect list TextureMapperGL feeds to its shaders. Past
+    // s_roundedRectMaxClips, clips fall back to their bounding box.
+    if ((modelViewMatrix.isAffine() && quad.isRectilinear() && !targetRect.isRounded()) || !modelViewMatrix.isInvertible() || !clip->isRoundedRectClipAllowed())
+        return;
+
+    clip->addRoundedRect(targetRect, modelViewMatrix.inverse().value());
+}
+
+void TextureMapperSoftware::endClip()
+{
+    if (auto* clip = clipStack())
+        clip->pop();
+}
+
+IntRect TextureMapperSoftware::clipBounds()
+{
+    auto* clip = clipStack();
+    return clip ? clip->current().scissorBox : IntRect();
+}
+
+Ref<BitmapTexture> TextureMapperSoftware::createTexture()
+{
+    return BitmapTextureSoftware::create();
+}
+
+Ref<BitmapTexture> TextureMapperSoftware::createTexture(int)
+{
+    return BitmapTextureSoftware::create();
+}
+
+} // namespace WebCore
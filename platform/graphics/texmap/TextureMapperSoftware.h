@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "ClipStack.h"
+#include "TextureMapper.h"
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class BitmapTextureSoftware;
+
+// A TextureMapper that composites BitmapTextureSoftware textures in main memory, for machines
+// without a usable GPU. Filters are not applied and edges are not antialiased.
+class TextureMapperSoftware final : public TextureMapper {
+public:
+    WEBCORE_EXPORT static std::unique_ptr<TextureMapperSoftware> create();
+
+    TextureMapperSoftware();
+    virtual ~TextureMapperSoftware();
+
+    // The surface bindSurface(nullptr) binds. It must be a texture created by this TextureMapper,
+    // and holds the composited frame after endPainting().
+    WEBCORE_EXPORT void setDefaultSurface(RefPtr<BitmapTexture>&&);
+
+    void drawBorder(const Color&, float borderWidth, const FloatRect&, const TransformationMatrix&) override;
+    void drawNumber(int number, const Color&, const FloatPoint&, const TransformationMatrix&) override;
+
+    void drawTexture(const BitmapTexture&, const FloatRect& target, const TransformationMatrix& modelViewMatrix = TransformationMatrix(), float opacity = 1.0f, unsigned exposedEdges = AllEdges) override;
+    void drawSolidColor(const FloatRect&, const TransformationMatrix&, const Color&, bool) override;
+    void clearColor(const Color&) override;
+
+    void bindSurface(BitmapTexture* surface) override;
+    void beginClip(const TransformationMatrix&, const FloatRoundedRect&) override;
+    void endClip() override;
+    IntRect clipBounds() override;
+    Ref<BitmapTexture> createTexture() override;
+    Ref<BitmapTexture> createTexture(int internalFormat) override;
+
+    void beginPainting(PaintFlags = 0) override;
+
+    IntSize maxTextureSize() const override { return IntSize(2000, 2000); }
+
+private:
+    enum class BlendMode : uint8_t {
+        Copy,
+        SourceOver,
+        DestinationIn,
+    };
+
+    ClipStack* clipStack();
+
+    // Calls shadeSpan(destination, x, y, count) for every run of pixels of the current surface
+    // whose centers lie inside the transformed rect and the current clip.
+    template<typename ShadeSpan> void drawQuad(const FloatRect&, const TransformationMatrix&, const ShadeSpan&);
+
+    RefPtr<BitmapTextureSoftware> m_defaultSurface;
+    RefPtr<BitmapTextureSoftware> m_currentSurface;
+    Vector<uint32_t> m_spanBuffer;
+};
+
+} // namespace WebCore
@@ -1145,7 +1145,10 @@ void CoordinatedGraphicsLayer::updateContentBuffers()
     // With all the affected tiles created and/or invalidated, we can finally paint them.
     auto dirtyTiles = layerState.mainBackingStore->dirtyTiles();
     if (!dirtyTiles.isEmpty()) {
-        bool didUpdateTiles = false;
+        Vector<SurfaceUpdateInfo> updateInfos;
+        Vector<Nicosia::PaintingEngine::TileUpdate> tileUpdates;
+        updateInfos.reserveInitialCapacity(dirtyTiles.size());
+        tileUpdates.reserveInitialCapacity(dirtyTiles.size());
 
         for (auto& tileReference : dirtyTiles) {
             auto& tile = tileReference.get();
@@ -1159,19 +1162,27 @@ void CoordinatedGraphicsLayer::updateContentBuffers()
             updateInfo.updateRect = dirtyRect;
             updateInfo.updateRect.move(-tileRect.x(), -tileRect.y());
             updateInfo.buffer = coordinatedBuffer.copyRef();
+            updateInfos.uncheckedAppend(WTFMove(updateInfo));
 
-            if (!m_coordinator->paintingEngine().paint(*this, WTFMove(coordinatedBuffer),
-                dirtyRect, layerState.mainBackingStore->mapToContents(dirtyRect),
-                IntRect { { 0, 0 }, dirtyRect.size() }, layerState.mainBackingStore->contentsScale()))
-                continue;
-
-            impl.updateTile(tile.tileID(), updateInfo, tileRect);
+            tileUpdates.uncheckedAppend({ WTFMove(coordinatedBuffer), dirtyRect, layerState.mainBackingStore->mapToContents(dirtyRect) });
+        }
 
+        // All the dirty tiles are handed to the painting engine at once so that it can
+        // share the painting work between them.
+        auto didPaintTiles = m_coordinator->paintingEngine().paintTiles(*this, WTFMove(tileUpdates), layerState.mainBackingStore->contentsScale());
+        ASSERT(didPaintTiles.size() == dirtyTiles.size());
+        bool didPaintAnyTile = false;
+        for (size_t i = 0; i < dirtyTiles.size(); ++i) {
+            // A tile that wasn't painted stays dirty and is painted again on the next update.
+            if (!didPaintTiles[i])
+                continue;
+            auto& tile = dirtyTiles[i].get();
+            impl.updateTile(tile.tileID(), updateInfos[i], tile.rect());
             tile.markClean();
-            didUpdateTiles |= true;
+            didPaintAnyTile = true;
         }
 
-        if (didUpdateTiles)
+        if (didPaintAnyTile)
             didUpdateTileBuffers();
     }
 
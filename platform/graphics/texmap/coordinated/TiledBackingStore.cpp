@@ -30,6 +30,19 @@ namespace WebCore {
 
 static const int defaultTileDimension = 512;
 
+// How far ahead of a scroll tiles are prepainted, and the speed, in pixels per second, at which
+// tiles ahead of the viewport get the most of a head start over tiles behind it.
+static const Seconds prepaintLookahead { 500_ms };
+static const double fastScrollSpeed = 2000;
+
+// Scrolls don't report their end, so a velocity that hasn't been updated for this long is considered stale.
+static const Seconds velocityExpiration { 250_ms };
+
+// Tiles in view are always painted right away; prepainting the rest is spread over several updates.
+static const unsigned maximumPrepaintTilesPerUpdate = 4;
+
+static const size_t tileMemoryBudget = 64 * MB;
+
 static IntPoint innerBottomRight(const IntRect& rect)
 {
     // Actually, the rect does not contain rect.maxX(). Refer to IntRect::contain.
@@ -53,15 +66,46 @@ void TiledBackingStore::setTrajectoryVector(const FloatPoint& trajectoryVector)
     m_pendingTrajectoryVector.normalize();
 }
 
+void TiledBackingStore::setVelocity(const VelocityData& velocity)
+{
+    m_pendingVelocity = VelocityData(velocity.horizontalVelocity * m_contentsScale, velocity.verticalVelocity * m_contentsScale, velocity.scaleChangeRate, velocity.lastUpdateTime);
+    m_haveExternalVelocityData = true;
+}
+
+void TiledBackingStore::updateVelocity(const IntRect& visibleRect)
+{
+    MonotonicTime now = MonotonicTime::now();
+    if (!m_haveExternalVelocityData) {
+        if (!m_historicalVelocityData)
+            m_historicalVelocityData = makeUnique<HistoricalVelocityData>();
+
+        VelocityData velocity = m_historicalVelocityData->velocityForNewData(visibleRect.location(), m_contentsScale, now);
+        // The history keeps reporting the motion it recorded for a while after the visible rect
+        // stops, so only a moving visible rect refreshes the velocity.
+        if (visibleRect.location() == m_visibleRect.location())
+            velocity.lastUpdateTime = m_pendingVelocity.lastUpdateTime;
+        m_pendingVelocity = velocity;
+    }
+
+    if (m_pendingVelocity.velocityOrScaleIsChanging() && now - m_pendingVelocity.lastUpdateTime > velocityExpiration)
+        m_pendingVelocity = VelocityData(0, 0, 0, m_pendingVelocity.lastUpdateTime);
+}
+
 void TiledBackingStore::createTilesIfNeeded(const IntRect& unscaledVisibleRect, const IntRect& contentsRect)
 {
     IntRect scaledContentsRect = mapFromContents(contentsRect);
     IntRect visibleRect = mapFromContents(unscaledVisibleRect);
     float coverAreaMultiplier = MemoryPressureHandler::singleton().isUnderMemoryPressure() ? 1.0f : 2.0f;
+    updateVelocity(visibleRect);
 
-    bool didChange = m_trajectoryVector != m_pendingTrajectoryVector || m_visibleRect != visibleRect || m_rect != scaledContentsRect || m_coverAreaMultiplier != coverAreaMultiplier;
+    bool didChange = m_trajectoryVector != m_pendingTrajectoryVector || !m_velocity.equalIgnoringTimestamp(m_pendingVelocity) || m_visibleRect != visibleRect || m_rect != scaledContentsRect || m_coverAreaMultiplier != coverAreaMultiplier;
     if (didChange || m_pendingTileCreation)
         createTiles(visibleRect, scaledContentsRect, coverAreaMultiplier);
+
+    // Keep updating while there is a velocity, so that the cover rect shrinks back around the
+    // visible rect once it expires even if the visible rect doesn't change anymore.
+    if (m_velocity.velocityOrScaleIsChanging())
+        m_client.tiledBackingStoreHasPendingTileCreation();
 }
 
 void TiledBackingStore::invalidate(const IntRect& contentsDirtyRect)
@@ -89,24 +133,79 @@ void TiledBackingStore::invalidate(const IntRect& contentsDirtyRect)
 
 Vector<std::reference_wrapper<Tile>> TiledBackingStore::dirtyTiles()
 {
-    Vector<std::reference_wrapper<Tile>> tiles;
+    Vector<std::pair<double, std::reference_wrapper<Tile>>> dirtyTiles;
     for (auto& tile : m_tiles.values()) {
         if (tile->isDirty())
-            tiles.append(*tile);
+            dirtyTiles.append({ tilePriority(tile->coordinate()), *tile });
+    }
+    std::sort(dirtyTiles.begin(), dirtyTiles.end(), [](auto& a, auto& b) {
+        return a.first < b.first;
+    });
+
+    // Paint the tiles in view, and only the most urgent of the others, so that a fast scroll doesn't
+    // wait for tiles it is moving away from. The rest are left dirty for the next update.
+    Vector<std::reference_wrapper<Tile>> tiles;
+    unsigned prepaintTileCount = 0;
+    for (auto& dirtyTile : dirtyTiles) {
+        if (dirtyTile.first && prepaintTileCount++ == maximumPrepaintTilesPerUpdate) {
+            m_client.tiledBackingStoreHasPendingTileCreation();
+            break;
+        }
+        tiles.append(dirtyTile.second);
     }
 
     return tiles;
 }
 
-double TiledBackingStore::tileDistance(const IntRect& viewport, const Tile::Coordinate& tileCoordinate) const
+// Lower values are painted first. Tiles intersecting the visible rect come first, then the others
+// by their distance to it in tiles. While scrolling, tiles ahead of the viewport have that distance
+// shrunk by up to half and tiles behind it have it stretched by as much, depending on the speed.
+double TiledBackingStore::tilePriority(const Tile::Coordinate& tileCoordinate) const
 {
-    if (viewport.intersects(tileRectForCoordinate(tileCoordinate)))
+    IntRect tileRect(tileCoordinate.x() * m_tileSize.width(), tileCoordinate.y() * m_tileSize.height(), m_tileSize.width(), m_tileSize.height());
+    if (m_visibleRect.intersects(tileRect))
         return 0;
 
-    IntPoint viewCenter = viewport.location() + IntSize(viewport.width() / 2, viewport.height() / 2);
-    Tile::Coordinate centerCoordinate = tileCoordinateForPoint(viewCenter);
+    double horizontalGap = std::max({ 0, m_visibleRect.x() - tileRect.maxX(), tileRect.x() - m_visibleRect.maxX() });
+    double verticalGap = std::max({ 0, m_visibleRect.y() - tileRect.maxY(), tileRect.y() - m_visibleRect.maxY() });
+    double distance = 1 + std::hypot(horizontalGap / m_tileSize.width(), verticalGap / m_tileSize.height());
+
+    double speed = std::hypot(m_velocity.horizontalVelocity, m_velocity.verticalVelocity);
+    FloatSize toTile = FloatRect(tileRect).center() - FloatRect(m_visibleRect).center();
+    double toTileLength = std::hypot(toTile.width(), toTile.height());
+    if (!speed || !toTileLength)
+        return distance;
+
+    double alignment = (toTile.width() * m_velocity.horizontalVelocity + toTile.height() * m_velocity.verticalVelocity) / (toTileLength * speed);
+    return distance * (1 - 0.5 * alignment * std::min(1.0, speed / fastScrollSpeed));
+}
 
-    return std::max(abs(centerCoordinate.y() - tileCoordinate.y()), abs(centerCoordinate.x() - tileCoordinate.x()));
+size_t TiledBackingStore::maximumTileCount() const
+{
+    return std::max<size_t>(1, tileMemoryBudget / (m_tileSize.unclampedArea() * 4));
+}
+
+void TiledBackingStore::enforceTileMemoryBudget()
+{
+    size_t maximumTileCount = this->maximumTileCount();
+    if (m_tiles.size() <= maximumTileCount)
+        return;
+
+    // Tiles in view are kept even if that goes over budget.
+    Vector<std::pair<double, Tile::Coordinate>> tiles;
+    for (auto& coordinate : m_tiles.keys()) {
+        if (double priority = tilePriority(coordinate))
+            tiles.append({ priority, coordinate });
+    }
+    std::sort(tiles.begin(), tiles.end(), [](auto& a, auto& b) {
+        return a.first > b.first;
+    });
+
+    for (auto& tile : tiles) {
+        if (m_tiles.size() <= maximumTileCount)
+            break;
+        m_tiles.remove(tile.second);
+    }
 }
 
 // Returns a ratio between 0.0f and 1.0f of the surface covered by rendered tiles.
@@ -141,6 +240,7 @@ void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& s
     // Update our backing store geometry.
     m_rect = scaledContentsRect;
     m_trajectoryVector = m_pendingTrajectoryVector;
+    m_velocity = m_pendingVelocity;
     m_visibleRect = visibleRect;
     m_coverAreaMultiplier = coverAreaMultiplier;
 
@@ -181,6 +281,13 @@ void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& s
     if (coverRect.isEmpty())
         return;
 
+    // Tiles created for an earlier cover rect but never painted are dropped once they leave the
+    // cover rect, cancelling work for areas the viewport has moved away from.
+    m_tiles.removeIf([&coverRect](auto& entry) {
+        return !entry.value->isReadyToPaint() && !entry.value->rect().intersects(coverRect);
+    });
+    enforceTileMemoryBudget();
+
     // Resize tiles at the edge in case the contents size has changed, but only do so
     // after having dropped tiles outside the keep rect.
     if (m_previousRect != m_rect) {
@@ -188,8 +295,8 @@ void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& s
         resizeEdgeTiles();
     }
 
-    // Search for the tile position closest to the viewport center that does not yet contain a tile.
-    // Which position is considered the closest depends on the tileDistance function.
+    // Search for the tile positions with the highest priority that do not yet contain a tile. Priorities
+    // are grouped in rings one tile wide, so that tiles are created a ring at a time.
     double shortestDistance = std::numeric_limits<double>::infinity();
     Vector<Tile::Coordinate> tilesToCreate;
     unsigned requiredTileCount = 0;
@@ -205,7 +312,7 @@ void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& s
             if (m_tiles.contains(currentCoordinate))
                 continue;
             ++requiredTileCount;
-            double distance = tileDistance(m_visibleRect, currentCoordinate);
+            double distance = std::ceil(tilePriority(currentCoordinate));
             if (distance > shortestDistance)
                 continue;
             if (distance < shortestDistance) {
@@ -216,6 +323,16 @@ void TiledBackingStore::createTiles(const IntRect& visibleRect, const IntRect& s
         }
     }
 
+    // Tiles out of view are only created within the tile memory budget.
+    if (shortestDistance) {
+        size_t maximumTileCount = this->maximumTileCount();
+        size_t availableTileCount = m_tiles.size() < maximumTileCount ? maximumTileCount - m_tiles.size() : 0;
+        if (!availableTileCount)
+            requiredTileCount = 0;
+        if (tilesToCreate.size() > availableTileCount)
+            tilesToCreate.shrink(availableTileCount);
+    }
+
     // Now construct the tile(s) within the shortest distance.
     unsigned tilesToCreateCount = tilesToCreate.size();
     for (unsigned n = 0; n < tilesToCreateCount; ++n) {
@@ -284,24 +401,15 @@ void TiledBackingStore::computeCoverAndKeepRect(const IntRect& visibleRect, IntR
         coverRect.inflateY(visibleRect.height() * (m_coverAreaMultiplier - 1) / 2);
         keepRect = coverRect;
 
-        if (m_trajectoryVector != FloatPoint::zero()) {
-            // A null trajectory vector (no motion) means that tiles for the coverArea will be created.
-            // A non-null trajectory vector will shrink the covered rect to visibleRect plus its expansion from its
-            // center toward the cover area edges in the direction of the given vector.
-
-            // E.g. if visibleRect == (10,10)5x5 and coverAreaMultiplier == 3.0:
-            // a (0,0) trajectory vector will create tiles intersecting (5,5)15x15,
-            // a (1,0) trajectory vector will create tiles intersecting (10,10)10x5,
-            // and a (1,1) trajectory vector will create tiles intersecting (10,10)10x10.
-
-            // Multiply the vector by the distance to the edge of the cover area.
-            float trajectoryVectorMultiplier = (m_coverAreaMultiplier - 1) / 2;
-
-            // Unite the visible rect with a "ghost" of the visible rect moved in the direction of the trajectory vector.
+        FloatSize offset = prepaintOffset(visibleRect);
+        if (!offset.isZero()) {
+            // A zero offset (no motion) means that tiles for the coverArea will be created.
+            // Otherwise the covered rect shrinks to the visibleRect united with a "ghost" of it
+            // moved by the offset, and the keep rect grows to hold it.
             coverRect = visibleRect;
-            coverRect.move(coverRect.width() * m_trajectoryVector.x() * trajectoryVectorMultiplier, coverRect.height() * m_trajectoryVector.y() * trajectoryVectorMultiplier);
-
+            coverRect.move(flooredIntSize(offset));
             coverRect.unite(visibleRect);
+            keepRect.unite(coverRect);
         }
         ASSERT(keepRect.contains(coverRect));
     }
@@ -317,6 +425,23 @@ void TiledBackingStore::computeCoverAndKeepRect(const IntRect& visibleRect, IntR
     ASSERT(coverRect.isEmpty() || keepRect.contains(coverRect));
 }
 
+// How far ahead of the visible rect to prepaint. While scrolling, that is where the viewport will be after
+// prepaintLookahead, up to the cover area in that direction. Without a velocity, a trajectory vector set by
+// the client moves the visible rect toward the edges of the cover area; e.g. if visibleRect == (10,10)5x5
+// and coverAreaMultiplier == 3.0, a (1,0) trajectory vector will cover (10,10)10x5, and (1,1) (10,10)10x10.
+FloatSize TiledBackingStore::prepaintOffset(const IntRect& visibleRect) const
+{
+    if (m_velocity.horizontalVelocity || m_velocity.verticalVelocity) {
+        float maximumWidth = visibleRect.width() * (m_coverAreaMultiplier - 1);
+        float maximumHeight = visibleRect.height() * (m_coverAreaMultiplier - 1);
+        return FloatSize(clampTo<float>(m_velocity.horizontalVelocity * prepaintLookahead.seconds(), -maximumWidth, maximumWidth),
+            clampTo<float>(m_velocity.verticalVelocity * prepaintLookahead.seconds(), -maximumHeight, maximumHeight));
+    }
+
+    float trajectoryVectorMultiplier = (m_coverAreaMultiplier - 1) / 2;
+    return FloatSize(visibleRect.width() * m_trajectoryVector.x() * trajectoryVectorMultiplier, visibleRect.height() * m_trajectoryVector.y() * trajectoryVectorMultiplier);
+}
+
 void TiledBackingStore::resizeEdgeTiles()
 {
     Vector<Tile::Coordinate> tilesToRemove;
@@ -26,6 +26,7 @@
 #include "IntPoint.h"
 #include "IntRect.h"
 #include "Tile.h"
+#include "VelocityData.h"
 #include <wtf/Assertions.h>
 #include <wtf/HashMap.h>
 
@@ -43,6 +44,8 @@ public:
     TiledBackingStoreClient& client() { return m_client; }
 
     void setTrajectoryVector(const FloatPoint&);
+    // Overrides the scroll velocity otherwise estimated from successive visible rects, in contents coordinates.
+    void setVelocity(const VelocityData&);
     void createTilesIfNeeded(const IntRect& unscaledVisibleRect, const IntRect& contentsRect);
 
     float contentsScale() { return m_contentsScale; }
@@ -56,7 +59,7 @@ public:
 
     IntRect tileRectForCoordinate(const Tile::Coordinate&) const;
     Tile::Coordinate tileCoordinateForPoint(const IntPoint&) const;
-    double tileDistance(const IntRect& viewport, const Tile::Coordinate&) const;
+    double tilePriority(const Tile::Coordinate&) const;
 
     IntRect coverRect() const { return m_coverRect; }
     bool visibleAreaIsCovered() const;
@@ -66,6 +69,11 @@ private:
     void createTiles(const IntRect& visibleRect, const IntRect& scaledContentsRect, float coverAreaMultiplier);
     void computeCoverAndKeepRect(const IntRect& visibleRect, IntRect& coverRect, IntRect& keepRect) const;
 
+    void updateVelocity(const IntRect& visibleRect);
+    FloatSize prepaintOffset(const IntRect& visibleRect) const;
+    size_t maximumTileCount() const;
+    void enforceTileMemoryBudget();
+
     void resizeEdgeTiles();
     void setCoverRect(const IntRect& rect) { m_coverRect = rect; }
     void setKeepRect(const IntRect&);
@@ -86,6 +94,10 @@ private:
 
     FloatPoint m_trajectoryVector;
     FloatPoint m_pendingTrajectoryVector;
+    VelocityData m_velocity;
+    VelocityData m_pendingVelocity;
+    std::unique_ptr<HistoricalVelocityData> m_historicalVelocityData;
+    bool m_haveExternalVelocityData { false };
     IntRect m_visibleRect;
 
     IntRect m_coverRect;
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ImageBackingStore.h"
+
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#if CPU(X86_64) && COMPILER(GCC_COMPATIBLE)
+#include <immintrin.h>
+#define HAVE_AVX2_ROW_KERNELS 1
+#endif
+#elif HAVE(ARM_NEON_INTRINSICS) && !CPU(BIG_ENDIAN)
+#include <arm_neon.h>
+#endif
+
+namespace WebCore {
+
+// The row kernels produce exactly what pixelValue() does for each pixel. Premultiplying by
+// c * a / 255, rounded down, gives 0 for a == 0 and c for a == 255 without any branches, and
+// (x + 1 + (x >> 8)) >> 8 is x / 255, rounded down, for every x up to 255 * 255.
+
+static inline uint32_t packedPixel(unsigned r, unsigned g, unsigned b, unsigned a)
+{
+    return a << 24 | r << 16 | g << 8 | b;
+}
+
+static inline unsigned premultipliedComponent(unsigned component, unsigned alpha)
+{
+    unsigned product = component * alpha;
+    return (product + 1 + (product >> 8)) >> 8;
+}
+
+#if defined(HAVE_AVX2_ROW_KERNELS)
+// WebCore is built for the baseline ISA, so the AVX2 kernel is compiled for AVX2 on its own and only
+// called once the CPU is known to support it.
+static bool cpuSupportsAVX2()
+{
+    static const bool supportsAVX2 = __builtin_cpu_supports("avx2");
+    return supportsAVX2;
+}
+
+__attribute__((target("avx2"))) static unsigned setRGBRowAVX2(uint32_t* dest, const uint8_t* source, unsigned width)
+{
+    // Eight pixels take 24 bytes, and the 32 byte load reads eight bytes past them, so stop 11 pixels
+    // short of the end. The permute moves pixels 4 to 7 into the upper 128-bit lane, since the byte
+    // shuffle can't cross lanes, and the shuffle then swaps red and blue and makes room for alpha.
+    const __m256i lanePermutation = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i rgbToBGRX = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+        2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m256i opaque = _mm256_set1_epi32(static_cast<int>(0xff000000));
+
+    unsigned x = 0;
+    for (; x + 11 <= width; x += 8) {
+        __m256i rgb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + x * 3));
+        __m256i bgrx = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(rgb, lanePermutation), rgbToBGRX);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x), _mm256_or_si256(bgrx, opaque));
+    }
+    return x;
+}
+#endif
+
+void ImageBackingStore::setRGBRow(uint32_t* dest, const uint8_t* source, unsigned width)
+{
+    ASSERT(dest);
+    unsigned x = 0;
+
+#if CPU(X86_SSE2)
+#if defined(HAVE_AVX2_ROW_KERNELS)
+    if (cpuSupportsAVX2())
+        x = setRGBRowAVX2(dest, source, width);
+#endif
+    // SSE2 has no byte shuffle, so each of four pixels is shifted from its three bytes into its 32-bit
+    // lane, then red and blue are swapped with shifts. Four pixels take 12 bytes, and the 16 byte load
+    // reads four bytes past them, so stop 6 pixels short of the end.
+    const __m128i laneMasks[4] = { _mm_setr_epi32(0xffffff, 0, 0, 0), _mm_setr_epi32(0, 0xffffff, 0, 0),
+        _mm_setr_epi32(0, 0, 0xffffff, 0), _mm_setr_epi32(0, 0, 0, 0xffffff) };
+    const __m128i greenMask = _mm_set1_epi32(0x00ff00);
+    const __m128i redMask = _mm_set1_epi32(0xff0000);
+    const __m128i blueMask = _mm_set1_epi32(0x0000ff);
+    const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xff000000));
+    for (; x + 6 <= width; x += 4) {
+        __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 3));
+        __m128i rgbx = _mm_or_si128(_mm_or_si128(_mm_and_si128(rgb, laneMasks[0]), _mm_and_si128(_mm_slli_si128(rgb, 1), laneMasks[1])),
+            _mm_or_si128(_mm_and_si128(_mm_slli_si128(rgb, 2), laneMasks[2]), _mm_and_si128(_mm_slli_si128(rgb, 3), laneMasks[3])));
+        __m128i bgra = _mm_or_si128(_mm_or_si128(_mm_and_si128(rgbx, greenMask), opaque),
+            _mm_or_si128(_mm_and_si128(_mm_slli_epi32(rgbx, 16), redMask), _mm_and_si128(_mm_srli_epi32(rgbx, 16), blueMask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), bgra);
+    }
+#elif HAVE(ARM_NEON_INTRINSICS) && !CPU(BIG_ENDIAN)
+    uint8x16_t opaque = vdupq_n_u8(255);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x3_t rgb = vld3q_u8(source + x * 3);
+        uint8x16x4_t bgra = { { rgb.val[2], rgb.val[1], rgb.val[0], opaque } };
+        vst4q_u8(reinterpret_cast<uint8_t*>(dest + x), bgra);
+    }
+#endif
+
+    source += x * 3;
+    for (; x < width; ++x, source += 3)
+        dest[x] = packedPixel(source[0], source[1], source[2], 255);
+}
+
+void ImageBackingStore::setRGBARow(uint32_t* dest, const uint8_t* source, unsigned width)
+{
+    ASSERT(dest);
+    unsigned x = 0;
+
+#if CPU(X86_SSE2)
+    // Each 16-bit lane holds one component. Alpha lanes are multiplied by 255 so that they are
+    // left unchanged by the division, and so are all lanes when alpha is not premultiplied.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i alphaLaneFactor = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i allLanesFactor = _mm_set1_epi16(255);
+    const __m128i one = _mm_set1_epi16(1);
+
+    auto convertTwoPixels = [&](__m128i pixels) {
+        // RGBA to BGRA.
+        pixels = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+        __m128i factors = allLanesFactor;
+        if (m_premultiplyAlpha) {
+            __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            factors = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), alphaLaneFactor);
+        }
+        __m128i products = _mm_mullo_epi16(pixels, factors);
+        return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(products, one), _mm_srli_epi16(products, 8)), 8);
+    };
+
+    for (; x + 4 <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 4));
+        __m128i low = convertTwoPixels(_mm_unpacklo_epi8(pixels, zero));
+        __m128i high = convertTwoPixels(_mm_unpackhi_epi8(pixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), _mm_packus_epi16(low, high));
+    }
+#elif HAVE(ARM_NEON_INTRINSICS) && !CPU(BIG_ENDIAN)
+    const uint16x8_t one = vdupq_n_u16(1);
+
+    auto premultiply = [&](uint8x8_t component, uint8x8_t alpha) {
+        uint16x8_t products = vmull_u8(component, alpha);
+        return vshrn_n_u16(vaddq_u16(vaddq_u16(products, one), vshrq_n_u16(products, 8)), 8);
+    };
+
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t rgba = vld4_u8(source + x * 4);
+        uint8x8x4_t bgra = { { rgba.val[2], rgba.val[1], rgba.val[0], rgba.val[3] } };
+        if (m_premultiplyAlpha) {
+            bgra.val[0] = premultiply(rgba.val[2], rgba.val[3]);
+            bgra.val[1] = premultiply(rgba.val[1], rgba.val[3]);
+            bgra.val[2] = premultiply(rgba.val[0], rgba.val[3]);
+        }
+        vst4_u8(reinterpret_cast<uint8_t*>(dest + x), bgra);
+    }
+#endif
+
+    source += x * 4;
+    if (m_premultiplyAlpha) {
+        for (; x < width; ++x, source += 4) {
+            unsigned a = source[3];
+            dest[x] = packedPixel(premultipliedComponent(source[0], a), premultipliedComponent(source[1], a), premultipliedComponent(source[2], a), a);
+        }
+        return;
+    }
+
+    for (; x < width; ++x, source += 4)
+        dest[x] = packedPixel(source[0], source[1], source[2], source[3]);
+}
+
+void ImageBackingStore::setGrayRow(uint32_t* dest, const uint8_t* source, unsigned width)
+{
+    ASSERT(dest);
+    unsigned x = 0;
+
+#if CPU(X86_SSE2)
+    const __m128i opaque = _mm_set1_epi8(-1);
+    for (; x + 16 <= width; x += 16) {
+        __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+        // Interleave gray with itself for the blue and green bytes, and with 255 for the red
+        // and alpha bytes, then interleave the two.
+        __m128i grayGray[2] = { _mm_unpacklo_epi8(gray, gray), _mm_unpackhi_epi8(gray, gray) };
+        __m128i grayOpaque[2] = { _mm_unpacklo_epi8(gray, opaque), _mm_unpackhi_epi8(gray, opaque) };
+        auto* destination = reinterpret_cast<__m128i*>(dest + x);
+        for (unsigned half = 0; half < 2; ++half) {
+            _mm_storeu_si128(destination++, _mm_unpacklo_epi16(grayGray[half], grayOpaque[half]));
+            _mm_storeu_si128(destination++, _mm_unpackhi_epi16(grayGray[half], grayOpaque[half]));
+        }
+    }
+#elif HAVE(ARM_NEON_INTRINSICS) && !CPU(BIG_ENDIAN)
+    uint8x16_t opaque = vdupq_n_u8(255);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t gray = vld1q_u8(source + x);
+        uint8x16x4_t bgra = { { gray, gray, gray, opaque } };
+        vst4q_u8(reinterpret_cast<uint8_t*>(dest + x), bgra);
+    }
+#endif
+
+    for (; x < width; ++x)
+        dest[x] = packedPixel(source[x], source[x], source[x], 255);
+}
+
+} // namespace WebCore
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Apple Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ImageRowDownsampler.h"
+
+#include "ImageBackingStore.h"
+
+namespace WebCore {
+
+ImageRowDownsampler::ImageRowDownsampler(unsigned downscaleFactor, const IntRect& sourceRect, const IntPoint& destinationOrigin)
+    : m_downscaleFactor(downscaleFactor)
+    , m_sourceRect(sourceRect)
+    , m_destinationOrigin(destinationOrigin)
+{
+    ASSERT(downscaleFactor);
+    m_sums.grow(destinationRect().width());
+}
+
+IntRect ImageRowDownsampler::destinationRect() const
+{
+    if (m_sourceRect.isEmpty())
+        return { };
+
+    int x = m_sourceRect.x() / m_downscaleFactor;
+    int y = m_sourceRect.y() / m_downscaleFactor;
+    return IntRect(x, y, (m_sourceRect.maxX() - 1) / m_downscaleFactor + 1 - x, (m_sourceRect.maxY() - 1) / m_downscaleFactor + 1 - y);
+}
+
+void ImageRowDownsampler::clearAccumulatedRows()
+{
+    for (auto& sums : m_sums)
+        sums = { };
+}
+
+void ImageRowDownsampler::addRow(ImageBackingStore& backingStore, int y, const uint8_t* pixels, bool hasAlpha)
+{
+    ASSERT(y >= m_sourceRect.y() && y < m_sourceRect.maxY());
+
+    // Decoding started over, e.g. because more data arrived.
+    if (y <= m_lastY)
+        clearAccumulatedRows();
+    m_lastY = y;
+
+    unsigned bytesPerPixel = hasAlpha ? 4 : 3;
+    int firstColumn = destinationRect().x();
+    for (int x = m_sourceRect.x(); x < m_sourceRect.maxX(); ++x, pixels += bytesPerPixel) {
+        auto& sums = m_sums[x / m_downscaleFactor - firstColumn];
+        unsigned alpha = hasAlpha ? pixels[3] : 255;
+        sums.red += pixels[0] * alpha;
+        sums.green += pixels[1] * alpha;
+        sums.blue += pixels[2] * alpha;
+        sums.alpha += alpha;
+        ++sums.count;
+    }
+
+    if (!((y + 1) % m_downscaleFactor) || y == m_sourceRect.maxY() - 1) {
+        writeAccumulatedRows(backingStore, y / m_downscaleFactor);
+        clearAccumulatedRows();
+    }
+}
+
+void ImageRowDownsampler::writeAccumulatedRows(ImageBackingStore& backingStore, int destinationY)
+{
+    int firstColumn = destinationRect().x();
+    auto* address = backingStore.pixelAt(firstColumn - m_destinationOrigin.x(), destinationY - m_destinationOrigin.y());
+    for (auto& sums : m_sums) {
+        if (!sums.alpha)
+            backingStore.setPixel(address++, 0, 0, 0, 0);
+        else {
+            uint64_t halfAlpha = sums.alpha / 2;
+            backingStore.setPixel(address++, (sums.red + halfAlpha) / sums.alpha, (sums.green + halfAlpha) / sums.alpha, (sums.blue + halfAlpha) / sums.alpha, (sums.alpha + sums.count / 2) / sums.count);
+        }
+    }
+}
+
+} // namespace WebCore
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2020 Apple Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "IntRect.h"
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class ImageBackingStore;
+
+// Box-filters the rows of an image into a backing store downscaleFactor times smaller in each
+// direction as they are decoded, so that an image drawn much smaller than its intrinsic size
+// never needs a full-size buffer. Each destination pixel is the average of the source pixels
+// in its downscaleFactor x downscaleFactor box, weighted by alpha.
+class ImageRowDownsampler {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // sourceRect is the area of the full-size image the rows cover, e.g. a frame rect. Pixels are
+    // written to the backing store at their destination coordinates minus destinationOrigin, for
+    // backing stores that hold only part of the downscaled image.
+    ImageRowDownsampler(unsigned downscaleFactor, const IntRect& sourceRect, const IntPoint& destinationOrigin = { });
+
+    const IntRect& sourceRect() const { return m_sourceRect; }
+
+    // The destination pixels sourceRect maps to.
+    IntRect destinationRect() const;
+
+    // Adds the row of sourceRect at y, given as sourceRect.width() RGB or RGBA pixels. Rows have
+    // to come in order; a destination row is written once the last source row of its box arrives.
+    void addRow(ImageBackingStore&, int y, const uint8_t* pixels, bool hasAlpha);
+
+private:
+    void clearAccumulatedRows();
+    void writeAccumulatedRows(ImageBackingStore&, int destinationY);
+
+    struct Sums {
+        uint64_t red { 0 };
+        uint64_t green { 0 };
+        uint64_t blue { 0 };
+        uint64_t alpha { 0 };
+        unsigned count { 0 };
+    };
+
+    unsigned m_downscaleFactor;
+    IntRect m_sourceRect;
+    IntPoint m_destinationOrigin;
+    Vector<Sums> m_sums;
+    int m_lastY { -1 };
+};
+
+} // namespace WebCore
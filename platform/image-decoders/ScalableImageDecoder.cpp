@@ -180,8 +180,10 @@ unsigned ScalableImageDecoder::frameBytesAtIndex(size_t index, SubsamplingLevel)
     LockHolder lockHolder(m_mutex);
     if (m_frameBufferCache.size() <= index)
         return 0;
-    // FIXME: Use the dimension of the requested frame.
-    return (m_size.area() * sizeof(uint32_t)).unsafeGet();
+    // A decoded frame may be smaller than the image, e.g. when it was decoded for a smaller sizeForDrawing.
+    auto& frame = m_frameBufferCache[index];
+    IntSize frameSize = frame.hasBackingStore() ? frame.size() : decodedSize();
+    return (frameSize.area() * sizeof(uint32_t)).unsafeGet();
 }
 
 Seconds ScalableImageDecoder::frameDurationAtIndex(size_t index) const
@@ -204,13 +206,84 @@ Seconds ScalableImageDecoder::frameDurationAtIndex(size_t index) const
     return duration;
 }
 
-PlatformImagePtr ScalableImageDecoder::createFrameImageAtIndex(size_t index, SubsamplingLevel, const DecodingOptions&)
+static IntRect downscaledRect(const IntRect& rect, unsigned downscaleFactor)
+{
+    if (downscaleFactor == 1 || rect.isEmpty())
+        return rect;
+
+    int x = rect.x() / downscaleFactor;
+    int y = rect.y() / downscaleFactor;
+    return IntRect(x, y, (rect.maxX() + downscaleFactor - 1) / downscaleFactor - x, (rect.maxY() + downscaleFactor - 1) / downscaleFactor - y);
+}
+
+IntRect ScalableImageDecoder::downscaledDecodedRect() const
+{
+    return downscaledRect(decodedRect(), m_downscaleFactor);
+}
+
+IntSize ScalableImageDecoder::downscaledSize() const
+{
+    return downscaledRect(IntRect({ }, size()), m_downscaleFactor).size();
+}
+
+void ScalableImageDecoder::setDecodedRectAndDownscaleFactor(const IntRect& decodedRect, unsigned downscaleFactor)
+{
+    if (decodedRect == m_decodedRect && downscaleFactor == m_downscaleFactor)
+        return;
+
+    // The frames decoded so far cover the wrong pixels, so decoding starts over.
+    m_decodedRect = decodedRect;
+    m_downscaleFactor = downscaleFactor;
+    m_frameBufferCache.clear();
+    resetDecoding();
+}
+
+PlatformImagePtr ScalableImageDecoder::createDownscaledFrameImageAtIndex(size_t index, const IntSize& sizeForDrawing)
+{
+    if (!isAllDataReceived() || !m_data)
+        return nullptr;
+
+    IntSize minimumSize = sizeForDrawing.expandedTo({ 1, 1 });
+    unsigned maximumFactor = std::max(1, std::min(size().width() / minimumSize.width(), size().height() / minimumSize.height()));
+    if (maximumFactor == 1)
+        return nullptr;
+
+    // The frame is decoded by a decoder of its own, so that requests for different sizes don't
+    // throw away each other's frames, nor the progress of this decoder on the full-size ones.
+    // It reads the encoded data this decoder holds, which doesn't change once all of it was received.
+    auto data = SharedBuffer::create(makeRef(*m_data));
+    auto decoder = create(data, m_premultiplyAlpha ? AlphaOption::Premultiplied : AlphaOption::NotPremultiplied, m_ignoreGammaAndColorProfile ? GammaAndColorProfileOption::Ignored : GammaAndColorProfileOption::Applied);
+    if (!decoder)
+        return nullptr;
+    decoder->setData(data, true);
+
+    LockHolder lockHolder(decoder->m_mutex);
+    if (decoder->size() != size())
+        return nullptr;
+
+    unsigned downscaleFactor = decoder->supportedDownscaleFactor(maximumFactor);
+    if (downscaleFactor == 1)
+        return nullptr;
+    decoder->setDecodedRectAndDownscaleFactor({ }, downscaleFactor);
+
+    auto* buffer = decoder->frameBufferAtIndex(index);
+    if (!buffer || !buffer->isComplete() || !buffer->hasBackingStore())
+        return nullptr;
+    return buffer->backingStore()->image();
+}
+
+PlatformImagePtr ScalableImageDecoder::createFrameImageAtIndex(size_t index, SubsamplingLevel, const DecodingOptions& decodingOptions)
 {
     LockHolder lockHolder(m_mutex);
     // Zero-height images can cause problems for some ports. If we have an empty image dimension, just bail.
     if (size().isEmpty())
         return nullptr;
 
+    if (decodingOptions.hasSizeForDrawing()) {
+        if (auto image = createDownscaledFrameImageAtIndex(index, *decodingOptions.sizeForDrawing()))
+            return image;
+    }
+
     auto* buffer = frameBufferAtIndex(index);
     if (!buffer || buffer->isInvalid() || !buffer->hasBackingStore())
         return nullptr;
@@ -220,6 +293,47 @@ PlatformImagePtr ScalableImageDecoder::createFrameImageAtIndex(size_t index, Sub
     return buffer->backingStore()->image();
 }
 
+unsigned ScalableImageDecoder::regionDownscaleFactor(unsigned maximumFactor) const
+{
+    LockHolder lockHolder(m_mutex);
+    if (!supportsRegionDecoding())
+        return 1;
+    return supportedDownscaleFactor(maximumFactor);
+}
+
+Vector<PlatformImagePtr> ScalableImageDecoder::createRegionImages(const IntRect& rect, unsigned downscaleFactor, const Vector<IntRect>& tileRects)
+{
+    LockHolder lockHolder(m_mutex);
+    IntRect imageRect({ }, size());
+    if (!supportsRegionDecoding() || imageRect.isEmpty())
+        return { };
+
+    IntRect region = intersection(rect, imageRect);
+    ASSERT(!(region.x() % downscaleFactor) && !(region.y() % downscaleFactor));
+    if (region.isEmpty())
+        return { };
+
+    unsigned frameDownscaleFactor = m_downscaleFactor;
+    setDecodedRectAndDownscaleFactor(region, downscaleFactor);
+
+    Vector<PlatformImagePtr> images;
+    auto* buffer = frameBufferAtIndex(0);
+    if (buffer && buffer->isComplete() && buffer->hasBackingStore()) {
+        IntRect decodedRegion = downscaledDecodedRect();
+        for (auto& tileRect : tileRects) {
+            IntRect tile = intersection(downscaledRect(intersection(tileRect, region), downscaleFactor), decodedRegion);
+            tile.moveBy(-decodedRegion.location());
+            auto backingStore = ImageBackingStore::create(*buffer->backingStore(), tile);
+            images.append(backingStore ? backingStore->image() : nullptr);
+        }
+    }
+
+    // The caller keeps the tiles, and the next region is most likely a different one, so the
+    // buffer for this one is dropped rather than kept next to them.
+    setDecodedRectAndDownscaleFactor({ }, frameDownscaleFactor);
+    return images;
+}
+
 #if USE(DIRECT2D)
 void ScalableImageDecoder::setTargetContext(ID2D1RenderTarget*)
 {
@@ -118,7 +118,8 @@ public:
         if (ImageBackingStore::isOverSize(size))
             return setFailed();
         m_size = size;
-        m_encodedDataStatus = EncodedDataStatus::SizeAvailable;
+        // The header is read again when decoding restarts at a different size; don't lose track of the data being complete.
+        m_encodedDataStatus = std::max(m_encodedDataStatus, EncodedDataStatus::SizeAvailable);
         return true;
     }
 
@@ -146,6 +147,9 @@ public:
 
     PlatformImagePtr createFrameImageAtIndex(size_t, SubsamplingLevel = SubsamplingLevel::Default, const DecodingOptions& = DecodingOptions(DecodingMode::Synchronous)) override;
 
+    unsigned regionDownscaleFactor(unsigned maximumFactor) const final;
+    Vector<PlatformImagePtr> createRegionImages(const IntRect&, unsigned downscaleFactor, const Vector<IntRect>& tileRects) final;
+
     void setIgnoreGammaAndColorProfile(bool flag) { m_ignoreGammaAndColorProfile = flag; }
     bool ignoresGammaAndColorProfile() const { return m_ignoreGammaAndColorProfile; }
 
@@ -195,6 +199,29 @@ public:
     Optional<IntPoint> hotSpot() const override { return WTF::nullopt; }
 
 protected:
+    // Frames are decoded to size() divided by this factor in each direction, rounded up. It is
+    // more than 1 in the decoders createFrameImageAtIndex() makes for frames requested at a size
+    // that much smaller than the image, and while decoding a region.
+    unsigned downscaleFactor() const { return m_downscaleFactor; }
+
+    // The part of the image being decoded, which is all of it unless createRegionImages() is
+    // decoding a region. decodedRect() is in image coordinates and downscaledDecodedRect() in
+    // the coordinates of the image divided by downscaleFactor(). Frame buffers are decodedSize(),
+    // and the whole image divided by downscaleFactor() is downscaledSize().
+    IntRect decodedRect() const { return m_decodedRect.isEmpty() ? IntRect({ }, size()) : m_decodedRect; }
+    IntRect downscaledDecodedRect() const;
+    IntSize decodedSize() const { return downscaledDecodedRect().size(); }
+    IntSize downscaledSize() const;
+    bool isDecodingRegion() const { return !m_decodedRect.isEmpty(); }
+
+    // Returns the largest factor, no larger than maximumFactor, that the decoder can divide the
+    // size of the image by while decoding.
+    virtual unsigned supportedDownscaleFactor(unsigned) const { return 1; }
+
+    // Called when the downscale factor or the decoded rect changes, after the decoded frames have been dropped, so
+    // that decoding starts over from the beginning of the data.
+    virtual void resetDecoding() { }
+
     RefPtr<SharedBuffer::DataSegment> m_data;
     Vector<ScalableImageDecoderFrame, 1> m_frameBufferCache;
     mutable Lock m_mutex;
@@ -206,11 +233,16 @@ protected:
 private:
     virtual void tryDecodeSize(bool) = 0;
 
+    PlatformImagePtr createDownscaledFrameImageAtIndex(size_t, const IntSize& sizeForDrawing);
+    void setDecodedRectAndDownscaleFactor(const IntRect&, unsigned);
+
 #if USE(DIRECT2D)
     void setTargetContext(ID2D1RenderTarget*) override;
 #endif
 
     IntSize m_size;
+    unsigned m_downscaleFactor { 1 };
+    IntRect m_decodedRect;
     EncodedDataStatus m_encodedDataStatus { EncodedDataStatus::TypeAvailable };
     bool m_decodingSizeFromSetData { false };
 };
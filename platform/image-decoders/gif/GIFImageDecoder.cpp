@@ -147,6 +147,7 @@ ScalableImageDecoderFrame* GIFImageDecoder::frameBufferAtIndex(size_t index)
 bool GIFImageDecoder::setFailed()
 {
     m_reader = nullptr;
+    m_downsampler = nullptr;
     return ScalableImageDecoder::setFailed();
 }
 
@@ -234,6 +235,28 @@ bool GIFImageDecoder::haveDecodedRow(unsigned frameIndex, const Vector<unsigned
     if ((buffer.isInvalid() && !initFrameBuffer(frameIndex)) || !buffer.hasBackingStore())
         return false;
 
+    if (m_downsampler) {
+        // Expand the row to RGBA and let the downsampler average it into the smaller buffer.
+        m_downsampledRow.resize((xEnd - xBegin) * 4);
+        auto* pixel = m_downsampledRow.data();
+        for (int x = xBegin; x < xEnd; ++x, pixel += 4) {
+            const unsigned char sourceValue = rowBuffer[x - frameContext->xOffset];
+            if ((!frameContext->isTransparent || (sourceValue != frameContext->tpixel)) && (sourceValue < colorMapSize)) {
+                const size_t colorIndex = static_cast<size_t>(sourceValue) * 3;
+                pixel[0] = colorMap[colorIndex];
+                pixel[1] = colorMap[colorIndex + 1];
+                pixel[2] = colorMap[colorIndex + 2];
+                pixel[3] = 255;
+            } else {
+                m_currentBufferSawAlpha = true;
+                pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+            }
+        }
+        for (int y = yBegin; y < yEnd; ++y)
+            m_downsampler->addRow(*buffer.backingStore(), y, m_downsampledRow.data(), true);
+        return true;
+    }
+
     auto* currentAddress = buffer.backingStore()->pixelAt(xBegin, yBegin);
     // Write one row's worth of data into the frame.  
     for (int x = xBegin; x < xEnd; ++x) {
@@ -280,7 +303,7 @@ bool GIFImageDecoder::frameComplete(unsigned frameIndex, unsigned frameDuration,
         
         // The whole frame was non-transparent, so it's possible that the entire
         // resulting buffer was non-transparent, and we can setHasAlpha(false).
-        if (rect.contains(IntRect(IntPoint(), size())))
+        if (rect.contains(IntRect(IntPoint(), decodedSize())))
             buffer.setHasAlpha(false);
         else if (frameIndex) {
             // Tricky case.  This frame does not have alpha only if everywhere
@@ -319,6 +342,24 @@ void GIFImageDecoder::gifComplete()
     repetitionCount();
 
     m_reader = nullptr;
+    m_downsampler = nullptr;
+}
+
+unsigned GIFImageDecoder::supportedDownscaleFactor(unsigned maximumFactor) const
+{
+    // Animation frames are composited over each other at full size, and the rows of interlaced
+    // frames arrive out of order, so only complete, single-frame, non-interlaced images are scaled.
+    if (!isAllDataReceived() || frameCount() != 1 || !m_reader)
+        return 1;
+
+    const auto* frameContext = m_reader->frameContext(0);
+    return frameContext && !frameContext->interlaced ? maximumFactor : 1;
+}
+
+void GIFImageDecoder::resetDecoding()
+{
+    m_reader = nullptr;
+    m_downsampler = nullptr;
 }
 
 void GIFImageDecoder::decode(unsigned haltAtFrame, GIFQuery query, bool allDataReceived)
@@ -367,7 +408,7 @@ bool GIFImageDecoder::initFrameBuffer(unsigned frameIndex)
 
     if (!frameIndex) {
         // This is the first frame, so we're not relying on any previous data.
-        if (!buffer->initialize(size(), m_premultiplyAlpha))
+        if (!buffer->initialize(decodedSize(), m_premultiplyAlpha))
             return setFailed();
     } else {
         // The starting state for this frame depends on the previous frame's
@@ -417,6 +458,12 @@ bool GIFImageDecoder::initFrameBuffer(unsigned frameIndex)
     if (frameRect.maxY() > size().height())
         frameRect.setHeight(size().height() - frameContext->yOffset);
 
+    if (downscaleFactor() > 1) {
+        ASSERT(!frameIndex);
+        m_downsampler = makeUnique<ImageRowDownsampler>(downscaleFactor(), frameRect);
+        frameRect = m_downsampler->destinationRect();
+    }
+
     buffer->backingStore()->setFrameRect(frameRect);
 
     // Update our status to be partially complete.
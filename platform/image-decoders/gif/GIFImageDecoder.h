@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "ImageRowDownsampler.h"
 #include "ScalableImageDecoder.h"
 #include <wtf/Lock.h>
 
@@ -65,6 +66,8 @@ public:
 private:
     GIFImageDecoder(AlphaOption, GammaAndColorProfileOption);
     void tryDecodeSize(bool allDataReceived) final { decode(0, GIFSizeQuery, allDataReceived); }
+    unsigned supportedDownscaleFactor(unsigned maximumFactor) const final;
+    void resetDecoding() final;
     size_t findFirstRequiredFrameToDecode(size_t);
 
     // If the query is GIFFullQuery, decodes the image up to (but not
@@ -81,6 +84,8 @@ private:
     bool m_currentBufferSawAlpha;
     mutable RepetitionCount m_repetitionCount { RepetitionCountOnce };
     std::unique_ptr<GIFImageReader> m_reader;
+    std::unique_ptr<ImageRowDownsampler> m_downsampler;
+    Vector<uint8_t> m_downsampledRow;
 };
 
 } // namespace WebCore
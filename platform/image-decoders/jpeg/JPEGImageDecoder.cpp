@@ -294,9 +294,17 @@ public:
 
             switch (m_info.jpeg_color_space) {
             case JCS_GRAYSCALE:
+#if defined(TURBO_JPEG_RGB_SWIZZLE)
+                m_info.out_color_space = rgbOutputColorSpace();
+#else
+                // Gray samples are expanded while they are written to the frame
+                // buffer, which is cheaper than having libjpeg convert them to RGB.
+                m_info.out_color_space = JCS_GRAYSCALE;
+#endif
+                break;
             case JCS_RGB:
             case JCS_YCbCr:
-                // libjpeg can convert GRAYSCALE and YCbCr image pixels to RGB.
+                // libjpeg can convert YCbCr image pixels to RGB.
                 m_info.out_color_space = rgbOutputColorSpace();
                 break;
             case JCS_CMYK:
@@ -320,9 +328,16 @@ public:
             // Don't allocate a giant and superfluous memory buffer when the
             // image is a sequential JPEG.
             m_info.buffered_image = jpeg_has_multiple_scans(&m_info);
+            m_decoder->setIsProgressive(m_info.buffered_image);
+
+            // Let the IDCT produce the smaller image directly when one was requested.
+            m_info.scale_num = 1;
+            m_info.scale_denom = m_decoder->downscaleFactor();
 
             // Used to set up image size so arrays can be allocated.
             jpeg_calc_output_dimensions(&m_info);
+            if (IntSize(m_info.output_width, m_info.output_height) != m_decoder->downscaledSize())
+                return m_decoder->setFailed();
 
             // Make a one-row-high sample array that will go away when done with
             // image. Always make it big enough to hold an RGB row. Since this
@@ -364,6 +379,14 @@ public:
                 if (!m_decoder->outputScanlines())
                     return false; // I/O suspension.
 
+                // A region ends above the bottom of the image, and the rows below it are
+                // never decoded.
+                if (m_info.output_scanline < m_info.output_height) {
+                    jpeg_abort_decompress(&m_info);
+                    m_decoder->jpegComplete();
+                    return true;
+                }
+
                 // If we've completed image output...
                 ASSERT(m_info.output_scanline == m_info.output_height);
                 m_state = JPEG_DONE;
@@ -512,15 +535,35 @@ bool JPEGImageDecoder::setFailed()
     return ScalableImageDecoder::setFailed();
 }
 
+unsigned JPEGImageDecoder::supportedDownscaleFactor(unsigned maximumFactor) const
+{
+    // libjpeg can scale by 1/1, 1/2, 1/4 and 1/8 while decoding.
+    for (unsigned factor = 8; factor > 1; factor /= 2) {
+        if (factor <= maximumFactor)
+            return factor;
+    }
+    return 1;
+}
+
+bool JPEGImageDecoder::supportsRegionDecoding() const
+{
+    // A progressive JPEG is decoded a scan at a time over the whole image.
+    return !m_isProgressive;
+}
+
+void JPEGImageDecoder::resetDecoding()
+{
+    m_reader = nullptr;
+    m_didStartRegion = false;
+    m_regionColumnOffset = 0;
+}
+
 template <J_COLOR_SPACE colorSpace>
 void setPixel(ScalableImageDecoderFrame& buffer, uint32_t* currentAddress, JSAMPARRAY samples, int column)
 {
-    JSAMPLE* jsample = *samples + column * (colorSpace == JCS_RGB ? 3 : 4);
+    JSAMPLE* jsample = *samples + column * 4;
 
     switch (colorSpace) {
-    case JCS_RGB:
-        buffer.backingStore()->setPixel(currentAddress, jsample[0], jsample[1], jsample[2], 0xFF);
-        break;
     case JCS_CMYK:
         // Source is 'Inverted CMYK', output is RGB.
         // See: http://www.easyrgb.com/math.php?MATH=M12#text12
@@ -542,9 +585,10 @@ bool JPEGImageDecoder::outputScanlines(ScalableImageDecoderFrame& buffer)
 {
     JSAMPARRAY samples = m_reader->samples();
     jpeg_decompress_struct* info = m_reader->info();
-    int width = info->output_width;
+    IntRect rect = downscaledDecodedRect();
+    int width = rect.width();
 
-    while (info->output_scanline < info->output_height) {
+    while (info->output_scanline < static_cast<JDIMENSION>(rect.maxY())) {
         // jpeg_read_scanlines will increase the scanline counter, so we
         // save the scanline before calling it.
         int sourceY = info->output_scanline;
@@ -552,10 +596,22 @@ bool JPEGImageDecoder::outputScanlines(ScalableImageDecoderFrame& buffer)
         if (jpeg_read_scanlines(info, samples, 1) != 1)
             return false;
 
-        auto* currentAddress = buffer.backingStore()->pixelAt(0, sourceY);
-        for (int x = 0; x < width; ++x) {
-            setPixel<colorSpace>(buffer, currentAddress, samples, x);
-            ++currentAddress;
+        if (sourceY < rect.y())
+            continue;
+
+        auto* currentAddress = buffer.backingStore()->pixelAt(0, sourceY - rect.y());
+        switch (colorSpace) {
+        case JCS_RGB:
+            buffer.backingStore()->setRGBRow(currentAddress, *samples + m_regionColumnOffset * 3, width);
+            break;
+        case JCS_GRAYSCALE:
+            buffer.backingStore()->setGrayRow(currentAddress, *samples + m_regionColumnOffset, width);
+            break;
+        default:
+            for (int x = 0; x < width; ++x) {
+                setPixel<colorSpace>(buffer, currentAddress, samples, m_regionColumnOffset + x);
+                ++currentAddress;
+            }
         }
     }
     return true;
@@ -569,7 +625,7 @@ bool JPEGImageDecoder::outputScanlines()
     // Initialize the framebuffer if needed.
     auto& buffer = m_frameBufferCache[0];
     if (buffer.isInvalid()) {
-        if (!buffer.initialize(size(), m_premultiplyAlpha))
+        if (!buffer.initialize(decodedSize(), m_premultiplyAlpha))
             return setFailed();
         buffer.setDecodingStatus(DecodingStatus::Partial);
         // The buffer is transparent outside the decoded area while the image is
@@ -579,12 +635,36 @@ bool JPEGImageDecoder::outputScanlines()
 
     jpeg_decompress_struct* info = m_reader->info();
 
+    if (isDecodingRegion() && !m_didStartRegion) {
+        m_didStartRegion = true;
+        IntRect rect = downscaledDecodedRect();
+        m_regionColumnOffset = rect.x();
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER)
+        // Only the iMCU columns that cover the region are decoded. libjpeg-turbo widens the
+        // crop to iMCU boundaries, so the region starts m_regionColumnOffset samples in.
+        JDIMENSION cropX = rect.x();
+        JDIMENSION cropWidth = rect.width();
+        jpeg_crop_scanline(info, &cropX, &cropWidth);
+        m_regionColumnOffset = rect.x() - cropX;
+
+        // The rows above the region are skipped mostly without decoding them, which needs the
+        // data for all of them at once. Otherwise they are decoded and dropped.
+        if (isAllDataReceived() && info->output_scanline < static_cast<JDIMENSION>(rect.y()))
+            jpeg_skip_scanlines(info, rect.y() - info->output_scanline);
+#endif
+    }
+
 #if defined(TURBO_JPEG_RGB_SWIZZLE)
     if (turboSwizzled(info->out_color_space)) {
-        while (info->output_scanline < info->output_height) {
-            unsigned char* row = reinterpret_cast<unsigned char*>(buffer.backingStore()->pixelAt(0, info->output_scanline));
+        IntRect rect = downscaledDecodedRect();
+        while (info->output_scanline < static_cast<JDIMENSION>(rect.maxY())) {
+            int sourceY = info->output_scanline;
+            // A region row is decoded next to the backing store and copied over.
+            unsigned char* row = isDecodingRegion() ? *m_reader->samples() : reinterpret_cast<unsigned char*>(buffer.backingStore()->pixelAt(0, sourceY));
             if (jpeg_read_scanlines(info, &row, 1) != 1)
                 return false;
+            if (isDecodingRegion() && sourceY >= rect.y())
+                memcpy(buffer.backingStore()->pixelAt(0, sourceY - rect.y()), row + m_regionColumnOffset * 4, rect.width() * 4);
          }
          return true;
      }
@@ -597,6 +677,8 @@ bool JPEGImageDecoder::outputScanlines()
     // the proper code will be generated at compile time.
     case JCS_RGB:
         return outputScanlines<JCS_RGB>(buffer);
+    case JCS_GRAYSCALE:
+        return outputScanlines<JCS_GRAYSCALE>(buffer);
     case JCS_CMYK:
         return outputScanlines<JCS_CMYK>(buffer);
     default:
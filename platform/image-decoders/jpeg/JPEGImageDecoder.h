@@ -62,10 +62,18 @@ namespace WebCore {
         void jpegComplete();
 
         void setOrientation(ImageOrientation orientation) { m_orientation = orientation; }
+        void setIsProgressive(bool isProgressive) { m_isProgressive = isProgressive; }
+
+        bool supportsRegionDecoding() const override;
+
+        using ScalableImageDecoder::downscaleFactor;
+        using ScalableImageDecoder::downscaledSize;
 
     private:
         JPEGImageDecoder(AlphaOption, GammaAndColorProfileOption);
         void tryDecodeSize(bool allDataReceived) override { decode(true, allDataReceived); }
+        unsigned supportedDownscaleFactor(unsigned maximumFactor) const override;
+        void resetDecoding() override;
 
         // Decodes the image.  If |onlySize| is true, stops decoding after
         // calculating the image size.  If decoding fails but there is no more
@@ -79,6 +87,9 @@ namespace WebCore {
         bool outputScanlines(ScalableImageDecoderFrame& buffer);
 
         std::unique_ptr<JPEGImageReader> m_reader;
+        bool m_isProgressive { false };
+        bool m_didStartRegion { false };
+        unsigned m_regionColumnOffset { 0 };
     };
 
 } // namespace WebCore
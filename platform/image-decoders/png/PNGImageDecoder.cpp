@@ -267,6 +267,7 @@ bool PNGImageDecoder::setFailed()
     if (m_doNothingOnFailure)
         return false;
     m_reader = nullptr;
+    m_downsampler = nullptr;
     return ScalableImageDecoder::setFailed();
 }
 
@@ -298,6 +299,7 @@ void PNGImageDecoder::headerAvailable()
 
     int bitDepth, colorType, interlaceType, compressionType, filterType, channels;
     png_get_IHDR(png, info, &width, &height, &bitDepth, &colorType, &interlaceType, &compressionType, &filterType);
+    m_isInterlaced = interlaceType == PNG_INTERLACE_ADAM7;
 
     // The options we set here match what Mozilla does.
 
@@ -418,11 +420,14 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
     auto& buffer = m_frameBufferCache[m_currentFrame];
     if (buffer.isInvalid()) {
         png_structp png = m_reader->pngPtr();
-        if (!buffer.initialize(size(), m_premultiplyAlpha)) {
+        if (!buffer.initialize(decodedSize(), m_premultiplyAlpha)) {
             longjmp(JMPBUF(png), 1);
             return;
         }
 
+        if (downscaleFactor() > 1)
+            m_downsampler = makeUnique<ImageRowDownsampler>(downscaleFactor(), decodedRect(), downscaledDecodedRect().location());
+
         unsigned colorChannels = m_reader->hasAlpha() ? 4 : 3;
         if (PNG_INTERLACE_ADAM7 == png_get_interlace_type(png, m_reader->infoPtr())
             || m_currentFrame) {
@@ -497,25 +502,38 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
         png_progressive_combine_row(m_reader->pngPtr(), row, rowBuffer);
     }
 
-    // Write the decoded row pixels to the frame buffer.
-    auto* address = buffer.backingStore()->pixelAt(0, rowIndex);
-    int width = size().width();
-    unsigned char nonTrivialAlphaMask = 0;
-
-    png_bytep pixel = row;
-    if (hasAlpha) {
-        for (int x = 0; x < width; ++x, pixel += 4, ++address) {
-            unsigned alpha = pixel[3];
-            buffer.backingStore()->setPixel(address, pixel[0], pixel[1], pixel[2], alpha);
-            nonTrivialAlphaMask |= (255 - alpha);
-        }
-    } else {
-        for (int x = 0; x < width; ++x, pixel += 3, ++address)
-            *address = 0xFF000000 | pixel[0] << 16 | pixel[1] << 8 | pixel[2];
+    // Write the decoded row pixels to the frame buffer, or only the part of them in the region
+    // being decoded.
+    IntRect rect = decodedRect();
+    int y = rowIndex;
+    if (y < rect.y() || y >= rect.maxY())
+        return;
+
+    row += rect.x() * colorChannels;
+    int width = rect.width();
+    if (m_downsampler)
+        m_downsampler->addRow(*buffer.backingStore(), y, row, hasAlpha);
+    else if (hasAlpha)
+        buffer.backingStore()->setRGBARow(buffer.backingStore()->pixelAt(0, y - rect.y()), row, width);
+    else
+        buffer.backingStore()->setRGBRow(buffer.backingStore()->pixelAt(0, y - rect.y()), row, width);
+
+    if (hasAlpha && !buffer.hasAlpha()) {
+        unsigned char nonTrivialAlphaMask = 0;
+        for (int x = 0; x < width; ++x)
+            nonTrivialAlphaMask |= 255 - row[x * 4 + 3];
+        if (nonTrivialAlphaMask)
+            buffer.setHasAlpha(true);
     }
 
-    if (nonTrivialAlphaMask && !buffer.hasAlpha())
-        buffer.setHasAlpha(true);
+    if (!isDecodingRegion() || y != rect.maxY() - 1)
+        return;
+
+    // The rows below the region don't need to be inflated.
+    buffer.setDecodingStatus(DecodingStatus::Complete);
+#if defined(PNG_LIBPNG_VER_MAJOR) && defined(PNG_LIBPNG_VER_MINOR) && (PNG_LIBPNG_VER_MAJOR > 1 || (PNG_LIBPNG_VER_MAJOR == 1 && PNG_LIBPNG_VER_MINOR >= 5))
+    png_process_data_pause(m_reader->pngPtr(), 0);
+#endif
 }
 
 void PNGImageDecoder::pngComplete()
@@ -546,8 +564,36 @@ void PNGImageDecoder::decode(bool onlySize, unsigned haltAtFrame, bool allDataRe
         setFailed();
     // If we're done decoding the image, we don't need the PNGImageReader
     // anymore.  (If we failed, |m_reader| has already been cleared.)
-    else if (isComplete())
+    else if (isComplete()) {
         m_reader = nullptr;
+        m_downsampler = nullptr;
+    }
+}
+
+unsigned PNGImageDecoder::supportedDownscaleFactor(unsigned maximumFactor) const
+{
+    // Rows of interlaced images and of animation frames are not decoded in order, from top to bottom.
+#if ENABLE(APNG)
+    if (m_isAnimated)
+        return 1;
+#endif
+    return m_isInterlaced ? 1 : maximumFactor;
+}
+
+bool PNGImageDecoder::supportsRegionDecoding() const
+{
+    // Region decoding skips the rows outside the region, so it needs them in order too.
+#if ENABLE(APNG)
+    if (m_isAnimated)
+        return false;
+#endif
+    return !m_isInterlaced;
+}
+
+void PNGImageDecoder::resetDecoding()
+{
+    m_reader = nullptr;
+    m_downsampler = nullptr;
 }
 
 #if ENABLE(APNG)
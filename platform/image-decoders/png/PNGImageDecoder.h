@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "ImageRowDownsampler.h"
 #include "ScalableImageDecoder.h"
 #if ENABLE(APNG)
 #include <png.h>
@@ -50,6 +51,7 @@ namespace WebCore {
         size_t frameCount() const override { return m_frameCount; }
         RepetitionCount repetitionCount() const override;
 #endif
+        bool supportsRegionDecoding() const override;
         ScalableImageDecoderFrame* frameBufferAtIndex(size_t index) override;
         // CAUTION: setFailed() deletes |m_reader|.  Be careful to avoid
         // accessing deleted memory, especially when calling this from inside
@@ -89,6 +91,8 @@ namespace WebCore {
     private:
         PNGImageDecoder(AlphaOption, GammaAndColorProfileOption);
         void tryDecodeSize(bool allDataReceived) override { decode(true, 0, allDataReceived); }
+        unsigned supportedDownscaleFactor(unsigned maximumFactor) const override;
+        void resetDecoding() override;
 
         // Decodes the image.  If |onlySize| is true, stops decoding after
         // calculating the image size.  If decoding fails but there is no more
@@ -103,7 +107,9 @@ namespace WebCore {
 #endif
 
         std::unique_ptr<PNGImageReader> m_reader;
+        std::unique_ptr<ImageRowDownsampler> m_downsampler;
         bool m_doNothingOnFailure;
+        bool m_isInterlaced { false };
         unsigned m_currentFrame;
 #if ENABLE(APNG)
         png_structp m_png;
@@ -167,7 +167,8 @@ void WEBPImageDecoder::decodeFrame(size_t frameIndex, WebPDemuxer* demuxer)
 
     const uint8_t* dataBytes = reinterpret_cast<const uint8_t*>(webpFrame.fragment.bytes);
     size_t dataSize = webpFrame.fragment.size;
-    bool blend = webpFrame.blend_method == WEBP_MUX_BLEND ? true : false;
+    // The first frame starts out transparent, so blending it is the same as copying it.
+    bool blend = webpFrame.blend_method == WEBP_MUX_BLEND && frameIndex;
 
     ASSERT(m_frameBufferCache.size() > frameIndex);
     auto& buffer = m_frameBufferCache[frameIndex];
@@ -233,7 +234,7 @@ bool WEBPImageDecoder::initFrameBuffer(size_t frameIndex, const WebPIterator* we
 
     if (!frameIndex || !m_frameBufferCache[frameIndex - 1].backingStore()) {
         // This frame doesn't rely on any previous data.
-        if (!buffer.initialize(size(), m_premultiplyAlpha))
+        if (!buffer.initialize(decodedSize(), m_premultiplyAlpha))
             return false;
     } else {
         const auto& prevBuffer = m_frameBufferCache[frameIndex - 1];
@@ -251,6 +252,12 @@ bool WEBPImageDecoder::initFrameBuffer(size_t frameIndex, const WebPIterator* we
         }
     }
 
+    if (downscaleFactor() > 1) {
+        ASSERT(!frameIndex);
+        m_downsampler = makeUnique<ImageRowDownsampler>(downscaleFactor(), frameRect);
+        frameRect = m_downsampler->destinationRect();
+    }
+
     buffer.setHasAlpha(webpFrame->has_alpha);
     buffer.backingStore()->setFrameRect(frameRect);
 
@@ -267,6 +274,16 @@ void WEBPImageDecoder::applyPostProcessing(size_t frameIndex, WebPIDecoder* deco
     if (decodedHeight <= 0)
         return;
 
+    if (m_downsampler) {
+        // Decoding always starts over from the first row, which resets the downsampler.
+        const IntRect& sourceRect = m_downsampler->sourceRect();
+        ASSERT_WITH_SECURITY_IMPLICATION(decodedWidth == sourceRect.width());
+        ASSERT_WITH_SECURITY_IMPLICATION(decodedHeight <= sourceRect.height());
+        for (int y = 0; y < decodedHeight; y++)
+            m_downsampler->addRow(*buffer.backingStore(), sourceRect.y() + y, decoderBuffer.u.RGBA.rgba + y * decoderBuffer.u.RGBA.stride, true);
+        return;
+    }
+
     const IntRect& frameRect = buffer.backingStore()->frameRect();
     ASSERT_WITH_SECURITY_IMPLICATION(decodedWidth == frameRect.width());
     ASSERT_WITH_SECURITY_IMPLICATION(decodedHeight <= frameRect.height());
@@ -275,11 +292,15 @@ void WEBPImageDecoder::applyPostProcessing(size_t frameIndex, WebPIDecoder* deco
 
     for (int y = 0; y < decodedHeight; y++) {
         const int canvasY = top + y;
+        if (!blend) {
+            buffer.backingStore()->setRGBARow(buffer.backingStore()->pixelAt(left, canvasY), decoderBuffer.u.RGBA.rgba + y * frameRect.width() * sizeof(uint32_t), decodedWidth);
+            continue;
+        }
         for (int x = 0; x < decodedWidth; x++) {
             const int canvasX = left + x;
             auto* address = buffer.backingStore()->pixelAt(canvasX, canvasY);
             uint8_t* pixel = decoderBuffer.u.RGBA.rgba + (y * frameRect.width() + x) * sizeof(uint32_t);
-            if (blend && (pixel[3] < 255))
+            if (pixel[3] < 255)
                 buffer.backingStore()->blendPixel(address, pixel[0], pixel[1], pixel[2], pixel[3]);
             else
                 buffer.backingStore()->setPixel(address, pixel[0], pixel[1], pixel[2], pixel[3]);
@@ -287,6 +308,17 @@ void WEBPImageDecoder::applyPostProcessing(size_t frameIndex, WebPIDecoder* deco
     }
 }
 
+unsigned WEBPImageDecoder::supportedDownscaleFactor(unsigned maximumFactor) const
+{
+    // Animation frames are blended over each other at full size.
+    return m_formatFlags & ANIMATION_FLAG ? 1 : maximumFactor;
+}
+
+void WEBPImageDecoder::resetDecoding()
+{
+    m_downsampler = nullptr;
+}
+
 void WEBPImageDecoder::parseHeader()
 {
     if (m_headerParsed)
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "ImageRowDownsampler.h"
 #include "ScalableImageDecoder.h"
 
 #if USE(WEBP)
@@ -56,6 +57,8 @@ public:
 private:
     WEBPImageDecoder(AlphaOption, GammaAndColorProfileOption);
     void tryDecodeSize(bool) override { parseHeader(); }
+    unsigned supportedDownscaleFactor(unsigned maximumFactor) const override;
+    void resetDecoding() override;
     void decode(size_t, bool);
     void decodeFrame(size_t, WebPDemuxer*);
     void parseHeader();
@@ -67,6 +70,7 @@ private:
     size_t m_frameCount { 0 };
     int m_formatFlags { 0 };
     bool m_headerParsed { false };
+    std::unique_ptr<ImageRowDownsampler> m_downsampler;
 };
 
 } // namespace WebCore
@@ -33,6 +33,7 @@
 #include "FEColorMatrix.h"
 #include "FEComponentTransfer.h"
 #include "FEDropShadow.h"
+#include "FEFusedColorTransform.h"
 #include "FEGaussianBlur.h"
 #include "FEMerge.h"
 #include "FilterEffectRenderer.h"
@@ -138,7 +139,15 @@ bool CSSFilter::build(RenderElement& renderer, const FilterOperations& operation
     m_effects.clear();
     m_outsets = { };
 
+#if USE(CORE_IMAGE)
+    // Core Image renders the effects themselves, not the fused effect.
+    bool shouldFuseEffects = !renderer.settings().coreImageAcceleratedFilterRenderEnabled();
+#else
+    bool shouldFuseEffects = true;
+#endif
+
     RefPtr<FilterEffect> previousEffect = m_sourceGraphic.ptr();
+    bool previousEffectCanFuse = false;
     for (auto& operation : operations.operations()) {
         RefPtr<FilterEffect> effect;
         auto& filterOperation = *operation;
@@ -291,9 +300,25 @@ bool CSSFilter::build(RenderElement& renderer, const FilterOperations& operation
             effect->setOperatingColorSpace(ColorSpace::SRGB);
             
             if (filterOperation.type() != FilterOperation::REFERENCE) {
+                if (shouldFuseEffects && previousEffectCanFuse && FEFusedColorTransform::canFuse(*effect)) {
+                    // Consecutive color matrix and component transfer functions run as one effect,
+                    // which makes one pass over the pixels instead of a pass and a buffer each.
+                    if (!is<FEFusedColorTransform>(*previousEffect)) {
+                        auto fusedEffect = FEFusedColorTransform::create(*this);
+                        fusedEffect->setClipsToBounds(previousEffect->clipsToBounds());
+                        fusedEffect->setOperatingColorSpace(ColorSpace::SRGB);
+                        fusedEffect->inputEffects().append(previousEffect->inputEffect(0));
+                        fusedEffect->appendEffect(*previousEffect);
+                        m_effects.last() = fusedEffect.copyRef();
+                        previousEffect = WTFMove(fusedEffect);
+                    }
+                    downcast<FEFusedColorTransform>(*previousEffect).appendEffect(*effect);
+                    continue;
+                }
                 effect->inputEffects().append(WTFMove(previousEffect));
                 m_effects.append(*effect);
             }
+            previousEffectCanFuse = filterOperation.type() != FilterOperation::REFERENCE && FEFusedColorTransform::canFuse(*effect);
             previousEffect = WTFMove(effect);
         }
     }
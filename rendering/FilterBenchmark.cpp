@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RenderLayerFilters.h"
+
+#include "CSSFilter.h"
+#include "GraphicsContext.h"
+#include "RenderDescendantIterator.h"
+#include "RenderView.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/text/TextStream.h>
+
+namespace WebCore {
+
+String RenderLayerFilters::runFilterBenchmark(RenderView& renderView, unsigned iterations)
+{
+    iterations = std::max(iterations, 1u);
+    float scaleFactor = renderView.document().deviceScaleFactor();
+    GraphicsContext targetContext(GraphicsContext::PaintInvalidationReasons::None);
+
+    TextStream stream;
+    stream << "Filter benchmark: " << iterations << " iterations at scale " << scaleFactor << "\n";
+
+    Seconds totalTime;
+    uint64_t totalPixelCount = 0;
+    unsigned filterIndex = 0;
+    for (auto& renderer : descendantsOfType<RenderBox>(renderView)) {
+        if (!renderer.hasLayer() || !renderer.style().hasFilter())
+            continue;
+
+        // Every filter is built into a CSSFilter of its own, the way buildFilter() does, so that the filter of the layer and its
+        // cached result are left alone. SVG filter chains are measured through the CSS reference filters that use them.
+        auto filter = CSSFilter::create();
+        filter->setFilterScale(scaleFactor);
+        if (!filter->build(renderer, renderer.style().filter(), FilterConsumer::FilterProperty))
+            continue;
+
+        // The whole filter box is the source, as when the layer is painted at once.
+        if (!filter->updateBackingStoreRect(renderer.borderBoxRect()))
+            continue;
+        filter->determineFilterPrimitiveSubregion();
+        filter->allocateBackingStoreIfNeeded(targetContext);
+        auto* sourceContext = filter->inputContext();
+        if (!sourceContext || filter->filterRegion().isEmpty() || ImageBuffer::sizeNeedsClamping(filter->filterRegion().size()))
+            continue;
+
+        // Give the filters opaque and translucent pixels to work on.
+        FloatRect sourceRect { { }, filter->sourceImageRect().size() };
+        FloatRect translucentRect = sourceRect;
+        translucentRect.setWidth(sourceRect.width() / 2);
+        sourceContext->fillRect(sourceRect, SRGBA<uint8_t> { 64, 128, 192 });
+        sourceContext->clearRect(translucentRect);
+        sourceContext->fillRect(translucentRect, SRGBA<uint8_t> { 192, 64, 32, 128 });
+
+        Seconds filterTime;
+        for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+            auto startTime = MonotonicTime::now();
+            filter->apply();
+            filterTime += MonotonicTime::now() - startTime;
+            filter->clearIntermediateResults();
+        }
+
+        FloatSize scaledSize = filter->filterRegion().size().scaled(scaleFactor);
+        uint64_t pixelCount = static_cast<uint64_t>(scaledSize.width()) * static_cast<uint64_t>(scaledSize.height());
+        auto timePerIteration = filterTime / iterations;
+        stream << "filter " << filterIndex++ << " on " << renderer.renderName() << ": " << renderer.style().filter() << ", " << filter->m_effects.size() << " effects, "
+            << scaledSize.width() << "x" << scaledSize.height() << " pixels, " << timePerIteration.milliseconds() << "ms/iteration";
+        if (pixelCount)
+            stream << ", " << timePerIteration.nanoseconds() / pixelCount << "ns/pixel";
+        stream << "\n";
+
+        totalTime += timePerIteration;
+        totalPixelCount += pixelCount;
+    }
+
+    stream << "all filters: " << totalPixelCount << " pixels, " << totalTime.milliseconds() << "ms/iteration";
+    if (totalPixelCount)
+        stream << ", " << totalTime.nanoseconds() / totalPixelCount << "ns/pixel";
+    stream << "\n";
+    return stream.release();
+}
+
+} // namespace WebCore
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RenderFlexibleBox.h"
+
+#include "RenderDescendantIterator.h"
+#include "RenderView.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/text/TextStream.h>
+
+namespace WebCore {
+
+String RenderFlexibleBox::runNestedFlexBenchmark(RenderView& renderView, unsigned iterations)
+{
+    iterations = std::max(iterations, 1u);
+    auto& document = renderView.document();
+
+    // Only the outermost flexboxes are resized; the nested ones are relaid out by them.
+    Vector<std::pair<WeakPtr<RenderFlexibleBox>, LayoutUnit>> outermostFlexBoxes;
+    unsigned flexBoxCount = 0;
+    unsigned maximumDepth = 0;
+    for (auto& flexBox : descendantsOfType<RenderFlexibleBox>(renderView)) {
+        ++flexBoxCount;
+        unsigned depth = 1;
+        for (auto* ancestor = flexBox.parent(); ancestor; ancestor = ancestor->parent()) {
+            if (is<RenderFlexibleBox>(*ancestor))
+                ++depth;
+        }
+        maximumDepth = std::max(maximumDepth, depth);
+        // A box whose width is already overridden is laid out by a flex or grid container.
+        if (depth == 1 && !flexBox.hasOverridingLogicalWidth())
+            outermostFlexBoxes.append({ makeWeakPtr(flexBox), flexBox.logicalWidth() });
+    }
+
+    TextStream stream;
+    stream << "Nested flex benchmark: " << iterations << " iterations, " << flexBoxCount << " flexboxes nested " << maximumDepth << " deep, " << outermostFlexBoxes.size() << " outermost\n";
+    if (outermostFlexBoxes.isEmpty())
+        return stream.release();
+
+    auto relayout = [&](const char* description) {
+        resetItemMeasureCounters();
+        Seconds layoutTime;
+        for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+            // Alternating by a pixel forces every level to relayout all of its children, as a resize does.
+            for (auto& [flexBox, logicalWidth] : outermostFlexBoxes) {
+                if (!flexBox)
+                    continue;
+                flexBox->setOverridingLogicalWidth(logicalWidth - LayoutUnit(iteration % 2));
+                flexBox->setNeedsLayout();
+            }
+            auto startTime = MonotonicTime::now();
+            document.updateLayoutIgnorePendingStylesheets();
+            layoutTime += MonotonicTime::now() - startTime;
+        }
+        stream << description << ": " << (layoutTime / iterations).milliseconds() << "ms/iteration, "
+            << static_cast<double>(itemMeasureLayoutCount()) / iterations << " measuring layouts/iteration, "
+            << static_cast<double>(itemMeasureCacheHitCount()) / iterations << " reused measurements/iteration\n";
+    };
+
+    setReusesCachedMainSizes(false);
+    relayout("measuring every item");
+    setReusesCachedMainSizes(true);
+    relayout("reusing clean items' measurements");
+
+    for (auto& [flexBox, logicalWidth] : outermostFlexBoxes) {
+        if (!flexBox)
+            continue;
+        flexBox->clearOverridingLogicalWidth();
+        flexBox->setNeedsLayout();
+    }
+    document.updateLayoutIgnorePendingStylesheets();
+    resetItemMeasureCounters();
+    return stream.release();
+}
+
+} // namespace WebCore
@@ -133,6 +133,9 @@ static void setOverridingContainingBlockContentSizeForChild(RenderBox& child, Gr
         child.setOverridingContainingBlockContentLogicalHeight(size);
 }
 
+static unsigned itemLayoutsDuringTrackSizing;
+static unsigned intrinsicLogicalHeightCacheHits;
+
 // GridTrackSizingAlgorithm private.
 
 void GridTrackSizingAlgorithm::setFreeSpace(GridTrackSizingDirection direction, Optional<LayoutUnit> freeSpace)
@@ -754,19 +757,44 @@ void GridTrackSizingAlgorithm::computeGridContainerIntrinsicSizes()
 LayoutUnit GridTrackSizingAlgorithmStrategy::logicalHeightForChild(RenderBox& child) const
 {
     GridTrackSizingDirection childBlockDirection = GridLayoutFunctions::flowAwareDirectionForChild(*renderGrid(), child, ForRows);
+    LayoutUnit marginLogicalSize = GridLayoutFunctions::marginLogicalSizeForChild(*renderGrid(), childBlockDirection, child);
+    bool shouldClearBlockSizeOverride = shouldClearOverridingContainingBlockContentSizeForChild(child, ForRows);
+
+    // The measured height only depends on the child's content and on the sizes it's laid out against. If none of
+    // them changed since the last measurement we can skip the layout below, which is the expensive part of sizing
+    // rows, and leave the child alone; the final grid item layout will lay it out again only if really needed.
+    bool canUseCache = m_algorithm.canCacheIntrinsicLogicalHeightForChild(child) && child.hasOverridingContainingBlockContentLogicalWidth()
+        && (shouldClearBlockSizeOverride || child.hasOverridingContainingBlockContentLogicalHeight());
+    GridTrackSizingAlgorithm::IntrinsicLogicalHeightCacheKey cacheKey;
+    if (canUseCache) {
+        cacheKey.containingBlockContentLogicalWidth = child.overridingContainingBlockContentLogicalWidth();
+        if (!shouldClearBlockSizeOverride)
+            cacheKey.containingBlockContentLogicalHeight = child.overridingContainingBlockContentLogicalHeight();
+        if (child.hasOverridingLogicalWidth())
+            cacheKey.overridingLogicalWidth = child.overridingLogicalWidth();
+        if (auto logicalHeight = m_algorithm.cachedIntrinsicLogicalHeightForChild(child, cacheKey)) {
+            ++intrinsicLogicalHeightCacheHits;
+            return logicalHeight.value() + marginLogicalSize + m_algorithm.baselineOffsetForChild(child, gridAxisForDirection(direction()));
+        }
+    }
+
     // If |child| has a relative logical height, we shouldn't let it override its intrinsic height, which is
     // what we are interested in here. Thus we need to set the block-axis override size to -1 (no possible resolution).
-    if (shouldClearOverridingContainingBlockContentSizeForChild(child, ForRows)) {
+    if (shouldClearBlockSizeOverride) {
         setOverridingContainingBlockContentSizeForChild(child, childBlockDirection, WTF::nullopt);
         child.setNeedsLayout(MarkOnlyThis);
     }
 
     // We need to clear the stretched height to properly compute logical height during layout.
-    if (child.needsLayout())
+    if (child.needsLayout()) {
         child.clearOverridingLogicalHeight();
+        ++itemLayoutsDuringTrackSizing;
+    }
 
     child.layoutIfNeeded();
-    return child.logicalHeight() + GridLayoutFunctions::marginLogicalSizeForChild(*renderGrid(), childBlockDirection, child) + m_algorithm.baselineOffsetForChild(child, gridAxisForDirection(direction()));
+    if (canUseCache)
+        m_algorithm.cacheIntrinsicLogicalHeightForChild(child, cacheKey, child.logicalHeight());
+    return child.logicalHeight() + marginLogicalSize + m_algorithm.baselineOffsetForChild(child, gridAxisForDirection(direction()));
 }
 
 LayoutUnit GridTrackSizingAlgorithmStrategy::minContentForChild(RenderBox& child) const
@@ -882,6 +910,54 @@ void GridTrackSizingAlgorithm::clearBaselineItemsCache()
     m_rowBaselineItemsMap.clear();
 }
 
+unsigned GridTrackSizingAlgorithm::itemLayoutCountDuringTrackSizing()
+{
+    return itemLayoutsDuringTrackSizing;
+}
+
+unsigned GridTrackSizingAlgorithm::intrinsicLogicalHeightCacheHitCount()
+{
+    return intrinsicLogicalHeightCacheHits;
+}
+
+void GridTrackSizingAlgorithm::resetTrackSizingCounters()
+{
+    itemLayoutsDuringTrackSizing = 0;
+    intrinsicLogicalHeightCacheHits = 0;
+}
+
+bool GridTrackSizingAlgorithm::canCacheIntrinsicLogicalHeightForChild(const RenderBox& child) const
+{
+    // Intrinsic size computations use a short-lived algorithm, and baseline aligned items need
+    // to be laid out for their baselines to be computed.
+    return m_sizingOperation == TrackSizing
+        && !participateInBaselineAlignment(child, GridRowAxis)
+        && !participateInBaselineAlignment(child, GridColumnAxis);
+}
+
+Optional<LayoutUnit> GridTrackSizingAlgorithm::cachedIntrinsicLogicalHeightForChild(const RenderBox& child, const IntrinsicLogicalHeightCacheKey& key) const
+{
+    auto it = m_intrinsicLogicalHeightCache.find(&child);
+    if (it == m_intrinsicLogicalHeightCache.end() || it->value.child.get() != &child || !(it->value.key == key))
+        return WTF::nullopt;
+    return it->value.logicalHeight;
+}
+
+void GridTrackSizingAlgorithm::cacheIntrinsicLogicalHeightForChild(const RenderBox& child, const IntrinsicLogicalHeightCacheKey& key, LayoutUnit logicalHeight)
+{
+    m_intrinsicLogicalHeightCache.set(&child, IntrinsicLogicalHeight { makeWeakPtr(child), key, logicalHeight });
+}
+
+void GridTrackSizingAlgorithm::removeStaleIntrinsicLogicalHeights()
+{
+    // Items which need layout have either changed their content or been laid out against a
+    // different available size than the one we measured, so their entries can't be trusted.
+    m_intrinsicLogicalHeightCache.removeIf([](auto& entry) {
+        auto* child = entry.value.child.get();
+        return !child || child != entry.key || child->needsLayout();
+    });
+}
+
 void GridTrackSizingAlgorithm::cacheBaselineAlignedItem(const RenderBox& item, GridAxis axis)
 {
     ASSERT(m_renderGrid->isBaselineAlignmentForChild(item, axis));
@@ -939,6 +1015,8 @@ void IndefiniteSizeStrategy::layoutGridItemForMinSizeComputation(RenderBox& chil
 {
     if (overrideSizeHasChanged && direction() != ForColumns)
         child.setNeedsLayout(MarkOnlyThis);
+    if (child.needsLayout())
+        ++itemLayoutsDuringTrackSizing;
     child.layoutIfNeeded();
 }
 
@@ -1076,6 +1154,8 @@ void DefiniteSizeStrategy::layoutGridItemForMinSizeComputation(RenderBox& child,
 {
     if (overrideSizeHasChanged)
         child.setNeedsLayout(MarkOnlyThis);
+    if (child.needsLayout())
+        ++itemLayoutsDuringTrackSizing;
     child.layoutIfNeeded();
 }
 
@@ -1321,6 +1401,8 @@ void GridTrackSizingAlgorithm::run()
     ASSERT(wasSetup());
     StateMachine stateMachine(*this);
 
+    removeStaleIntrinsicLogicalHeights();
+
     // Step 1.
     const Optional<LayoutUnit> initialFreeSpace = freeSpace(m_direction);
     initializeTrackSizes();
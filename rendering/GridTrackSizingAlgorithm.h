@@ -28,6 +28,8 @@
 #include "GridBaselineAlignment.h"
 #include "GridTrackSize.h"
 #include "LayoutSize.h"
+#include <wtf/HashMap.h>
+#include <wtf/WeakPtr.h>
 
 namespace WebCore {
 
@@ -125,6 +127,14 @@ public:
     void copyBaselineItemsCache(const GridTrackSizingAlgorithm&, GridAxis);
     void clearBaselineItemsCache();
 
+    void clearIntrinsicLogicalHeightCache() { m_intrinsicLogicalHeightCache.clear(); }
+
+    // Process-wide counters, exposed through Internals, of grid item layouts done while
+    // sizing tracks and of the layouts avoided thanks to the intrinsic logical height cache.
+    static unsigned itemLayoutCountDuringTrackSizing();
+    static unsigned intrinsicLogicalHeightCacheHitCount();
+    static void resetTrackSizingCounters();
+
     Vector<GridTrack>& tracks(GridTrackSizingDirection direction) { return direction == ForColumns ? m_columns : m_rows; }
     const Vector<GridTrack>& tracks(GridTrackSizingDirection direction) const { return direction == ForColumns ? m_columns : m_rows; }
 
@@ -168,6 +178,24 @@ private:
     bool participateInBaselineAlignment(const RenderBox&, GridAxis) const;
 
     bool isIntrinsicSizedGridArea(const RenderBox&, GridAxis) const;
+
+    // Caching of the intrinsic logical heights used by GridTrackSizingAlgorithmStrategy::logicalHeightForChild().
+    struct IntrinsicLogicalHeightCacheKey {
+        Optional<LayoutUnit> containingBlockContentLogicalWidth;
+        Optional<LayoutUnit> containingBlockContentLogicalHeight;
+        Optional<LayoutUnit> overridingLogicalWidth;
+
+        bool operator==(const IntrinsicLogicalHeightCacheKey& other) const
+        {
+            return containingBlockContentLogicalWidth == other.containingBlockContentLogicalWidth
+                && containingBlockContentLogicalHeight == other.containingBlockContentLogicalHeight
+                && overridingLogicalWidth == other.overridingLogicalWidth;
+        }
+    };
+    bool canCacheIntrinsicLogicalHeightForChild(const RenderBox&) const;
+    Optional<LayoutUnit> cachedIntrinsicLogicalHeightForChild(const RenderBox&, const IntrinsicLogicalHeightCacheKey&) const;
+    void cacheIntrinsicLogicalHeightForChild(const RenderBox&, const IntrinsicLogicalHeightCacheKey&, LayoutUnit logicalHeight);
+    void removeStaleIntrinsicLogicalHeights();
     void computeGridContainerIntrinsicSizes();
 
     // Helper methods for step 4. Strech flexible tracks.
@@ -235,6 +263,15 @@ private:
     BaselineItemsCache m_columnBaselineItemsMap;
     BaselineItemsCache m_rowBaselineItemsMap;
 
+    // Unlike the rest of the data, this cache survives reset() so that a relayout of the grid
+    // doesn't need to lay out again the items whose content and available size are unchanged.
+    struct IntrinsicLogicalHeight {
+        WeakPtr<const RenderBox> child;
+        IntrinsicLogicalHeightCacheKey key;
+        LayoutUnit logicalHeight;
+    };
+    HashMap<const RenderBox*, IntrinsicLogicalHeight> m_intrinsicLogicalHeightCache;
+
     // This is a RAII class used to ensure that the track sizing algorithm is
     // executed as it is suppossed to be, i.e., first resolve columns and then
     // rows. Only if required a second iteration is run following the same order,
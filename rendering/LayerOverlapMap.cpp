@@ -25,43 +25,139 @@
 
 #include "config.h"
 #include "LayerOverlapMap.h"
+#include "IntPointHash.h"
 #include "RenderLayer.h"
+#include <wtf/HashMap.h>
 #include <wtf/text/TextStream.h>
 
 namespace WebCore {
 
-struct RectList {
-    Vector<LayoutRect> rects;
-    LayoutRect boundingRect;
-    
+static bool usesGridIndex = true;
+
+// Stores the rects of the layers that later layers are tested against for overlap. Once it holds enough rects for
+// a linear scan to get expensive, the rects are also bucketed into a sparse grid of fixed size cells, so that testing
+// a layer only looks at the rects near it instead of at every layer added before it.
+class RectList {
+public:
     void append(const LayoutRect& rect)
     {
-        rects.append(rect);
-        boundingRect.unite(rect);
+        m_rects.append(rect);
+        m_boundingRect.unite(rect);
+
+        if (m_hasGridIndex)
+            addToGridIndex(m_rects.size() - 1);
+        else if (usesGridIndex && m_rects.size() >= minimumRectCountForGridIndex)
+            buildGridIndex();
     }
 
     void append(const RectList& rectList)
     {
-        rects.appendVector(rectList.rects);
-        boundingRect.unite(rectList.boundingRect);
+        for (auto& rect : rectList.m_rects)
+            append(rect);
     }
-    
+
     bool intersects(const LayoutRect& rect) const
     {
-        if (!rects.size() || !rect.intersects(boundingRect))
+        if (m_rects.isEmpty() || !rect.intersects(m_boundingRect))
             return false;
 
+        if (!m_hasGridIndex)
+            return intersectsAnyOf(rect, m_rects);
+
+        for (auto index : m_largeRectIndices) {
+            if (m_rects[index].intersects(rect))
+                return true;
+        }
+
+        // Clip the query to the area covered by the rects, so that huge layers don't visit a ton of empty cells.
+        auto queryRect = intersection(rect, m_boundingRect);
+        auto cellRange = cellRangeForRect(queryRect);
+        if (cellRange.cellCount() > maximumCellCountPerRect)
+            return intersectsAnyOf(rect, m_rects);
+
+        for (int y = cellRange.minY; y <= cellRange.maxY; ++y) {
+            for (int x = cellRange.minX; x <= cellRange.maxX; ++x) {
+                auto it = m_cells.find(IntPoint(x, y));
+                if (it == m_cells.end())
+                    continue;
+                for (auto index : it->value) {
+                    if (m_rects[index].intersects(rect))
+                        return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    const LayoutRect& boundingRect() const { return m_boundingRect; }
+    const Vector<LayoutRect>& rects() const { return m_rects; }
+
+private:
+    static constexpr unsigned minimumRectCountForGridIndex = 32;
+    static constexpr int cellSizeShift = 8; // 256x256 cells.
+    static constexpr uint64_t maximumCellCountPerRect = 64;
+
+    struct CellRange {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+
+        uint64_t cellCount() const { return static_cast<uint64_t>(maxX - minX + 1) * static_cast<uint64_t>(maxY - minY + 1); }
+    };
+
+    static CellRange cellRangeForRect(const LayoutRect& rect)
+    {
+        auto enclosingRect = enclosingIntRect(rect);
+        return { enclosingRect.x() >> cellSizeShift, enclosingRect.y() >> cellSizeShift,
+            (enclosingRect.maxX() - 1) >> cellSizeShift, (enclosingRect.maxY() - 1) >> cellSizeShift };
+    }
+
+    static bool intersectsAnyOf(const LayoutRect& rect, const Vector<LayoutRect>& rects)
+    {
         for (const auto& currentRect : rects) {
             if (currentRect.intersects(rect))
                 return true;
         }
         return false;
     }
+
+    void buildGridIndex()
+    {
+        m_hasGridIndex = true;
+        for (unsigned index = 0; index < m_rects.size(); ++index)
+            addToGridIndex(index);
+    }
+
+    void addToGridIndex(unsigned index)
+    {
+        auto& rect = m_rects[index];
+        // Empty rects never intersect anything.
+        if (rect.isEmpty())
+            return;
+
+        auto cellRange = cellRangeForRect(rect);
+        if (cellRange.cellCount() > maximumCellCountPerRect) {
+            m_largeRectIndices.append(index);
+            return;
+        }
+
+        for (int y = cellRange.minY; y <= cellRange.maxY; ++y) {
+            for (int x = cellRange.minX; x <= cellRange.maxX; ++x)
+                m_cells.add(IntPoint(x, y), Vector<unsigned> { }).iterator->value.append(index);
+        }
+    }
+
+    Vector<LayoutRect> m_rects;
+    LayoutRect m_boundingRect;
+    HashMap<IntPoint, Vector<unsigned>> m_cells;
+    Vector<unsigned> m_largeRectIndices;
+    bool m_hasGridIndex { false };
 };
 
 static TextStream& operator<<(TextStream& ts, const RectList& rectList)
 {
-    ts << "bounds " << rectList.boundingRect << " (" << rectList.rects << " rects)";
+    ts << "bounds " << rectList.boundingRect() << " (" << rectList.rects() << " rects)";
     return ts;
 }
 
@@ -267,10 +363,34 @@ String OverlapMapContainer::dump(unsigned indent) const
     return multilineStream.release();
 }
 
-LayerOverlapMap::LayerOverlapMap(const RenderLayer& rootLayer)
+bool LayerOverlapMap::ChangeLog::isSameChange(unsigned index, const ChangeLog& other, unsigned otherIndex) const
+{
+    auto& change = changes[index];
+    auto& otherChange = other.changes[otherIndex];
+    if (change.type != otherChange.type || change.layer.get() != otherChange.layer.get() || change.bounds != otherChange.bounds || change.clippingLayerCount != otherChange.clippingLayerCount)
+        return false;
+
+    for (unsigned i = 0; i < change.clippingLayerCount; ++i) {
+        auto& clippingLayer = clippingLayers[change.firstClippingLayer + i];
+        auto& otherClippingLayer = other.clippingLayers[otherChange.firstClippingLayer + i];
+        if (clippingLayer.layer.get() != otherClippingLayer.layer.get() || clippingLayer.bounds != otherClippingLayer.bounds)
+            return false;
+    }
+    return true;
+}
+
+void LayerOverlapMap::setUsesGridIndex(bool uses)
+{
+    usesGridIndex = uses;
+}
+
+LayerOverlapMap::LayerOverlapMap(const RenderLayer& rootLayer, ChangeLog& changeLog)
     : m_geometryMap(UseTransforms)
     , m_rootLayer(rootLayer)
+    , m_changeLog(changeLog)
 {
+    m_changeLog.clear();
+
     // Begin assuming the root layer will be composited so that there is
     // something on the stack. The root layer should also never get an
     // popCompositingContainer call.
@@ -286,10 +406,38 @@ void LayerOverlapMap::add(const RenderLayer& layer, const LayoutRect& bounds, co
     // recursively processed and popped off the stack.
     ASSERT(m_overlapStack.size() >= 2);
     m_overlapStack[m_overlapStack.size() - 2]->add(layer, bounds, enclosingClippingLayers);
-    
+
+    unsigned firstClippingLayer = m_changeLog.clippingLayers.size();
+    unsigned clippingLayerCount = enclosingClippingLayers.size();
+    m_changeLog.changes.append({ Change::Type::Add, makeWeakPtr(const_cast<RenderLayer&>(layer)), bounds, firstClippingLayer, clippingLayerCount });
+    for (auto& clippingLayer : enclosingClippingLayers)
+        m_changeLog.clippingLayers.append({ makeWeakPtr(clippingLayer.layer), clippingLayer.bounds });
+
     m_isEmpty = false;
 }
 
+bool LayerOverlapMap::addFromPreviousChange(const RenderLayer& layer, const ChangeLog& previousLog, unsigned index)
+{
+    if (index >= previousLog.changes.size())
+        return false;
+
+    auto& change = previousLog.changes[index];
+    if (change.type != Change::Type::Add || change.layer.get() != &layer)
+        return false;
+
+    Vector<LayerAndBounds> enclosingClippingLayers;
+    enclosingClippingLayers.reserveInitialCapacity(change.clippingLayerCount);
+    for (unsigned i = 0; i < change.clippingLayerCount; ++i) {
+        auto& clippingLayer = previousLog.clippingLayers[change.firstClippingLayer + i];
+        if (!clippingLayer.layer)
+            return false;
+        enclosingClippingLayers.uncheckedAppend({ *clippingLayer.layer, clippingLayer.bounds });
+    }
+
+    add(layer, change.bounds, enclosingClippingLayers);
+    return true;
+}
+
 bool LayerOverlapMap::overlapsLayers(const RenderLayer& layer, const LayoutRect& bounds, const Vector<LayerAndBounds>& enclosingClippingLayers) const
 {
     return m_overlapStack.last()->overlapsLayers(layer, bounds, enclosingClippingLayers);
@@ -298,12 +446,14 @@ bool LayerOverlapMap::overlapsLayers(const RenderLayer& layer, const LayoutRect&
 void LayerOverlapMap::pushCompositingContainer()
 {
     m_overlapStack.append(makeUnique<OverlapMapContainer>(m_rootLayer));
+    m_changeLog.changes.append({ Change::Type::PushContainer, nullptr, { }, 0, 0 });
 }
 
 void LayerOverlapMap::popCompositingContainer()
 {
     m_overlapStack[m_overlapStack.size() - 2]->append(WTFMove(m_overlapStack.last()));
     m_overlapStack.removeLast();
+    m_changeLog.changes.append({ Change::Type::PopContainer, nullptr, { }, 0, 0 });
 }
 
 static TextStream& operator<<(TextStream& ts, const OverlapMapContainer& container)
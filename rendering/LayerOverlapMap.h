@@ -27,6 +27,7 @@
 
 #include "LayoutRect.h"
 #include "RenderGeometryMap.h"
+#include <wtf/WeakPtr.h>
 
 namespace WTF {
 class TextStream;
@@ -41,7 +42,35 @@ class RenderLayer;
 class LayerOverlapMap {
     WTF_MAKE_NONCOPYABLE(LayerOverlapMap);
 public:
-    LayerOverlapMap(const RenderLayer& rootLayer);
+    // Every change made to the map, in order, so that what a subtree of layers contributed to the map
+    // can be compared with, or copied from, the previous compositing update. Layers are held weakly, so
+    // that a layer destroyed since then never matches a new layer allocated at the same address. The log
+    // is owned by the caller, so that its buffers are reused from one update to the next.
+    struct Change {
+        enum class Type : uint8_t { Add, PushContainer, PopContainer };
+        Type type;
+        WeakPtr<RenderLayer> layer;
+        LayoutRect bounds;
+        unsigned firstClippingLayer { 0 };
+        unsigned clippingLayerCount { 0 };
+    };
+    struct ClippingLayerChange {
+        WeakPtr<RenderLayer> layer;
+        LayoutRect bounds;
+    };
+    struct ChangeLog {
+        Vector<Change> changes;
+        Vector<ClippingLayerChange> clippingLayers;
+
+        void clear()
+        {
+            changes.shrink(0);
+            clippingLayers.shrink(0);
+        }
+        bool isSameChange(unsigned index, const ChangeLog& other, unsigned otherIndex) const;
+    };
+
+    LayerOverlapMap(const RenderLayer& rootLayer, ChangeLog&);
     ~LayerOverlapMap();
     
     struct LayerAndBounds {
@@ -50,9 +79,13 @@ public:
     };
 
     void add(const RenderLayer&, const LayoutRect&, const Vector<LayerAndBounds>& enclosingClippingLayers);
+    // Adds again what the Add change at index of a previous update's log added, if its layers are all still alive.
+    bool addFromPreviousChange(const RenderLayer&, const ChangeLog& previousLog, unsigned index);
     bool overlapsLayers(const RenderLayer&, const LayoutRect&, const Vector<LayerAndBounds>& enclosingClippingLayers) const;
     bool isEmpty() const { return m_isEmpty; }
 
+    const ChangeLog& changeLog() const { return m_changeLog; }
+
     void pushCompositingContainer();
     void popCompositingContainer();
 
@@ -61,10 +94,14 @@ public:
 
     const Vector<std::unique_ptr<OverlapMapContainer>>& overlapStack() const { return m_overlapStack; }
 
+    // For performance testing. Without the grid index, every overlap test scans all the rects of its clipping scope.
+    static void setUsesGridIndex(bool);
+
 private:
     Vector<std::unique_ptr<OverlapMapContainer>> m_overlapStack;
     RenderGeometryMap m_geometryMap;
     const RenderLayer& m_rootLayer;
+    ChangeLog& m_changeLog;
     bool m_isEmpty { true };
 };
 
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RenderLayerCompositor.h"
+
+#include "LayerOverlapMap.h"
+#include "RenderLayer.h"
+#include "RenderView.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/text/TextStream.h>
+
+namespace WebCore {
+
+static unsigned compositedLayerCount(const RenderLayer& layer)
+{
+    unsigned count = layer.isComposited() ? 1 : 0;
+    for (auto* child = layer.firstChild(); child; child = child->nextSibling())
+        count += compositedLayerCount(*child);
+    return count;
+}
+
+String RenderLayerCompositor::runOverlapMapBenchmark(unsigned iterations)
+{
+    iterations = std::max(iterations, 1u);
+
+    auto timeUpdates = [&]() -> Optional<Seconds> {
+        Seconds updateTime;
+        for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+            // A full requirements traversal tests every layer against the layers painted before it, as scrolling does.
+            rootRenderLayer().setDescendantsNeedCompositingRequirementsTraversal();
+            auto startTime = MonotonicTime::now();
+            if (!updateCompositingLayers(CompositingUpdateType::AfterLayout))
+                return WTF::nullopt;
+            updateTime += MonotonicTime::now() - startTime;
+        }
+        return updateTime / iterations;
+    };
+
+    LayerOverlapMap::setUsesGridIndex(false);
+    auto linearScanTime = timeUpdates();
+    LayerOverlapMap::setUsesGridIndex(true);
+    auto gridIndexTime = timeUpdates();
+    if (!linearScanTime || !gridIndexTime)
+        return "Compositing layers can't be updated."_s;
+
+    TextStream stream;
+    stream << "Overlap map benchmark: " << iterations << " iterations, " << m_compositingRequirementsVisitedLayerCount << " layers, "
+        << compositedLayerCount(rootRenderLayer()) << " composited\n";
+    stream << "scanning every rect: " << linearScanTime->milliseconds() << "ms/update\n";
+    stream << "grid index: " << gridIndexTime->milliseconds() << "ms/update\n";
+    return stream.release();
+}
+
+} // namespace WebCore
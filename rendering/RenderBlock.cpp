@@ -1153,9 +1153,15 @@ void RenderBlock::paintChildren(PaintInfo& paintInfo, const LayoutPoint& paintOf
     }
 }
 
+static inline bool isChildLayoutDeferred(const RenderBlock& block, const RenderBox& child)
+{
+    // Lazily laid out children skip their layout until they get close to the visible rect. They have no content to show yet.
+    return block.view().frameView().layoutContext().isLayoutOfSubtreeSkipped(child);
+}
+
 bool RenderBlock::paintChild(RenderBox& child, PaintInfo& paintInfo, const LayoutPoint& paintOffset, PaintInfo& paintInfoForChild, bool usePrintRect, PaintBlockType paintType)
 {
-    if (child.isExcludedAndPlacedInBorder())
+    if (child.isExcludedAndPlacedInBorder() || isChildLayoutDeferred(*this, child))
         return true;
 
     // Check for page-break-before: always, and if it's set, break and bail.
@@ -2120,6 +2126,8 @@ bool RenderBlock::hitTestContents(const HitTestRequest& request, HitTestResult&
     if (hitTestAction == HitTestChildBlockBackgrounds)
         childHitTest = HitTestChildBlockBackground;
     for (auto* child = lastChildBox(); child; child = child->previousSiblingBox()) {
+        if (isChildLayoutDeferred(*this, *child))
+            continue;
         LayoutPoint childPoint = flipForWritingModeForChild(child, accumulatedOffset);
         if (!child->hasSelfPaintingLayer() && !child->isFloating() && child->nodeAtPoint(request, result, locationInContainer, childPoint, childHitTest))
             return true;
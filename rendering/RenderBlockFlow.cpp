@@ -68,6 +68,9 @@ WTF_MAKE_ISO_ALLOCATED_IMPL(RenderBlockFlow);
 
 bool RenderBlock::s_canPropagateFloatIntoSibling = false;
 
+// Blocks with fewer children are always laid out in full, see Settings::lazyLayoutEnabled.
+static const unsigned minimumChildCountForLazyLayout = 200;
+
 struct SameSizeAsMarginInfo {
     uint32_t bitfields : 16;
     LayoutUnit margins[2];
@@ -645,6 +648,26 @@ void RenderBlockFlow::layoutBlockChildren(bool relayoutChildren, LayoutUnit& max
     LayoutUnit previousFloatLogicalBottom;
     maxFloatLogicalBottom = 0;
 
+    // Lazy layout: dirty children far from the visible rect skip their layout. They are sized using the precisely laid out
+    // children and this block gets laid out again when they get close to the visible rect.
+    auto& layoutContext = view().frameView().layoutContext();
+    auto lazyLayoutRect = [&]() -> Optional<LayoutRect> {
+        if (!settings().lazyLayoutEnabled())
+            return WTF::nullopt;
+        unsigned childCount = 0;
+        for (auto* child = firstChildBox(); child && childCount < minimumChildCountForLazyLayout; child = child->nextSiblingBox())
+            ++childCount;
+        if (childCount < minimumChildCountForLazyLayout)
+            return WTF::nullopt;
+        return layoutContext.lazyLayoutRect(*this);
+    }();
+    // Children skipped by a previous layout need to be laid out again once they are not deferred anymore.
+    bool mayHaveSkippedChildren = layoutContext.hasDeferredLayoutRanges(*this);
+    Vector<FrameViewLayoutContext::DeferredLayoutRange> deferredLayoutRanges;
+    LayoutUnit preciseChildrenLogicalHeight;
+    unsigned preciseChildCount = 0;
+    bool previousChildIsDeferred = false;
+
     RenderBox* next = firstChildBox();
 
     while (next) {
@@ -664,11 +687,40 @@ void RenderBlockFlow::layoutBlockChildren(bool relayoutChildren, LayoutUnit& max
         if (child.isFloating()) {
             insertFloatingObject(child);
             adjustFloatingBlock(marginInfo);
+            previousChildIsDeferred = false;
             continue;
         }
 
+        if (lazyLayoutRect) {
+            auto estimatedLogicalHeight = preciseChildCount ? preciseChildrenLogicalHeight / preciseChildCount : child.logicalHeight();
+            if (deferLayoutOfBlockChildIfPossible(child, marginInfo, *lazyLayoutRect, estimatedLogicalHeight)) {
+                auto childLogicalTop = logicalTopForChild(child);
+                if (previousChildIsDeferred)
+                    deferredLayoutRanges.last().logicalBottom = childLogicalTop + estimatedLogicalHeight;
+                else
+                    deferredLayoutRanges.append({ childLogicalTop, childLogicalTop + estimatedLogicalHeight });
+                previousChildIsDeferred = true;
+                continue;
+            }
+        }
+
+        if (mayHaveSkippedChildren)
+            layoutContext.markSkippedSubtreeForLayout(child);
+
         // Lay out the child.
         layoutBlockChild(child, marginInfo, previousFloatLogicalBottom, maxFloatLogicalBottom);
+        previousChildIsDeferred = false;
+        if (lazyLayoutRect) {
+            preciseChildrenLogicalHeight += logicalHeightForChild(child);
+            ++preciseChildCount;
+        }
+    }
+
+    if (lazyLayoutRect || mayHaveSkippedChildren) {
+        if (deferredLayoutRanges.isEmpty())
+            layoutContext.clearDeferredLayoutRanges(*this);
+        else
+            layoutContext.setDeferredLayoutRanges(*this, WTFMove(deferredLayoutRanges));
     }
     
     // Now do the handling of the bottom of the block, adding in our bottom border/padding and
@@ -702,6 +754,42 @@ void RenderBlockFlow::layoutInlineChildren(bool relayoutChildren, LayoutUnit& re
     complexLineLayout()->layoutLineBoxes(relayoutChildren, repaintLogicalTop, repaintLogicalBottom);
 }
 
+bool RenderBlockFlow::deferLayoutOfBlockChildIfPossible(RenderBox& child, MarginInfo& marginInfo, const LayoutRect& lazyLayoutRect, LayoutUnit estimatedLogicalHeight)
+{
+    // Only plain, layerless block children that don't interact with floats or with our own margins can be sized by estimate.
+    if (!estimatedLogicalHeight || !is<RenderBlockFlow>(child) || child.hasLayer() || child.isWritingModeRoot())
+        return false;
+    // Children that are already laid out don't need to be deferred.
+    auto& layoutContext = view().frameView().layoutContext();
+    if (!child.needsLayout() && !layoutContext.isLayoutOfSubtreeSkipped(child))
+        return false;
+    if (containsFloats() || marginInfo.atBeforeSideOfBlock() || marginInfo.discardMargin())
+        return false;
+
+    child.computeAndSetBlockDirectionMargins(*this);
+    // The deferred child is treated as a non-self-collapsing box: its before margin collapses with the pending margin only.
+    auto marginBefore = child.marginBefore();
+    auto positiveMargin = std::max(marginInfo.positiveMargin(), std::max(0_lu, marginBefore));
+    auto negativeMargin = std::max(marginInfo.negativeMargin(), std::max(0_lu, -marginBefore));
+    auto logicalTop = logicalHeight() + positiveMargin - negativeMargin;
+    if (logicalTop < lazyLayoutRect.maxY() && logicalTop + estimatedLogicalHeight > lazyLayoutRect.y())
+        return false;
+
+    // Dirty content (including new content in an already skipped child) is checked before its layout gets skipped.
+    if (child.needsLayout()) {
+        if (!FrameViewLayoutContext::canSkipLayoutOfSubtree(child))
+            return false;
+        layoutContext.skipLayoutOfSubtree(child);
+    }
+
+    setLogicalTopForChild(child, logicalTop);
+    child.setLogicalHeight(estimatedLogicalHeight);
+    setLogicalHeight(logicalTop + estimatedLogicalHeight);
+    auto marginAfter = child.marginAfter();
+    marginInfo.setMargin(std::max(0_lu, marginAfter), std::max(0_lu, -marginAfter));
+    return true;
+}
+
 void RenderBlockFlow::layoutBlockChild(RenderBox& child, MarginInfo& marginInfo, LayoutUnit& previousFloatLogicalBottom, LayoutUnit& maxFloatLogicalBottom)
 {
     LayoutUnit oldPosMarginBefore = maxPositiveMarginBefore();
@@ -234,6 +234,7 @@ public:
     LayoutUnit marginOffsetForSelfCollapsingBlock();
 
     void layoutBlockChild(RenderBox& child, MarginInfo&, LayoutUnit& previousFloatLogicalBottom, LayoutUnit& maxFloatLogicalBottom);
+    bool deferLayoutOfBlockChildIfPossible(RenderBox& child, MarginInfo&, const LayoutRect& lazyLayoutRect, LayoutUnit estimatedLogicalHeight);
     void adjustPositionedBlock(RenderBox& child, const MarginInfo&);
     void adjustFloatingBlock(const MarginInfo&);
 
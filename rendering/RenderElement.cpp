@@ -990,6 +990,10 @@ void RenderElement::willBeRemovedFromTree()
     if (isOutOfFlowPositioned() && parent()->childrenInline())
         parent()->dirtyLinesFromChangedChild(*this);
 
+    // A subtree that skipped its layout (lazy layout) needs to be laid out in full wherever it gets inserted next.
+    if (is<RenderBox>(*this))
+        view().frameView().layoutContext().markSkippedSubtreeForLayout(downcast<RenderBox>(*this));
+
     RenderObject::willBeRemovedFromTree();
 }
 
@@ -62,6 +62,10 @@ struct RenderFlexibleBox::LineContext {
     Vector<FlexItem> flexItems;
 };
 
+static unsigned itemMeasureLayouts;
+static unsigned itemMeasureCacheHits;
+static bool reusesCachedMainSizes = true;
+
 RenderFlexibleBox::RenderFlexibleBox(Element& element, RenderStyle&& style)
     : RenderBlock(element, WTFMove(style), 0)
 {
@@ -219,6 +223,8 @@ void RenderFlexibleBox::styleDidChange(StyleDifference diff, const RenderStyle*
     if (!oldStyle || diff != StyleDifference::Layout)
         return;
 
+    m_intrinsicSizeAlongMainAxis.clear();
+
     if (oldStyle->resolvedAlignItems(selfAlignmentNormalBehavior()).position() == ItemPosition::Stretch) {
         // Flex items that were previously stretching need to be relayed out so we
         // can compute new available cross axis space. This is only necessary for
@@ -853,7 +859,7 @@ void RenderFlexibleBox::cacheChildMainSize(const RenderBox& child)
             mainSize = child.logicalHeight();
     }
   
-    m_intrinsicSizeAlongMainAxis.set(&child, mainSize);
+    m_intrinsicSizeAlongMainAxis.set(&child, MainSizeMeasurement { mainSize, availableCrossSizeForMeasuringChild(child) });
     m_relaidOutChildren.add(&child);
 }
 
@@ -862,6 +868,52 @@ void RenderFlexibleBox::clearCachedMainSizeForChild(const RenderBox& child)
     m_intrinsicSizeAlongMainAxis.remove(&child);
 }
 
+Optional<LayoutUnit> RenderFlexibleBox::availableCrossSizeForMeasuringChild(const RenderBox& child) const
+{
+    // Children are measured with an indefinite main size, so the only outer constraint
+    // is the inline size of their containing block. Orthogonal children resolve their
+    // inline size against our logical height, the viewport or their own overrides
+    // (see perpendicularContainingBlockLogicalHeight()), so their measurements are not reused.
+    if (child.isHorizontalWritingMode() != isHorizontalWritingMode())
+        return WTF::nullopt;
+    return contentLogicalWidth();
+}
+
+bool RenderFlexibleBox::canReuseCachedMainSizeForChild(const RenderBox& child) const
+{
+    // A clean child measured against the same available size lays out to the same size again,
+    // even if we are forced to relayout all children, so skip the measuring layout and let
+    // layoutAndPlaceChildren() do the only layout needed.
+    if (!reusesCachedMainSizes || child.needsLayout())
+        return false;
+    auto availableCrossSize = availableCrossSizeForMeasuringChild(child);
+    if (!availableCrossSize)
+        return false;
+    auto it = m_intrinsicSizeAlongMainAxis.find(&child);
+    return it != m_intrinsicSizeAlongMainAxis.end() && it->value.availableCrossSize == availableCrossSize;
+}
+
+unsigned RenderFlexibleBox::itemMeasureLayoutCount()
+{
+    return itemMeasureLayouts;
+}
+
+unsigned RenderFlexibleBox::itemMeasureCacheHitCount()
+{
+    return itemMeasureCacheHits;
+}
+
+void RenderFlexibleBox::resetItemMeasureCounters()
+{
+    itemMeasureLayouts = 0;
+    itemMeasureCacheHits = 0;
+}
+
+void RenderFlexibleBox::setReusesCachedMainSizes(bool reuses)
+{
+    reusesCachedMainSizes = reuses;
+}
+
     
 LayoutUnit RenderFlexibleBox::computeInnerFlexBaseSizeForChild(RenderBox& child, LayoutUnit mainAxisBorderAndPadding)
 {
@@ -879,7 +931,7 @@ LayoutUnit RenderFlexibleBox::computeInnerFlexBaseSizeForChild(RenderBox& child,
     if (!mainAxisIsChildInlineAxis(child)) {
         ASSERT(!child.needsLayout());
         ASSERT(m_intrinsicSizeAlongMainAxis.contains(&child));
-        mainAxisExtent = m_intrinsicSizeAlongMainAxis.get(&child);
+        mainAxisExtent = m_intrinsicSizeAlongMainAxis.get(&child).mainSize;
     } else {
         // We don't need to add scrollbarLogicalWidth here because the preferred
         // width includes the scrollbar, even for overflow: auto.
@@ -1233,20 +1285,25 @@ FlexItem RenderFlexibleBox::constructFlexItem(RenderBox& child, bool relayoutChi
         // child.intrinsicContentLogicalHeight() and child.scrollbarLogicalHeight(),
         // so if the child has intrinsic min/max/preferred size, run layout on it now to make sure
         // its logical height and scroll bars are up to date.
-        updateBlockChildDirtyBitsBeforeLayout(relayoutChildren, child);
-        // Don't resolve percentages in children. This is especially important for the min-height calculation,
-        // where we want percentages to be treated as auto. For flex-basis itself, this is not a problem because
-        // by definition we have an indefinite flex basis here and thus percentages should not resolve.
-        if (child.needsLayout() || !m_intrinsicSizeAlongMainAxis.contains(&child)) {
-            if (isHorizontalWritingMode() == child.isHorizontalWritingMode())
-                child.setOverridingContainingBlockContentLogicalHeight(WTF::nullopt);
-            else
-                child.setOverridingContainingBlockContentLogicalWidth(WTF::nullopt);
-            child.clearOverridingContentSize();
-            child.setChildNeedsLayout(MarkOnlyThis);
-            child.layoutIfNeeded();
-            cacheChildMainSize(child);
-            child.clearOverridingContainingBlockContentSize();
+        if (canReuseCachedMainSizeForChild(child))
+            ++itemMeasureCacheHits;
+        else {
+            updateBlockChildDirtyBitsBeforeLayout(relayoutChildren, child);
+            // Don't resolve percentages in children. This is especially important for the min-height calculation,
+            // where we want percentages to be treated as auto. For flex-basis itself, this is not a problem because
+            // by definition we have an indefinite flex basis here and thus percentages should not resolve.
+            if (child.needsLayout() || !m_intrinsicSizeAlongMainAxis.contains(&child)) {
+                if (isHorizontalWritingMode() == child.isHorizontalWritingMode())
+                    child.setOverridingContainingBlockContentLogicalHeight(WTF::nullopt);
+                else
+                    child.setOverridingContainingBlockContentLogicalWidth(WTF::nullopt);
+                child.clearOverridingContentSize();
+                child.setChildNeedsLayout(MarkOnlyThis);
+                child.layoutIfNeeded();
+                ++itemMeasureLayouts;
+                cacheChildMainSize(child);
+                child.clearOverridingContainingBlockContentSize();
+            }
         }
     }
     
@@ -72,6 +72,16 @@ public:
     Optional<LayoutUnit> childLogicalHeightForPercentageResolution(const RenderBox&);
     
     void clearCachedMainSizeForChild(const RenderBox& child);
+
+    // Process-wide counters, exposed through Internals, of the flex item layouts done to measure
+    // their main size and of the ones avoided by reusing a previous measurement.
+    static unsigned itemMeasureLayoutCount();
+    static unsigned itemMeasureCacheHitCount();
+    static void resetItemMeasureCounters();
+
+    // Relayouts the outermost flexboxes of the render view at alternating widths, the way resizing the window does, with and
+    // without reusing the main size measurements of clean flex items, and reports the layout time and the measuring layouts.
+    static String runNestedFlexBenchmark(RenderView&, unsigned iterations);
     
     LayoutUnit cachedChildIntrinsicContentLogicalHeight(const RenderBox& child) const;
     void setCachedChildIntrinsicContentLogicalHeight(const RenderBox& child, LayoutUnit);
@@ -106,6 +116,8 @@ private:
     typedef Vector<LayoutRect, 8> ChildFrameRects;
 
     struct LineContext;
+
+    static void setReusesCachedMainSizes(bool);
     
     bool mainAxisIsChildInlineAxis(const RenderBox&) const;
     bool isColumnFlow() const;
@@ -153,6 +165,8 @@ private:
     Overflow mainAxisOverflowForChild(const RenderBox& child) const;
     Overflow crossAxisOverflowForChild(const RenderBox& child) const;
     void cacheChildMainSize(const RenderBox& child);
+    Optional<LayoutUnit> availableCrossSizeForMeasuringChild(const RenderBox& child) const;
+    bool canReuseCachedMainSizeForChild(const RenderBox& child) const;
     Optional<LayoutUnit> crossSizeForPercentageResolution(const RenderBox&);
     Optional<LayoutUnit> mainSizeForPercentageResolution(const RenderBox&);
 
@@ -197,8 +211,14 @@ private:
     LayoutUnit computeGap(GapType) const;
 
     // This is used to cache the preferred size for orthogonal flow children so we
-    // don't have to relayout to get it
-    HashMap<const RenderBox*, LayoutUnit> m_intrinsicSizeAlongMainAxis;
+    // don't have to relayout to get it. The cross size available when the child
+    // was measured is kept along so the size can be reused by later layouts, as
+    // long as the child itself is clean.
+    struct MainSizeMeasurement {
+        LayoutUnit mainSize;
+        Optional<LayoutUnit> availableCrossSize;
+    };
+    HashMap<const RenderBox*, MainSizeMeasurement> m_intrinsicSizeAlongMainAxis;
     
     // This is used to cache the intrinsic size on the cross axis to avoid
     // relayouts when stretching.
@@ -83,6 +83,8 @@ void RenderGrid::styleDidChange(StyleDifference diff, const RenderStyle* oldStyl
     if (!oldStyle || diff != StyleDifference::Layout)
         return;
 
+    m_trackSizingAlgorithm.clearIntrinsicLogicalHeightCache();
+
     const RenderStyle& newStyle = this->style();
     if (oldStyle->resolvedAlignItems(selfAlignmentNormalBehavior(this)).position() == ItemPosition::Stretch) {
         // Style changes on the grid container implying stretching (to-stretch) or
@@ -847,6 +849,8 @@ GridTrackSizingDirection RenderGrid::autoPlacementMinorAxisDirection() const
 
 void RenderGrid::dirtyGrid()
 {
+    m_trackSizingAlgorithm.clearIntrinsicLogicalHeightCache();
+
     if (m_grid.needsItemsPlacement())
         return;
 
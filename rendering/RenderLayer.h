@@ -1213,6 +1213,28 @@ private:
     void setIndirectCompositingReason(IndirectCompositingReason reason) { m_indirectCompositingReason = static_cast<unsigned>(reason); }
     bool mustCompositeForIndirectReasons() const { return m_indirectCompositingReason; }
 
+    // What this layer's subtree passed on to the layers that follow it in paint order during a compositing
+    // requirements traversal. The overlap map changes are a range in that traversal's LayerOverlapMap::ChangeLog,
+    // and ownOverlapMapChange is the index of the rect this layer itself added, if any.
+    static constexpr unsigned noOverlapMapChange = std::numeric_limits<unsigned>::max();
+    struct CompositingRequirementsContribution {
+        unsigned traversalIdentifier { 0 };
+        unsigned firstOverlapMapChange { 0 };
+        unsigned overlapMapChangeCount { 0 };
+        unsigned ownOverlapMapChange { noOverlapMapChange };
+        WeakPtr<RenderLayer> backingProviderCandidate;
+        bool isComposited { false };
+        bool paintsIntoProvidedBacking { false };
+        bool has3DTransform { false };
+        bool subtreeIsCompositing { false };
+        bool testingOverlap { false };
+        bool hasCompositedNonContainedDescendants { false };
+        bool hasNotIsolatedCompositedBlendingDescendants { false };
+        bool hasExtentUncertainty { false };
+    };
+    const CompositingRequirementsContribution& compositingRequirementsContribution() const { return m_compositingRequirementsContribution; }
+    void setCompositingRequirementsContribution(const CompositingRequirementsContribution& contribution) { m_compositingRequirementsContribution = contribution; }
+
     LayoutUnit overflowTop() const;
     LayoutUnit overflowBottom() const;
     LayoutUnit overflowLeft() const;
@@ -1380,6 +1402,8 @@ private:
     std::unique_ptr<RenderLayerBacking> m_backing;
     
     PaintFrequencyTracker m_paintFrequencyTracker;
+
+    CompositingRequirementsContribution m_compositingRequirementsContribution;
 };
 
 inline void RenderLayer::clearZOrderLists()
@@ -43,7 +43,6 @@
 #include "InspectorInstrumentation.h"
 #include "KeyframeEffectStack.h"
 #include "LayerAncestorClippingStack.h"
-#include "LayerOverlapMap.h"
 #include "Logging.h"
 #include "NodeList.h"
 #include "Page.h"
@@ -841,10 +840,24 @@ bool RenderLayerCompositor::updateCompositingLayers(CompositingUpdateType update
         auto& rootLayer = rootRenderLayer();
         CompositingState compositingState(updateRoot);
         BackingSharingState backingSharingState;
-        LayerOverlapMap overlapMap(rootLayer);
+        LayerOverlapMap overlapMap(rootLayer, m_overlapMapChangeLog);
+
+        // Layout, scrolling and zooming move layers without dirtying them, so clean layers only reuse the rects they added
+        // to the overlap map in the previous traversal if none of them happened since.
+        unsigned layoutCount = m_renderView.frameView().layoutContext().layoutCount();
+        auto scrollPosition = m_renderView.frameView().scrollPosition();
+        m_overlapMapGeometryIsUnchanged = m_compositingRequirementsTraversalIdentifier && layoutCount == m_overlapMapLayoutCount && scrollPosition == m_overlapMapScrollPosition && pageScaleFactor() == m_overlapMapPageScaleFactor;
+        m_overlapMapLayoutCount = layoutCount;
+        m_overlapMapScrollPosition = scrollPosition;
+        m_overlapMapPageScaleFactor = pageScaleFactor();
 
         bool descendantHas3DTransform = false;
+        m_compositingRequirementsVisitedLayerCount = 0;
+        m_compositingRequirementsRecomputedLayerCount = 0;
+        ++m_compositingRequirementsTraversalIdentifier;
         computeCompositingRequirements(nullptr, rootLayer, overlapMap, compositingState, backingSharingState, descendantHas3DTransform);
+        std::swap(m_overlapMapChangeLog, m_previousOverlapMapChangeLog);
+        LOG_WITH_STREAM(Compositing, stream << " compositing requirements recomputed for " << m_compositingRequirementsRecomputedLayerCount << " of " << m_compositingRequirementsVisitedLayerCount << " visited layers");
     }
 
     LOG(Compositing, "\nRenderLayerCompositor::updateCompositingLayers - mid");
@@ -936,7 +949,17 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* ancestor
 
     LOG_WITH_STREAM(Compositing, stream << TextStream::Repeat(compositingState.depth * 2, ' ') << &layer << (layer.isNormalFlowOnly() ? " n" : " s") << " computeCompositingRequirements (backing provider candidate " << backingSharingState.backingProviderCandidate() << ")");
 
-    // FIXME: maybe we can avoid updating all remaining layers in paint order.
+    ++m_compositingRequirementsVisitedLayerCount;
+    if (layer.needsCompositingRequirementsTraversal() || compositingState.fullPaintOrderTraversalRequired || compositingState.descendantsRequireCompositingUpdate)
+        ++m_compositingRequirementsRecomputedLayerCount;
+
+    // A dirty layer forces its descendants and, until we know what changed, the remaining layers in paint order
+    // to be recomputed. Once this subtree is done, we check whether its contribution to the state seen by the
+    // following layers is any different from the last update; if it isn't, they can go back to the fast path.
+    bool layerIsChangeOrigin = layer.needsCompositingRequirementsTraversal() && !compositingState.fullPaintOrderTraversalRequired && !compositingState.descendantsRequireCompositingUpdate;
+    bool layerForcesSubsequentLayers = layer.subsequentLayersNeedCompositingRequirementsTraversal();
+    unsigned firstOverlapMapChange = overlapMap.changeLog().changes.size();
+
     compositingState.fullPaintOrderTraversalRequired |= layer.needsCompositingRequirementsTraversal();
     compositingState.descendantsRequireCompositingUpdate |= layer.descendantsNeedCompositingRequirementsTraversal();
 
@@ -1152,8 +1175,17 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* ancestor
     backingSharingState.updateAfterDescendantTraversal(layer, compositingState.stackingContextAncestor);
 
     bool layerContributesToOverlap = (currentState.compositingAncestor && !currentState.compositingAncestor->isRenderViewLayer()) || currentState.backingSharingAncestor;
+    unsigned ownOverlapMapChange = overlapMap.changeLog().changes.size();
     updateOverlapMap(overlapMap, layer, layerExtent, didPushOverlapContainer, layerContributesToOverlap, becameCompositedAfterDescendantTraversal && !descendantsAddedToOverlap);
 
+    auto previousContribution = layer.compositingRequirementsContribution();
+    layer.setCompositingRequirementsContribution(compositingRequirementsContribution(layer, overlapMap, firstOverlapMapChange, ownOverlapMapChange, currentState, layerExtent, backingSharingState, anyDescendantHas3DTransform));
+    if (layerIsChangeOrigin && !layerForcesSubsequentLayers && isSameCompositingRequirementsContribution(previousContribution, layer.compositingRequirementsContribution(), overlapMap)) {
+        LOG_WITH_STREAM(Compositing, stream << TextStream::Repeat(compositingState.depth * 2, ' ') << &layer << " contribution unchanged, subsequent layers are not recomputed");
+        compositingState.fullPaintOrderTraversalRequired = false;
+        compositingState.descendantsRequireCompositingUpdate = false;
+    }
+
     if (layer.isComposited())
         layer.backing()->updateAllowsBackingStoreDetaching(layerExtent.bounds);
 
@@ -1174,6 +1206,9 @@ void RenderLayerCompositor::traverseUnchangedSubtree(RenderLayer* ancestorLayer,
 
     LOG_WITH_STREAM(Compositing, stream << TextStream::Repeat(compositingState.depth * 2, ' ') << &layer << (layer.isNormalFlowOnly() ? " n" : " s") << " traverseUnchangedSubtree");
 
+    ++m_compositingRequirementsVisitedLayerCount;
+    unsigned firstOverlapMapChange = overlapMap.changeLog().changes.size();
+
     bool layerIsComposited = layer.isComposited();
     bool layerPaintsIntoProvidedBacking = false;
     bool didPushOverlapContainer = false;
@@ -1185,8 +1220,11 @@ void RenderLayerCompositor::traverseUnchangedSubtree(RenderLayer* ancestorLayer,
     bool respectTransforms = !layerExtent.hasTransformAnimation;
     overlapMap.geometryMap().pushMappingsToAncestor(&layer, ancestorLayer, respectTransforms);
 
+    // The extent is only needed for the rect the layer adds to the overlap map, which can be copied from the previous traversal.
+    bool reusesPreviousOverlapMapAdd = canReusePreviousOverlapMapAdd(layer, layerExtent);
+
     // If we know for sure the layer is going to be composited, don't bother looking it up in the overlap map
-    if (!layerIsComposited && !overlapMap.isEmpty() && compositingState.testingOverlap)
+    if (!layerIsComposited && !overlapMap.isEmpty() && compositingState.testingOverlap && !reusesPreviousOverlapMapAdd)
         computeExtent(overlapMap, layer, layerExtent);
 
     if (layer.paintsIntoProvidedBacking()) {
@@ -1209,7 +1247,8 @@ void RenderLayerCompositor::traverseUnchangedSubtree(RenderLayer* ancestorLayer,
         didPushOverlapContainer = true;
         LOG_WITH_STREAM(CompositingOverlap, stream << "unchangedSubtree: layer " << &layer << " will composite, pushed container " << overlapMap);
 
-        computeExtent(overlapMap, layer, layerExtent);
+        if (!reusesPreviousOverlapMapAdd)
+            computeExtent(overlapMap, layer, layerExtent);
         currentState.ancestorHasTransformAnimation |= layerExtent.hasTransformAnimation;
         // Too hard to compute animated bounds if both us and some ancestor is animating transform.
         layerExtent.animationCausesExtentUncertainty |= layerExtent.hasTransformAnimation && compositingState.ancestorHasTransformAnimation;
@@ -1251,13 +1290,87 @@ void RenderLayerCompositor::traverseUnchangedSubtree(RenderLayer* ancestorLayer,
     backingSharingState.updateAfterDescendantTraversal(layer, compositingState.stackingContextAncestor);
 
     bool layerContributesToOverlap = (currentState.compositingAncestor && !currentState.compositingAncestor->isRenderViewLayer()) || currentState.backingSharingAncestor;
+    unsigned ownOverlapMapChange = overlapMap.changeLog().changes.size();
+    if (layerContributesToOverlap && reusesPreviousOverlapMapAdd && overlapMap.addFromPreviousChange(layer, m_previousOverlapMapChangeLog, layer.compositingRequirementsContribution().ownOverlapMapChange)) {
+        LOG_WITH_STREAM(CompositingOverlap, stream << "unchangedSubtree: layer " << &layer << " contributes to overlap, added its previous rect to map " << overlapMap);
+        layerContributesToOverlap = false;
+    }
     updateOverlapMap(overlapMap, layer, layerExtent, didPushOverlapContainer, layerContributesToOverlap);
 
+    layer.setCompositingRequirementsContribution(compositingRequirementsContribution(layer, overlapMap, firstOverlapMapChange, ownOverlapMapChange, currentState, layerExtent, backingSharingState, anyDescendantHas3DTransform));
+
     overlapMap.geometryMap().popMappingsToAncestor(ancestorLayer);
 
     ASSERT(!layer.needsCompositingRequirementsTraversal());
 }
 
+RenderLayer::CompositingRequirementsContribution RenderLayerCompositor::compositingRequirementsContribution(const RenderLayer& layer, const LayerOverlapMap& overlapMap, unsigned firstOverlapMapChange, unsigned ownOverlapMapChange, const CompositingState& descendantState, const OverlapExtent& layerExtent, const BackingSharingState& backingSharingState, bool anyDescendantHas3DTransform) const
+{
+    // Everything a layer subtree passes on to the layers after it: the changes it made to the overlap map, the state
+    // merged into the parent's CompositingState by updateWithDescendantStateAndLayer(), and the backing sharing state.
+    RenderLayer::CompositingRequirementsContribution contribution;
+    contribution.traversalIdentifier = m_compositingRequirementsTraversalIdentifier;
+    contribution.firstOverlapMapChange = firstOverlapMapChange;
+    contribution.overlapMapChangeCount = overlapMap.changeLog().changes.size() - firstOverlapMapChange;
+    // The layer's own rect, if it added one, is the first change made once its descendants are done.
+    auto& changes = overlapMap.changeLog().changes;
+    if (ownOverlapMapChange < changes.size() && changes[ownOverlapMapChange].type == LayerOverlapMap::Change::Type::Add && changes[ownOverlapMapChange].layer.get() == &layer)
+        contribution.ownOverlapMapChange = ownOverlapMapChange;
+    contribution.backingProviderCandidate = makeWeakPtr(backingSharingState.backingProviderCandidate());
+    contribution.isComposited = layer.isComposited();
+    contribution.paintsIntoProvidedBacking = layer.paintsIntoProvidedBacking();
+    contribution.has3DTransform = anyDescendantHas3DTransform || layer.has3DTransform();
+    contribution.subtreeIsCompositing = descendantState.subtreeIsCompositing;
+    contribution.testingOverlap = descendantState.testingOverlap;
+    contribution.hasCompositedNonContainedDescendants = descendantState.hasCompositedNonContainedDescendants;
+#if ENABLE(CSS_COMPOSITING)
+    contribution.hasNotIsolatedCompositedBlendingDescendants = descendantState.hasNotIsolatedCompositedBlendingDescendants;
+#endif
+    contribution.hasExtentUncertainty = layerExtent.knownToBeHaveExtentUncertainty();
+    return contribution;
+}
+
+bool RenderLayerCompositor::isSameCompositingRequirementsContribution(const RenderLayer::CompositingRequirementsContribution& previous, const RenderLayer::CompositingRequirementsContribution& current, const LayerOverlapMap& overlapMap) const
+{
+    // The previous contribution is only known if the layer was visited by the previous traversal, whose overlap map changes we kept.
+    if (!previous.traversalIdentifier || previous.traversalIdentifier + 1 != current.traversalIdentifier)
+        return false;
+
+    if (previous.backingProviderCandidate.get() != current.backingProviderCandidate.get()
+        || previous.isComposited != current.isComposited
+        || previous.paintsIntoProvidedBacking != current.paintsIntoProvidedBacking
+        || previous.has3DTransform != current.has3DTransform
+        || previous.subtreeIsCompositing != current.subtreeIsCompositing
+        || previous.testingOverlap != current.testingOverlap
+        || previous.hasCompositedNonContainedDescendants != current.hasCompositedNonContainedDescendants
+        || previous.hasNotIsolatedCompositedBlendingDescendants != current.hasNotIsolatedCompositedBlendingDescendants
+        || previous.hasExtentUncertainty != current.hasExtentUncertainty)
+        return false;
+
+    if (previous.overlapMapChangeCount != current.overlapMapChangeCount)
+        return false;
+    ASSERT(previous.firstOverlapMapChange + previous.overlapMapChangeCount <= m_previousOverlapMapChangeLog.changes.size());
+    auto& changeLog = overlapMap.changeLog();
+    for (unsigned i = 0; i < current.overlapMapChangeCount; ++i) {
+        if (!changeLog.isSameChange(current.firstOverlapMapChange + i, m_previousOverlapMapChangeLog, previous.firstOverlapMapChange + i))
+            return false;
+    }
+    return true;
+}
+
+bool RenderLayerCompositor::canReusePreviousOverlapMapAdd(const RenderLayer& layer, const OverlapExtent& layerExtent) const
+{
+    // Only clean layers get here. Their rect only depends on the geometry map and on their clips, which do not change
+    // unless layout, scrolling or zooming does. The bounds of a transform animation are recomputed, as they also set
+    // the extent uncertainty.
+    if (!m_overlapMapGeometryIsUnchanged || layerExtent.hasTransformAnimation)
+        return false;
+
+    auto& contribution = layer.compositingRequirementsContribution();
+    return contribution.traversalIdentifier && contribution.traversalIdentifier + 1 == m_compositingRequirementsTraversalIdentifier
+        && contribution.ownOverlapMapChange != RenderLayer::noOverlapMapChange;
+}
+
 void RenderLayerCompositor::updateBackingAndHierarchy(RenderLayer& layer, Vector<Ref<GraphicsLayer>>& childLayersOfEnclosingLayer, UpdateBackingTraversalState& traversalState, ScrollingTreeState& scrollingTreeState, OptionSet<UpdateLevel> updateLevel)
 {
     layer.updateDescendantDependentFlags();
@@ -29,6 +29,7 @@
 #include "GraphicsLayerClient.h"
 #include "GraphicsLayerUpdater.h"
 #include "LayerAncestorClippingStack.h"
+#include "LayerOverlapMap.h"
 #include "RenderLayer.h"
 #include <wtf/HashMap.h>
 #include <wtf/OptionSet.h>
@@ -38,7 +39,6 @@ namespace WebCore {
 class FixedPositionViewportConstraints;
 class GraphicsLayer;
 class GraphicsLayerUpdater;
-class LayerOverlapMap;
 class RenderEmbeddedObject;
 class RenderVideo;
 class RenderWidget;
@@ -386,6 +386,14 @@ public:
     void startTrackingCompositingUpdates() { m_compositingUpdateCount = 0; }
     unsigned compositingUpdateCount() const { return m_compositingUpdateCount; }
 
+    // For performance testing. Runs compositing updates that test every layer for overlap, with and without the overlap map's
+    // grid index, and reports the time per update.
+    String runOverlapMapBenchmark(unsigned iterations);
+
+    // Layers visited by the last compositing requirements traversal, and those of them whose requirements had to be recomputed.
+    unsigned compositingRequirementsVisitedLayerCount() const { return m_compositingRequirementsVisitedLayerCount; }
+    unsigned compositingRequirementsRecomputedLayerCount() const { return m_compositingRequirementsRecomputedLayerCount; }
+
 private:
     class BackingSharingState;
     struct CompositingState;
@@ -436,6 +444,9 @@ private:
 
     void computeCompositingRequirements(RenderLayer* ancestorLayer, RenderLayer&, LayerOverlapMap&, CompositingState&, BackingSharingState&, bool& descendantHas3DTransform);
     void traverseUnchangedSubtree(RenderLayer* ancestorLayer, RenderLayer&, LayerOverlapMap&, CompositingState&, BackingSharingState&, bool& descendantHas3DTransform);
+    RenderLayer::CompositingRequirementsContribution compositingRequirementsContribution(const RenderLayer&, const LayerOverlapMap&, unsigned firstOverlapMapChange, unsigned ownOverlapMapChange, const CompositingState& descendantState, const OverlapExtent&, const BackingSharingState&, bool anyDescendantHas3DTransform) const;
+    bool isSameCompositingRequirementsContribution(const RenderLayer::CompositingRequirementsContribution& previous, const RenderLayer::CompositingRequirementsContribution& current, const LayerOverlapMap&) const;
+    bool canReusePreviousOverlapMapAdd(const RenderLayer&, const OverlapExtent&) const;
 
     enum class UpdateLevel {
         AllDescendants          = 1 << 0,
@@ -594,6 +605,19 @@ private:
     unsigned m_layersWithTiledBackingCount { 0 };
     unsigned m_layerFlushCount { 0 };
     unsigned m_compositingUpdateCount { 0 };
+    unsigned m_compositingRequirementsVisitedLayerCount { 0 };
+    unsigned m_compositingRequirementsRecomputedLayerCount { 0 };
+    unsigned m_compositingRequirementsTraversalIdentifier { 0 };
+    // The overlap map changes of the current and of the last compositing requirements traversal, see
+    // RenderLayer::CompositingRequirementsContribution. They are swapped after each traversal.
+    LayerOverlapMap::ChangeLog m_overlapMapChangeLog;
+    LayerOverlapMap::ChangeLog m_previousOverlapMapChangeLog;
+    // What the overlap bounds of the layers depend on besides their own state, as of the last traversal. If none of it
+    // changed, clean layers add the same rects to the overlap map as they did then.
+    unsigned m_overlapMapLayoutCount { 0 };
+    ScrollPosition m_overlapMapScrollPosition;
+    float m_overlapMapPageScaleFactor { 1 };
+    bool m_overlapMapGeometryIsUnchanged { false };
 
     RootLayerAttachment m_rootLayerAttachment { RootLayerUnattached };
 
@@ -36,10 +36,31 @@
 #include "CachedSVGDocumentReference.h"
 #include "Logging.h"
 #include "RenderSVGResourceFilter.h"
+#include <wtf/ListHashSet.h>
 #include <wtf/NeverDestroyed.h>
 
 namespace WebCore {
 
+// The cached results of all layers share this budget, and the layers painted least recently lose
+// theirs first. A single result may only take a part of it, so that it does not evict all the others.
+static const size_t cachedResultsBudget = 64 * 1024 * 1024;
+static const size_t maximumCachedResultSize = cachedResultsBudget / 4;
+static size_t cachedResultsSize;
+
+static ListHashSet<RenderLayerFilters*>& layersWithCachedResult()
+{
+    static NeverDestroyed<ListHashSet<RenderLayerFilters*>> layers;
+    return layers;
+}
+
+// The content of a layer whose cached result is drawn is walked with this context, which draws
+// nothing, so that the layer fragments are still computed as usual.
+static GraphicsContext& paintingDisabledContext()
+{
+    static NeverDestroyed<GraphicsContext> context(GraphicsContext::PaintInvalidationReasons::None);
+    return context;
+}
+
 RenderLayerFilters::RenderLayerFilters(RenderLayer& layer)
     : m_layer(layer)
 {
@@ -48,11 +69,14 @@ RenderLayerFilters::RenderLayerFilters(RenderLayer& layer)
 RenderLayerFilters::~RenderLayerFilters()
 {
     removeReferenceFilterClients();
+    clearCachedResult();
 }
 
 void RenderLayerFilters::setFilter(RefPtr<CSSFilter>&& filter)
 {
     m_filter = WTFMove(filter);
+    ++m_sourceContentVersion;
+    clearCachedResult();
 }
 
 bool RenderLayerFilters::hasFilterThatMovesPixels() const
@@ -127,6 +151,13 @@ void RenderLayerFilters::buildFilter(RenderElement& renderer, float scaleFactor,
         m_filter->clearIntermediateResults();
     }
 
+    ++m_sourceContentVersion;
+    clearCachedResult();
+
+    // Reference filters can depend on content other than the layer, like an feImage, whose
+    // changes do not repaint the layer.
+    m_canCacheResult = !renderer.style().filter().hasReferenceFilter();
+
     // If the filter fails to build, remove it from the layer. It will still attempt to
     // go through regular processing (e.g. compositing), but never apply anything.
     // FIXME: this rebuilds the entire effects chain even if the filter style didn't change.
@@ -134,7 +165,59 @@ void RenderLayerFilters::buildFilter(RenderElement& renderer, float scaleFactor,
         m_filter = nullptr;
 }
 
-GraphicsContext* RenderLayerFilters::beginFilterEffect(GraphicsContext& destinationContext, const LayoutRect& filterBoxRect, const LayoutRect& dirtyRect, const LayoutRect& layerRepaintRect)
+bool RenderLayerFilters::canCacheResultForRect(const LayoutRect& rect) const
+{
+    if (ImageBuffer::sizeNeedsClamping(rect.size()))
+        return false;
+
+    float scale = m_filter->filterScale();
+    return rect.width().toDouble() * scale * rect.height().toDouble() * scale * 4 <= maximumCachedResultSize;
+}
+
+bool RenderLayerFilters::canUseCachedResultForRect(const LayoutRect& filterBoxRect) const
+{
+    ASSERT(m_cachedResult);
+    if (m_cachedResult->sourceContentVersion != m_sourceContentVersion || m_cachedResult->filterBoxSize != filterBoxRect.size())
+        return false;
+
+    // The output was snapped to device pixels where it was first drawn, so it can only be moved by
+    // whole device pixels without resampling it.
+    FloatSize offset = filterBoxRect.location() - m_cachedResult->paintOffset;
+    offset.scale(m_layer.renderer().document().deviceScaleFactor());
+    return offset.width() == std::round(offset.width()) && offset.height() == std::round(offset.height());
+}
+
+void RenderLayerFilters::setCachedResult(RefPtr<ImageBuffer>&& output, const LayoutRect& filterBoxRect, const LayoutRect& outputRect)
+{
+    clearCachedResult();
+
+    size_t memoryCost = output->memoryCost();
+    m_cachedResult = CachedResult { WTFMove(output), filterBoxRect.size(), filterBoxRect.location(), outputRect, m_paintedSourceContentVersion, memoryCost };
+    cachedResultsSize += memoryCost;
+    layersWithCachedResult().add(this);
+
+    while (cachedResultsSize > cachedResultsBudget)
+        layersWithCachedResult().first()->clearCachedResult();
+}
+
+void RenderLayerFilters::clearCachedResult()
+{
+    if (!m_cachedResult)
+        return;
+
+    cachedResultsSize -= m_cachedResult->memoryCost;
+    m_cachedResult = WTF::nullopt;
+    layersWithCachedResult().remove(this);
+}
+
+void RenderLayerFilters::clearAllCachedResults()
+{
+    auto& layers = layersWithCachedResult();
+    while (!layers.isEmpty())
+        layers.first()->clearCachedResult();
+}
+
+GraphicsContext* RenderLayerFilters::beginFilterEffect(GraphicsContext& destinationContext, const LayoutRect& filterBoxRect, const LayoutRect& dirtyRect, const LayoutRect& layerRepaintRect, OptionSet<PaintBehavior> paintBehavior)
 {
     if (!m_filter)
         return nullptr;
@@ -144,6 +227,38 @@ GraphicsContext* RenderLayerFilters::beginFilterEffect(GraphicsContext& destinat
     if (filterSourceRect.isEmpty())
         return nullptr;
 
+    // Painting with other behaviors, like for a selection-only snapshot, paints other content.
+    if (paintBehavior != m_paintBehavior) {
+        m_paintBehavior = paintBehavior;
+        ++m_sourceContentVersion;
+    }
+
+    m_paintedSourceContentVersion = m_sourceContentVersion;
+    m_filterBoxRect = filterBoxRect;
+    m_shouldCacheResult = false;
+    m_usesCachedResult = false;
+
+    if (m_cachedResult && !canUseCachedResultForRect(filterBoxRect))
+        clearCachedResult();
+
+    if (m_cachedResult) {
+        m_cachedResultOffset = filterBoxRect.location() - m_cachedResult->paintOffset;
+        // The source image is left as it is, since the content it holds did not change.
+        m_usesCachedResult = true;
+        m_repaintRect = intersection(dirtyRect, filterSourceRect);
+        resetDirtySourceRect();
+        layersWithCachedResult().appendOrMoveToLast(this);
+        return &paintingDisabledContext();
+    }
+
+    // Only filters that move pixels get the repaints of the layer content, through expandDirtySourceRect().
+    // If nothing was repainted since the filter last ran, the content is likely static, so run the filter
+    // over the whole filter box once and keep its result for the next paints of any part of the layer.
+    if (m_canCacheResult && filter.hasFilterThatMovesPixels() && m_appliedSourceContentVersion == m_sourceContentVersion && canCacheResultForRect(filterBoxRect)) {
+        filterSourceRect = filterBoxRect;
+        m_shouldCacheResult = true;
+    }
+
     bool hasUpdatedBackingStore = filter.updateBackingStoreRect(filterSourceRect);
     if (!filter.hasFilterThatMovesPixels())
         m_repaintRect = dirtyRect;
@@ -177,6 +292,14 @@ GraphicsContext* RenderLayerFilters::beginFilterEffect(GraphicsContext& destinat
 
 void RenderLayerFilters::applyFilterEffect(GraphicsContext& destinationContext)
 {
+    if (m_usesCachedResult) {
+        LOG_WITH_STREAM(Filters, stream << "RenderLayerFilters " << this << " applyFilterEffect using the cached result");
+        auto outputRect = m_cachedResult->outputRect;
+        outputRect.move(m_cachedResultOffset);
+        destinationContext.drawImageBuffer(*m_cachedResult->output, snapRectToDevicePixels(outputRect, m_layer.renderer().document().deviceScaleFactor()));
+        return;
+    }
+
     ASSERT(m_filter->inputContext());
 
     LOG_WITH_STREAM(Filters, stream << "\nRenderLayerFilters " << this << " applyFilterEffect");
@@ -190,9 +313,15 @@ void RenderLayerFilters::applyFilterEffect(GraphicsContext& destinationContext)
     LayoutRect destRect = filter.outputRect();
     destRect.move(m_paintOffset.x(), m_paintOffset.y());
 
-    if (auto* outputBuffer = filter.output())
+    if (auto* outputBuffer = filter.output()) {
         destinationContext.drawImageBuffer(*outputBuffer, snapRectToDevicePixels(destRect, m_layer.renderer().document().deviceScaleFactor()));
 
+        // The content may have been repainted while it was painted into the source image.
+        if (m_shouldCacheResult && m_paintedSourceContentVersion == m_sourceContentVersion)
+            setCachedResult(outputBuffer, m_filterBoxRect, destRect);
+    }
+    m_appliedSourceContentVersion = m_paintedSourceContentVersion;
+
     filter.clearIntermediateResults();
 
     LOG_WITH_STREAM(Filters, stream << "RenderLayerFilters " << this << " applyFilterEffect done\n");
@@ -39,6 +39,7 @@ namespace WebCore {
 class CachedSVGDocument;
 class Element;
 class FilterOperations;
+class ImageBuffer;
 
 class RenderLayerFilters final : private CachedSVGDocumentClient {
     WTF_MAKE_FAST_ALLOCATED;
@@ -47,7 +48,11 @@ public:
     virtual ~RenderLayerFilters();
 
     const LayoutRect& dirtySourceRect() const { return m_dirtySourceRect; }
-    void expandDirtySourceRect(const LayoutRect& rect) { m_dirtySourceRect.unite(rect); }
+    void expandDirtySourceRect(const LayoutRect& rect)
+    {
+        m_dirtySourceRect.unite(rect);
+        ++m_sourceContentVersion;
+    }
 
     CSSFilter* filter() const { return m_filter.get(); }
     void setFilter(RefPtr<CSSFilter>&&);
@@ -63,13 +68,23 @@ public:
     // Per render
     LayoutRect repaintRect() const { return m_repaintRect; }
 
-    GraphicsContext* beginFilterEffect(GraphicsContext& destinationContext, const LayoutRect& filterBoxRect, const LayoutRect& dirtyRect, const LayoutRect& layerRepaintRect);
+    GraphicsContext* beginFilterEffect(GraphicsContext& destinationContext, const LayoutRect& filterBoxRect, const LayoutRect& dirtyRect, const LayoutRect& layerRepaintRect, OptionSet<PaintBehavior>);
     void applyFilterEffect(GraphicsContext& destinationContext);
 
+    static void clearAllCachedResults();
+
+    // Times the filters of the boxes in the render view, each over its whole filter box, and reports the time per filter and per pixel.
+    static String runFilterBenchmark(RenderView&, unsigned iterations);
+
 private:
     void notifyFinished(CachedResource&, const NetworkLoadMetrics&) final;
     void resetDirtySourceRect() { m_dirtySourceRect = LayoutRect(); }
 
+    bool canCacheResultForRect(const LayoutRect&) const;
+    bool canUseCachedResultForRect(const LayoutRect& filterBoxRect) const;
+    void setCachedResult(RefPtr<ImageBuffer>&&, const LayoutRect& filterBoxRect, const LayoutRect& outputRect);
+    void clearCachedResult();
+
     RenderLayer& m_layer;
 
     Vector<RefPtr<Element>> m_internalSVGReferences;
@@ -77,10 +92,35 @@ private:
 
     RefPtr<CSSFilter> m_filter;
     LayoutRect m_dirtySourceRect;
+
+    // Incremented whenever the content painted into the source image or the filter may have changed.
+    unsigned m_sourceContentVersion { 1 };
+    unsigned m_appliedSourceContentVersion { 0 };
+    OptionSet<PaintBehavior> m_paintBehavior;
+    bool m_canCacheResult { false };
+
+    // The output of the filter run over the whole filter box, drawn again instead of running the
+    // filter as long as neither the source content version nor the size of the filter box change.
+    // The layer may be painted at another offset, for instance when an ancestor scrolls, in which
+    // case the output is drawn translated by the change in offset.
+    struct CachedResult {
+        RefPtr<ImageBuffer> output;
+        LayoutSize filterBoxSize;
+        LayoutPoint paintOffset;
+        LayoutRect outputRect;
+        unsigned sourceContentVersion;
+        size_t memoryCost;
+    };
+    Optional<CachedResult> m_cachedResult;
     
     // Data used per paint
     LayoutPoint m_paintOffset;
     LayoutRect m_repaintRect;
+    LayoutRect m_filterBoxRect;
+    LayoutSize m_cachedResultOffset;
+    unsigned m_paintedSourceContentVersion { 0 };
+    bool m_shouldCacheResult { false };
+    bool m_usesCachedResult { false };
 };
 
 } // namespace WebCore
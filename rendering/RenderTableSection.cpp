@@ -53,6 +53,9 @@ WTF_MAKE_ISO_ALLOCATED_IMPL(RenderTableSection);
 static const unsigned gMinTableSizeToUseFastPaintPathWithOverflowingCell = 75 * 75;
 static const float gMaxAllowedOverflowingCellRatioForFastPaintPath = 0.1f;
 
+// Shorter sections are always laid out in full, see Settings::lazyLayoutEnabled.
+static const unsigned gMinRowCountForLazyLayout = 200;
+
 static inline void setRowLogicalHeightToRowStyleLogicalHeightIfNotRelative(RenderTableSection::RowStruct& row)
 {
     ASSERT(row.rowRenderer);
@@ -119,6 +122,10 @@ void RenderTableSection::willBeRemovedFromTree()
     // Preventively invalidate our cells as we may be re-inserted into
     // a new table which would require us to rebuild our structure.
     setNeedsCellRecalc();
+
+    // Rows that skipped their layout stay skipped until our next layout, wherever we get inserted.
+    if (m_hasDeferredRows)
+        view().frameView().layoutContext().clearDeferredLayoutRanges(*this);
 }
 
 void RenderTableSection::willInsertTableRow(RenderTableRow& child, RenderObject* beforeChild)
@@ -242,6 +249,10 @@ LayoutUnit RenderTableSection::calcRowLogicalHeight()
 
     for (unsigned r = 0; r < totalRows; r++) {
         m_grid[r].baseline = 0;
+        if (isRowLayoutDeferred(r)) {
+            m_rowPos[r + 1] = m_rowPos[r] + std::max(resolveLogicalHeightForRow(m_grid[r].logicalHeight), m_estimatedRowLogicalHeight) + table()->vBorderSpacing();
+            continue;
+        }
         LayoutUnit baselineDescent;
 
         // Our base size is the biggest logical height from our cells' styles (excluding row spanning cells).
@@ -341,7 +352,18 @@ void RenderTableSection::layout()
     bool paginated = view().frameView().layoutContext().layoutState()->isPaginated();
     
     const Vector<LayoutUnit>& columnPos = table()->columnPositions();
-    
+
+    // Lazy layout: dirty rows far from the visible rect skip their layout. Their position is estimated using the precisely
+    // laid out rows, and the section gets laid out again when they get close to the visible rect.
+    auto& layoutContext = view().frameView().layoutContext();
+    auto lazyLayoutRect = !paginated && m_grid.size() >= gMinRowCountForLazyLayout ? layoutContext.lazyLayoutRect(*this) : WTF::nullopt;
+    auto rowLogicalTop = table()->vBorderSpacing();
+    LayoutUnit preciseRowsLogicalHeight;
+    unsigned preciseRowCount = 0;
+    // Rows skipped by a previous layout need to be laid out again once they are not deferred anymore.
+    bool mayHaveSkippedRows = m_hasDeferredRows;
+    m_hasDeferredRows = false;
+
     for (unsigned r = 0; r < m_grid.size(); ++r) {
         Row& row = m_grid[r].row;
         unsigned cols = row.size();
@@ -364,16 +386,100 @@ void RenderTableSection::layout()
             cell->setCellLogicalWidth(tableLayoutLogicalWidth);
         }
 
+        if (lazyLayoutRect && canDeferLayoutOfRow(r)) {
+            auto estimatedRowLogicalHeight = preciseRowCount ? preciseRowsLogicalHeight / preciseRowCount : m_estimatedRowLogicalHeight;
+            auto& rowRenderer = *m_grid[r].rowRenderer;
+            // Dirty content (including new content in an already skipped row) is checked before its layout gets skipped.
+            if ((rowLogicalTop >= lazyLayoutRect->maxY() || rowLogicalTop + estimatedRowLogicalHeight <= lazyLayoutRect->y())
+                && (!rowRenderer.needsLayout() || FrameViewLayoutContext::canSkipLayoutOfSubtree(rowRenderer))) {
+                if (rowRenderer.needsLayout())
+                    layoutContext.skipLayoutOfSubtree(rowRenderer);
+                m_hasDeferredRows = true;
+                rowLogicalTop += estimatedRowLogicalHeight + table()->vBorderSpacing();
+                continue;
+            }
+        }
+
         if (RenderTableRow* rowRenderer = m_grid[r].rowRenderer) {
-            if (!rowRenderer->needsLayout() && paginated && view().frameView().layoutContext().layoutState()->pageLogicalHeightChanged())
+            if (mayHaveSkippedRows)
+                layoutContext.markSkippedSubtreeForLayout(*rowRenderer);
+            if (!rowRenderer->needsLayout() && paginated && layoutContext.layoutState()->pageLogicalHeightChanged())
                 rowRenderer->setChildNeedsLayout(MarkOnlyThis);
 
             rowRenderer->layoutIfNeeded();
         }
+
+        if (lazyLayoutRect) {
+            LayoutUnit rowLogicalHeight = resolveLogicalHeightForRow(m_grid[r].logicalHeight);
+            for (auto& current : row) {
+                auto* cell = current.primaryCell();
+                if (cell && !current.inColSpan && cell->rowSpan() == 1)
+                    rowLogicalHeight = std::max(rowLogicalHeight, cell->logicalHeightForRowSizing());
+            }
+            preciseRowsLogicalHeight += rowLogicalHeight;
+            ++preciseRowCount;
+            rowLogicalTop += rowLogicalHeight + table()->vBorderSpacing();
+        }
     }
+    if (preciseRowCount)
+        m_estimatedRowLogicalHeight = preciseRowsLogicalHeight / preciseRowCount;
     clearNeedsLayout();
 }
 
+bool RenderTableSection::canDeferLayoutOfRow(unsigned rowIndex) const
+{
+    // The first row is always laid out so that the section has a baseline and an estimate for the deferred rows.
+    if (!rowIndex)
+        return false;
+    // Rows that are already laid out don't need to be deferred.
+    auto* rowRenderer = m_grid[rowIndex].rowRenderer;
+    if (!rowRenderer || rowRenderer->hasLayer() || (!rowRenderer->needsLayout() && !view().frameView().layoutContext().isLayoutOfSubtreeSkipped(*rowRenderer)))
+        return false;
+    // Row spanning cells and cells painted through layers need precise geometry.
+    for (auto& current : m_grid[rowIndex].row) {
+        if (current.cells.size() > 1)
+            return false;
+        auto* cell = current.primaryCell();
+        if (cell && (cell->rowSpan() != 1 || cell->rowIndex() != rowIndex || cell->hasLayer()))
+            return false;
+    }
+    return true;
+}
+
+bool RenderTableSection::isRowLayoutDeferred(unsigned rowIndex) const
+{
+    if (!m_hasDeferredRows)
+        return false;
+    auto* rowRenderer = m_grid[rowIndex].rowRenderer;
+    return rowRenderer && view().frameView().layoutContext().isLayoutOfSubtreeSkipped(*rowRenderer);
+}
+
+void RenderTableSection::updateDeferredLayoutRanges()
+{
+    auto& layoutContext = view().frameView().layoutContext();
+    if (!m_hasDeferredRows) {
+        layoutContext.clearDeferredLayoutRanges(*this);
+        return;
+    }
+
+    Vector<FrameViewLayoutContext::DeferredLayoutRange> deferredRanges;
+    for (unsigned r = 0; r < m_grid.size(); ++r) {
+        if (!isRowLayoutDeferred(r))
+            continue;
+        if (!deferredRanges.isEmpty() && deferredRanges.last().logicalBottom == m_rowPos[r]) {
+            deferredRanges.last().logicalBottom = m_rowPos[r + 1];
+            continue;
+        }
+        deferredRanges.append({ m_rowPos[r], m_rowPos[r + 1] });
+    }
+    if (deferredRanges.isEmpty()) {
+        m_hasDeferredRows = false;
+        layoutContext.clearDeferredLayoutRanges(*this);
+        return;
+    }
+    layoutContext.setDeferredLayoutRanges(*this, WTFMove(deferredRanges));
+}
+
 void RenderTableSection::distributeExtraLogicalHeightToPercentRows(LayoutUnit& extraLogicalHeight, int totalPercent)
 {
     if (!totalPercent)
@@ -564,6 +670,9 @@ void RenderTableSection::layoutRows()
             rowRenderer->addVisualEffectOverflow();
         }
 
+        if (isRowLayoutDeferred(r))
+            continue;
+
         LayoutUnit rowHeightIncreaseForPagination;
 
         for (unsigned c = 0; c < nEffCols; c++) {
@@ -627,6 +736,8 @@ void RenderTableSection::layoutRows()
     setLogicalHeight(m_rowPos[totalRows]);
 
     computeOverflowFromCells(totalRows, nEffCols);
+
+    updateDeferredLayoutRanges();
 }
 
 void RenderTableSection::computeOverflowFromCells()
@@ -648,6 +759,8 @@ void RenderTableSection::computeOverflowFromCells(unsigned totalRows, unsigned n
 #endif
     // Now that our height has been determined, add in overflow from cells.
     for (unsigned r = 0; r < totalRows; r++) {
+        if (isRowLayoutDeferred(r))
+            continue;
         for (unsigned c = 0; c < nEffCols; c++) {
             CellStruct& cs = cellAt(r, c);
             RenderTableCell* cell = cs.primaryCell();
@@ -933,6 +1046,9 @@ static inline bool compareCellPositionsWithOverflowingCells(RenderTableCell* ele
 
 void RenderTableSection::paintCell(RenderTableCell* cell, PaintInfo& paintInfo, const LayoutPoint& paintOffset)
 {
+    if (isRowLayoutDeferred(cell->rowIndex()))
+        return;
+
     LayoutPoint cellPoint = flipForWritingModeForChild(cell, paintOffset);
     PaintPhase paintPhase = paintInfo.phase;
     RenderTableRow& row = downcast<RenderTableRow>(*cell->parent());
@@ -1460,6 +1576,8 @@ bool RenderTableSection::nodeAtPoint(const HitTestRequest& request, HitTestResul
 
     if (hasOverflowingCell()) {
         for (RenderTableRow* row = lastRow(); row; row = row->previousRow()) {
+            if (isRowLayoutDeferred(row->rowIndex()))
+                continue;
             // FIXME: We have to skip over inline flows, since they can show up inside table rows
             // at the moment (a demoted inline <form> for example). If we ever implement a
             // table-specific hit-test method (which we should do for performance reasons anyway),
@@ -1486,6 +1604,8 @@ bool RenderTableSection::nodeAtPoint(const HitTestRequest& request, HitTestResul
 
     // Now iterate over the spanned rows and columns.
     for (unsigned hitRow = rowSpan.start; hitRow < rowSpan.end; ++hitRow) {
+        if (isRowLayoutDeferred(hitRow))
+            continue;
         for (unsigned hitColumn = columnSpan.start; hitColumn < columnSpan.end; ++hitColumn) {
             CellStruct& current = cellAt(hitRow, hitColumn);
 
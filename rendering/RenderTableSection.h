@@ -214,6 +214,11 @@ private:
 
     void setLogicalPositionForCell(RenderTableCell*, unsigned effectiveColumn) const;
 
+    bool canDeferLayoutOfRow(unsigned row) const;
+    // Lazy layout skipped this row. Its height is estimated and its cells are neither painted nor hit tested.
+    bool isRowLayoutDeferred(unsigned row) const;
+    void updateDeferredLayoutRanges();
+
     void firstChild() const = delete;
     void lastChild() const = delete;
 
@@ -229,6 +234,9 @@ private:
     LayoutUnit m_outerBorderBefore;
     LayoutUnit m_outerBorderAfter;
 
+    // Average height of the precisely laid out rows, used as the height of the rows with deferred layout.
+    LayoutUnit m_estimatedRowLogicalHeight;
+
     // This HashSet holds the overflowing cells for faster painting.
     // If we have more than gMaxAllowedOverflowingCellRatio * total cells, it will be empty
     // and m_forceSlowPaintPathWithOverflowingCell will be set to save memory.
@@ -241,6 +249,7 @@ private:
     bool m_forceSlowPaintPathWithOverflowingCell { false };
     bool m_hasMultipleCellLevels { false };
     bool m_needsCellRecalc  { false };
+    bool m_hasDeferredRows { false };
 };
 
 inline const BorderValue& RenderTableSection::borderAdjoiningTableStart() const
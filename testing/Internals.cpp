@@ -59,10 +59,12 @@
 #include "DOMStringList.h"
 #include "DOMURL.h"
 #include "DOMWindow.h"
+#include "DecodedImageCache.h"
 #include "DeprecatedGlobalSettings.h"
 #include "DiagnosticLoggingClient.h"
 #include "DisabledAdaptations.h"
 #include "DisplayList.h"
+#include "DisplayListWireFormat.h"
 #include "Document.h"
 #include "DocumentLoader.h"
 #include "DocumentMarkerController.h"
@@ -85,6 +87,7 @@
 #include "FullscreenManager.h"
 #include "GCObservation.h"
 #include "GridPosition.h"
+#include "GridTrackSizingAlgorithm.h"
 #include "HEVCUtilities.h"
 #include "HTMLAnchorElement.h"
 #include "HTMLAttachmentElement.h"
@@ -156,8 +159,10 @@
 #include "Range.h"
 #include "ReadableStream.h"
 #include "RenderEmbeddedObject.h"
+#include "RenderFlexibleBox.h"
 #include "RenderLayerBacking.h"
 #include "RenderLayerCompositor.h"
+#include "RenderLayerFilters.h"
 #include "RenderListBox.h"
 #include "RenderMenuList.h"
 #include "RenderTheme.h"
@@ -237,6 +242,10 @@
 #include <wtf/dtoa.h>
 #endif
 
+#if ENABLE(LAYOUT_FORMATTING_CONTEXT)
+#include "LayoutContext.h"
+#endif
+
 #if ENABLE(LEGACY_ENCRYPTED_MEDIA)
 #include "LegacyCDM.h"
 #include "LegacyMockCDM.h"
@@ -516,6 +525,7 @@ void Internals::resetToConsistentState(Page& page)
         page.mainFrame().editor().toggleOverwriteModeEnabled();
     page.mainFrame().loader().clearTestingOverrides();
     page.applicationCacheStorage().setDefaultOriginQuota(ApplicationCacheStorage::noQuota());
+    DecodedImageCache::singleton().setCapacity(DecodedImageCache::defaultCapacity);
 #if ENABLE(VIDEO)
     page.group().captionPreferences().setTestingMode(true);
     page.group().captionPreferences().setCaptionDisplayMode(CaptionUserPreferences::ForcedOnly);
@@ -894,6 +904,32 @@ unsigned Internals::memoryCacheSize() const
     return MemoryCache::singleton().size();
 }
 
+unsigned Internals::decodedImageCacheSize() const
+{
+    return DecodedImageCache::singleton().statistics().size;
+}
+
+unsigned Internals::decodedImageCacheHitCount() const
+{
+    return DecodedImageCache::singleton().statistics().hitCount;
+}
+
+unsigned Internals::decodedImageCacheMissCount() const
+{
+    return DecodedImageCache::singleton().statistics().missCount;
+}
+
+void Internals::setDecodedImageCacheCapacity(unsigned capacity)
+{
+    DecodedImageCache::singleton().setCapacity(capacity);
+}
+
+void Internals::clearDecodedImageCache()
+{
+    DecodedImageCache::singleton().clear();
+    DecodedImageCache::singleton().resetStatistics();
+}
+
 static Image* imageFromImageElement(HTMLImageElement& element)
 {
     auto* cachedImage = element.cachedImage();
@@ -967,6 +1003,24 @@ unsigned Internals::imageDecodeCount(HTMLImageElement& element)
     return bitmapImage ? bitmapImage->decodeCountForTesting() : 0;
 }
 
+ExceptionOr<String> Internals::animatedImageMemoryBenchmark(HTMLImageElement& element, unsigned framesToShow)
+{
+    auto* bitmapImage = bitmapImageFromImageElement(element);
+    if (!bitmapImage)
+        return Exception { InvalidAccessError };
+
+    return bitmapImage->runAnimationMemoryBenchmark(framesToShow);
+}
+
+ExceptionOr<String> Internals::imageDecodingBenchmark(HTMLImageElement& element, unsigned iterations)
+{
+    auto* bitmapImage = bitmapImageFromImageElement(element);
+    if (!bitmapImage)
+        return Exception { InvalidAccessError };
+
+    return bitmapImage->runDecodingBenchmark(iterations);
+}
+
 unsigned Internals::pdfDocumentCachingCount(HTMLImageElement& element)
 {
 #if USE(CG)
@@ -3517,6 +3571,34 @@ ExceptionOr<unsigned> Internals::compositingUpdateCount()
     return document->renderView()->compositor().compositingUpdateCount();
 }
 
+ExceptionOr<unsigned> Internals::compositingRequirementsVisitedLayerCount()
+{
+    Document* document = contextDocument();
+    if (!document || !document->renderView())
+        return Exception { InvalidAccessError };
+
+    return document->renderView()->compositor().compositingRequirementsVisitedLayerCount();
+}
+
+ExceptionOr<unsigned> Internals::compositingRequirementsRecomputedLayerCount()
+{
+    Document* document = contextDocument();
+    if (!document || !document->renderView())
+        return Exception { InvalidAccessError };
+
+    return document->renderView()->compositor().compositingRequirementsRecomputedLayerCount();
+}
+
+ExceptionOr<String> Internals::overlapMapBenchmark(unsigned iterations)
+{
+    Document* document = contextDocument();
+    if (!document || !document->renderView())
+        return Exception { InvalidAccessError };
+
+    document->updateLayoutIgnorePendingStylesheets();
+    return document->renderView()->compositor().runOverlapMapBenchmark(iterations);
+}
+
 ExceptionOr<void> Internals::startTrackingRenderingUpdates()
 {
     Document* document = contextDocument();
@@ -3611,6 +3693,78 @@ unsigned Internals::layoutCount() const
     return document->view()->layoutContext().layoutCount();
 }
 
+unsigned Internals::gridItemLayoutCountDuringTrackSizing() const
+{
+    return GridTrackSizingAlgorithm::itemLayoutCountDuringTrackSizing();
+}
+
+unsigned Internals::gridIntrinsicLogicalHeightCacheHitCount() const
+{
+    return GridTrackSizingAlgorithm::intrinsicLogicalHeightCacheHitCount();
+}
+
+void Internals::resetGridTrackSizingCounters()
+{
+    GridTrackSizingAlgorithm::resetTrackSizingCounters();
+}
+
+unsigned Internals::flexItemMeasureLayoutCount() const
+{
+    return RenderFlexibleBox::itemMeasureLayoutCount();
+}
+
+unsigned Internals::flexItemMeasureCacheHitCount() const
+{
+    return RenderFlexibleBox::itemMeasureCacheHitCount();
+}
+
+void Internals::resetFlexItemMeasureCounters()
+{
+    RenderFlexibleBox::resetItemMeasureCounters();
+}
+
+ExceptionOr<String> Internals::nestedFlexBenchmark(unsigned iterations)
+{
+    Document* document = contextDocument();
+    if (!document || !document->renderView())
+        return Exception { InvalidAccessError };
+
+    document->updateLayoutIgnorePendingStylesheets();
+    return RenderFlexibleBox::runNestedFlexBenchmark(*document->renderView(), iterations);
+}
+
+#if ENABLE(LAYOUT_FORMATTING_CONTEXT)
+ExceptionOr<String> Internals::layoutFormattingContextBenchmark(unsigned iterations)
+{
+    Document* document = contextDocument();
+    if (!document || !document->renderView())
+        return Exception { InvalidAccessError };
+
+    document->updateLayoutIgnorePendingStylesheets();
+    return Layout::LayoutContext::runLayoutBenchmark(*document->renderView(), iterations);
+}
+#endif
+
+ExceptionOr<String> Internals::filterBenchmark(unsigned iterations)
+{
+    Document* document = contextDocument();
+    if (!document || !document->renderView())
+        return Exception { InvalidAccessError };
+
+    document->updateLayoutIgnorePendingStylesheets();
+    return RenderLayerFilters::runFilterBenchmark(*document->renderView(), iterations);
+}
+
+String Internals::displayListWireFormatBenchmark(unsigned iterations)
+{
+    return DisplayList::runWireFormatBenchmark(iterations);
+}
+
+String Internals::displayListWireFormatFuzz(unsigned iterations, unsigned seed)
+{
+    return DisplayList::runWireFormatFuzzer(iterations, seed);
+}
+
 #if !PLATFORM(IOS_FAMILY)
 static const char* cursorTypeToString(Cursor::Type cursorType)
 {
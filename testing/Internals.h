@@ -182,6 +182,12 @@ public:
     void destroyDecodedDataForAllImages();
     unsigned memoryCacheSize() const;
 
+    unsigned decodedImageCacheSize() const;
+    unsigned decodedImageCacheHitCount() const;
+    unsigned decodedImageCacheMissCount() const;
+    void setDecodedImageCacheCapacity(unsigned);
+    void clearDecodedImageCache();
+
     unsigned imageFrameIndex(HTMLImageElement&);
     unsigned imageFrameCount(HTMLImageElement&);
     float imageFrameDurationAtIndex(HTMLImageElement&, unsigned index);
@@ -191,6 +197,8 @@ public:
     unsigned imagePendingDecodePromisesCountForTesting(HTMLImageElement&);
     void setClearDecoderAfterAsyncFrameRequestForTesting(HTMLImageElement&, bool enabled);
     unsigned imageDecodeCount(HTMLImageElement&);
+    ExceptionOr<String> animatedImageMemoryBenchmark(HTMLImageElement&, unsigned framesToShow);
+    ExceptionOr<String> imageDecodingBenchmark(HTMLImageElement&, unsigned iterations);
     unsigned pdfDocumentCachingCount(HTMLImageElement&);
     void setLargeImageAsyncDecodingEnabledForTesting(HTMLImageElement&, bool enabled);
     void setForceUpdateImageDataEnabledForTesting(HTMLImageElement&, bool enabled);
@@ -548,6 +556,9 @@ public:
 
     ExceptionOr<void> startTrackingCompositingUpdates();
     ExceptionOr<unsigned> compositingUpdateCount();
+    ExceptionOr<unsigned> compositingRequirementsVisitedLayerCount();
+    ExceptionOr<unsigned> compositingRequirementsRecomputedLayerCount();
+    ExceptionOr<String> overlapMapBenchmark(unsigned iterations);
 
     ExceptionOr<void> startTrackingRenderingUpdates();
     ExceptionOr<unsigned> renderingUpdateCount();
@@ -559,6 +570,19 @@ public:
     void updateLayoutAndStyleForAllFrames();
     ExceptionOr<void> updateLayoutIgnorePendingStylesheetsAndRunPostLayoutTasks(Node*);
     unsigned layoutCount() const;
+    unsigned gridItemLayoutCountDuringTrackSizing() const;
+    unsigned gridIntrinsicLogicalHeightCacheHitCount() const;
+    void resetGridTrackSizingCounters();
+    unsigned flexItemMeasureLayoutCount() const;
+    unsigned flexItemMeasureCacheHitCount() const;
+    void resetFlexItemMeasureCounters();
+    ExceptionOr<String> nestedFlexBenchmark(unsigned iterations);
+#if ENABLE(LAYOUT_FORMATTING_CONTEXT)
+    ExceptionOr<String> layoutFormattingContextBenchmark(unsigned iterations);
+#endif
+    ExceptionOr<String> filterBenchmark(unsigned iterations);
+    String displayListWireFormatBenchmark(unsigned iterations);
+    String displayListWireFormatFuzz(unsigned iterations, unsigned seed);
 
     Ref<ArrayBuffer> serializeObject(const RefPtr<SerializedScriptValue>&) const;
     Ref<SerializedScriptValue> deserializeBuffer(ArrayBuffer&) const;